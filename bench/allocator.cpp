@@ -0,0 +1,204 @@
+// play::Arena、play::Pool、play::ThreadCachingPool 与 new/delete、std::pmr 各内存资源在分配密集负载下的对比基准：
+// - 逐请求创建 n 个小对象（串成链表并遍历），请求结束时全部释放
+// - pmr 容器：std::pmr::list 逐个插入 n 个元素后析构
+// - 随机替换固定数量、大小不一的存活对象（Arena 与 monotonic_buffer_resource 不回收内存，不参与）
+// - 多线程各自分配与释放（仅比较线程安全的实现）
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "allocator.hpp"
+#include "benchmark.hpp"
+
+namespace {
+constexpr size_t k_live = 4096;
+constexpr size_t k_max_size = 256;
+constexpr size_t k_threads = 4;
+
+// 48 字节的链表节点
+struct Node {
+  uint64_t key;
+  uint64_t value[4];
+  Node* next;
+};
+
+// 各实现统一为 allocate/deallocate/reset，以及供 pmr 容器使用的 resource()
+// maxSize 为负载中最大的单次请求，仅 play::Pool 用作块大小
+struct NewDelete {
+  explicit NewDelete(size_t) {}
+
+  void* allocate(size_t bytes) { return ::operator new(bytes); }
+
+  void deallocate(void* p, size_t bytes) { ::operator delete(p, bytes); }
+
+  void reset() {}
+
+  std::pmr::memory_resource* resource() { return std::pmr::new_delete_resource(); }
+};
+
+template <typename R>
+struct Pmr {
+  explicit Pmr(size_t) {}
+
+  void* allocate(size_t bytes) { return m_resource.allocate(bytes); }
+
+  void deallocate(void* p, size_t bytes) { m_resource.deallocate(p, bytes); }
+
+  void reset() {
+    if constexpr (std::is_same_v<R, std::pmr::monotonic_buffer_resource>) m_resource.release();
+  }
+
+  std::pmr::memory_resource* resource() { return &m_resource; }
+
+  R m_resource;
+};
+
+template <typename A>
+struct Play {
+  explicit Play(size_t maxSize)
+    requires std::is_same_v<A, play::Pool>
+      : m_alloc(maxSize) {}
+
+  explicit Play(size_t) {}
+
+  void* allocate(size_t bytes) { return m_alloc.allocate(bytes); }
+
+  void deallocate(void* p, size_t bytes) { m_alloc.deallocate(p, bytes); }
+
+  void reset() {
+    if constexpr (std::is_same_v<A, play::Arena>) m_alloc.reset();
+  }
+
+  std::pmr::memory_resource* resource() { return &m_resource; }
+
+  A m_alloc;
+  play::MemoryResource<A> m_resource{m_alloc};
+};
+
+using PmrMonotonic = Pmr<std::pmr::monotonic_buffer_resource>;
+using PmrUnsyncPool = Pmr<std::pmr::unsynchronized_pool_resource>;
+using PmrSyncPool = Pmr<std::pmr::synchronized_pool_resource>;
+using PlayArena = Play<play::Arena>;
+using PlayPool = Play<play::Pool>;
+using PlayThreadCaching = Play<play::ThreadCachingPool>;
+
+template <typename Impl>
+void BM_objects(benchmark::State& bm) {
+  Impl impl(sizeof(Node));
+  size_t n = bm.range(0);
+  for (auto _ : bm) {
+    Node* head = nullptr;
+    for (size_t i = 0; i < n; ++i) {
+      head = play::construct_at(static_cast<Node*>(impl.allocate(sizeof(Node))), Node{i, {i, i, i, i}, head});
+    }
+    uint64_t sum = 0;
+    for (Node* p = head; p; p = p->next) sum += p->key + p->value[3];
+    benchmark::DoNotOptimize(sum);
+    while (head) {
+      Node* next = head->next;
+      impl.deallocate(head, sizeof(Node));
+      head = next;
+    }
+    impl.reset();
+  }
+  bm.SetItemsProcessed(bm.iterations() * n);
+}
+
+template <typename Impl>
+void BM_pmrList(benchmark::State& bm) {
+  // 链表节点：前后指针加元素
+  Impl impl(2 * sizeof(void*) + sizeof(uint64_t));
+  size_t n = bm.range(0);
+  for (auto _ : bm) {
+    {
+      std::pmr::list<uint64_t> list(impl.resource());
+      for (size_t i = 0; i < n; ++i) list.push_back(i);
+      benchmark::DoNotOptimize(list.back());
+    }
+    impl.reset();
+  }
+  bm.SetItemsProcessed(bm.iterations() * n);
+}
+
+// 每次迭代随机替换 range(0) 个存活对象，大小均匀分布在 [16, 256]
+template <typename Impl>
+void BM_churn(benchmark::State& bm) {
+  Impl impl(k_max_size);
+  std::mt19937 gen(114514);
+  std::uniform_int_distribution<size_t> sizeDist(16, k_max_size), slotDist(0, k_live - 1);
+  std::vector<std::pair<void*, size_t>> live(k_live);
+  for (auto& [p, size] : live) {
+    size = sizeDist(gen);
+    p = impl.allocate(size);
+  }
+  // 预先生成随机序列，避免把随机数生成计入
+  std::vector<std::pair<size_t, size_t>> ops(bm.range(0));
+  for (auto& [slot, size] : ops) {
+    slot = slotDist(gen);
+    size = sizeDist(gen);
+  }
+
+  for (auto _ : bm) {
+    for (auto [slot, size] : ops) {
+      impl.deallocate(live[slot].first, live[slot].second);
+      live[slot] = {impl.allocate(size), size};
+      *static_cast<char*>(live[slot].first) = 0;
+    }
+  }
+  for (auto [p, size] : live) impl.deallocate(p, size);
+  bm.SetItemsProcessed(bm.iterations() * ops.size());
+}
+
+// k_threads 个线程共享同一个实现，各自反复分配一批 64 个节点再全部释放，共 range(0) 次分配
+template <typename Impl>
+void BM_threads(benchmark::State& bm) {
+  Impl impl(sizeof(Node));
+  size_t n = bm.range(0);
+  auto work = [&] {
+    Node* batch[64];
+    for (size_t i = 0; i < n; i += 64) {
+      for (auto& p : batch) p = static_cast<Node*>(impl.allocate(sizeof(Node)));
+      benchmark::ClobberMemory();
+      for (auto p : batch) impl.deallocate(p, sizeof(Node));
+    }
+  };
+  for (auto _ : bm) {
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < k_threads; ++t) threads.emplace_back(work);
+    for (auto& thread : threads) thread.join();
+  }
+  bm.SetItemsProcessed(bm.iterations() * n * k_threads);
+}
+} // namespace
+
+#define BENCHMARK_ALLOCATOR(bm, sizes)          \
+  BENCHMARK_TEMPLATE(bm, NewDelete)->sizes;     \
+  BENCHMARK_TEMPLATE(bm, PmrMonotonic)->sizes;  \
+  BENCHMARK_TEMPLATE(bm, PmrUnsyncPool)->sizes; \
+  BENCHMARK_TEMPLATE(bm, PlayArena)->sizes;     \
+  BENCHMARK_TEMPLATE(bm, PlayPool)->sizes;      \
+  BENCHMARK_TEMPLATE(bm, PlayThreadCaching)->sizes;
+
+#define OBJECT_SIZES RangeMultiplier(16)->Range(1 << 6, 1 << 18)
+
+BENCHMARK_ALLOCATOR(BM_objects, OBJECT_SIZES)
+BENCHMARK_ALLOCATOR(BM_pmrList, OBJECT_SIZES)
+
+#define CHURN_SIZES Arg(1 << 12)->Arg(1 << 16)
+
+BENCHMARK_TEMPLATE(BM_churn, NewDelete)->CHURN_SIZES;
+BENCHMARK_TEMPLATE(BM_churn, PmrUnsyncPool)->CHURN_SIZES;
+BENCHMARK_TEMPLATE(BM_churn, PlayPool)->CHURN_SIZES;
+BENCHMARK_TEMPLATE(BM_churn, PlayThreadCaching)->CHURN_SIZES;
+
+#define THREAD_SIZES Arg(1 << 14)->Arg(1 << 18)->UseRealTime()
+
+BENCHMARK_TEMPLATE(BM_threads, NewDelete)->THREAD_SIZES;
+BENCHMARK_TEMPLATE(BM_threads, PmrSyncPool)->THREAD_SIZES;
+BENCHMARK_TEMPLATE(BM_threads, PlayThreadCaching)->THREAD_SIZES;
+
+BENCHMARK_MAIN();
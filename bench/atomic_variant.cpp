@@ -0,0 +1,125 @@
+// 多个线程共享同一个单元时 play::AtomicVariant 与 mutex + std::variant 的对比：
+// - Small：打包后 8 字节，基于 std::atomic<uint64_t>
+// - Medium：打包后 16 字节，基于 cmpxchg16b（load 同样要写缓存行）
+// - Large：超过 16 字节，退化为顺序锁
+// - Mutex：std::mutex 保护的 std::variant<int64_t, double, Tag>
+// 负载分两种：读为主（每 8 次操作写一次）与 CAS 循环自增
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "std/atomic_variant.hpp"
+
+namespace {
+struct Tag {
+  bool operator==(const Tag&) const = default;
+};
+
+struct Triple {
+  int64_t x, y, z;
+};
+
+template <class V>
+class Locked {
+public:
+  using value_type = V;
+
+  V load() const {
+    std::lock_guard lock(m_mutex);
+    return m_value;
+  }
+
+  void store(const V& value) {
+    std::lock_guard lock(m_mutex);
+    m_value = value;
+  }
+
+  bool compare_exchange_weak(V& expected, const V& desired) {
+    std::lock_guard lock(m_mutex);
+    if (m_value == expected) {
+      m_value = desired;
+      return true;
+    }
+    expected = m_value;
+    return false;
+  }
+
+private:
+  mutable std::mutex m_mutex;
+  V m_value;
+};
+
+using Small = play::AtomicVariant<int32_t, float, Tag>;
+using Medium = play::AtomicVariant<int64_t, double, Tag>;
+using Large = play::AtomicVariant<int64_t, Triple>;
+using Mutex = Locked<std::variant<int64_t, double, Tag>>;
+
+static_assert(Small::is_always_lock_free && Medium::is_always_lock_free && !Large::is_always_lock_free);
+
+// 第 0 个备选类型，两种 Variant 通用
+template <class V>
+struct First;
+
+template <template <class...> class Var, class T, class... Rest>
+struct First<Var<T, Rest...>> {
+  using type = T;
+};
+
+template <class Cell>
+using Counter = typename First<typename Cell::value_type>::type;
+
+constexpr size_t k_per_thread = 1 << 16;
+
+// 启动 range(0) 个线程，各自对同一个单元执行 k_per_thread 次 op(cell, 线程号, 序号)
+template <class Cell, class Op>
+void runThreads(benchmark::State& bm, Op op) {
+  auto threads = static_cast<size_t>(bm.range(0));
+  for (auto _ : bm) {
+    Cell cell;
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&cell, &op, t] {
+        for (size_t i = 0; i < k_per_thread; ++i) op(cell, t, i);
+      });
+    }
+    for (auto& w : workers) w.join();
+    benchmark::DoNotOptimize(cell.load());
+  }
+  bm.SetItemsProcessed(bm.iterations() * threads * k_per_thread);
+}
+
+template <class Cell>
+void BM_readMostly(benchmark::State& bm) {
+  using V = typename Cell::value_type;
+  runThreads<Cell>(bm, [](Cell& cell, size_t t, size_t i) {
+    if ((i & 7) == t % 8) {
+      cell.store(V(static_cast<Counter<Cell>>(i)));
+    } else {
+      benchmark::DoNotOptimize(cell.load());
+    }
+  });
+}
+
+template <class Cell>
+void BM_casIncrement(benchmark::State& bm) {
+  using V = typename Cell::value_type;
+  runThreads<Cell>(bm, [](Cell& cell, size_t, size_t) {
+    V cur = cell.load();
+    while (!cell.compare_exchange_weak(cur, V(static_cast<Counter<Cell>>(get<0>(cur) + 1)))) {}
+  });
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_readMostly, Small)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_readMostly, Medium)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_readMostly, Large)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_readMostly, Mutex)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_casIncrement, Small)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_casIncrement, Medium)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_casIncrement, Large)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_casIncrement, Mutex)->Arg(1)->Arg(4)->UseRealTime();
+
+BENCHMARK_MAIN();
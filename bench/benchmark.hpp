@@ -0,0 +1,907 @@
+#pragma once
+
+// 仓库内置的微基准框架，接口与 Google Benchmark 保持一致（BENCHMARK/State/DoNotOptimize），无需联网拉取依赖
+// 支持的命令行参数：
+//   --benchmark_filter=<regex>            只运行名字匹配的基准，以 - 开头表示排除
+//   --benchmark_min_time=<sec>s|<n>x      每次重复的最短运行时间，或固定迭代次数
+//   --benchmark_min_warmup_time=<sec>     正式计时前的预热时间
+//   --benchmark_repetitions=<n>           重复次数，大于 1 时额外输出 mean/median/stddev/cv
+//   --benchmark_report_aggregates_only    重复多次时只输出统计结果
+//   --benchmark_format=console|json|csv   标准输出格式
+//   --benchmark_out=<file>                同时把结果写入文件
+//   --benchmark_out_format=json|csv       写入文件的格式
+//   --benchmark_cpu=<n>                   把进程绑定到第 n 个 CPU 上运行
+//   --benchmark_perf_counters=<list>      以逗号分隔的硬件计数器（cycles,instructions,l1d_misses,llc_misses,
+//                                         branch_misses,stalled_cycles_frontend,stalled_cycles_backend）或 all，
+//                                         按每次迭代、每个元素（设置了 SetItemsProcessed 时）输出，并给出 IPC
+//   --benchmark_list_tests                只列出基准名字
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "perf_counters.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace benchmark {
+/// @brief 阻止编译器把 value 的计算当作死代码消除
+template <typename T>
+inline void DoNotOptimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static const void* volatile s_sink;
+  s_sink = &value;
+#endif
+}
+
+template <typename T>
+inline void DoNotOptimize(T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*)) {
+    asm volatile("" : "+m,r"(value) : : "memory");
+  } else {
+    asm volatile("" : "+m"(value) : : "memory");
+  }
+#else
+  static void* volatile s_sink;
+  s_sink = &value;
+#endif
+}
+
+/// @brief 强制把所有挂起的写入落到内存
+inline void ClobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : : "memory");
+#else
+  std::atomic_signal_fence(std::memory_order_acq_rel);
+#endif
+}
+
+enum TimeUnit { kNanosecond, kMicrosecond, kMillisecond, kSecond };
+
+namespace _harness_detail {
+inline double realNow() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 进程 CPU 时间
+inline double cpuNow() {
+#if defined(CLOCK_PROCESS_CPUTIME_ID)
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+#else
+  return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+class Runner;
+} // namespace _harness_detail
+
+class State {
+public:
+  // 带 [[maybe_unused]] 的类类型，避免 for (auto _ : state) 产生未使用变量的警告
+  struct [[maybe_unused]] Value {};
+
+  class Iterator {
+  public:
+    Iterator() = default;
+    explicit Iterator(State* state)
+        : m_state(state), m_remaining(state->m_error.empty() ? state->m_maxIterations : 0) {}
+
+    Value operator*() const { return {}; }
+
+    Iterator& operator++() {
+      --m_remaining;
+      return *this;
+    }
+
+    bool operator!=(Iterator const&) const {
+      if (m_remaining != 0) [[likely]] return true;
+      m_state->finishKeepRunning();
+      return false;
+    }
+
+  private:
+    State* m_state = nullptr;
+    int64_t m_remaining = 0;
+  };
+
+  State(int64_t max_iterations, std::vector<int64_t> args, _harness_detail::PerfCounters const* perf = nullptr)
+      : m_maxIterations(max_iterations), m_args(std::move(args)), m_perf(perf) {
+    if (m_perf) m_perfTotal.assign(m_perf->size(), 0);
+  }
+
+  Iterator begin() {
+    startKeepRunning();
+    return Iterator(this);
+  }
+
+  Iterator end() { return {}; }
+
+  /// @brief 暂停计时，用于排除每轮迭代中的准备工作
+  void PauseTiming() {
+    m_realTime += _harness_detail::realNow() - m_realStart;
+    m_cpuTime += _harness_detail::cpuNow() - m_cpuStart;
+    if (m_perf) {
+      m_perf->read(m_perfNow);
+      for (size_t i = 0; i < m_perfTotal.size(); ++i) {
+        m_perfTotal[i] += _harness_detail::PerfCounters::delta(m_perfStart[i], m_perfNow[i]);
+      }
+    }
+  }
+
+  void ResumeTiming() {
+    if (m_perf) m_perf->read(m_perfStart);
+    m_cpuStart = _harness_detail::cpuNow();
+    m_realStart = _harness_detail::realNow();
+  }
+
+  /// @brief 标记本次运行失败，调用后应立即 break 出迭代循环
+  void SkipWithError(std::string_view message) { m_error = message; }
+
+  int64_t range(size_t i = 0) const { return m_args.at(i); }
+
+  int64_t iterations() const { return m_finished ? m_maxIterations : 0; }
+
+  int64_t max_iterations() const { return m_maxIterations; }
+
+  void SetItemsProcessed(int64_t items) { m_items = items; }
+
+  void SetBytesProcessed(int64_t bytes) { m_bytes = bytes; }
+
+  void SetLabel(std::string_view label) { m_label = label; }
+
+  // 用户自定义计数器，按原值输出
+  std::map<std::string, double> counters;
+
+private:
+  friend class _harness_detail::Runner;
+
+  void startKeepRunning() {
+    m_started = true;
+    ResumeTiming();
+  }
+
+  void finishKeepRunning() {
+    PauseTiming();
+    m_finished = true;
+  }
+
+  int64_t m_maxIterations;
+  std::vector<int64_t> m_args;
+  double m_realStart = 0, m_cpuStart = 0;
+  double m_realTime = 0, m_cpuTime = 0;
+  int64_t m_items = 0, m_bytes = 0;
+  bool m_started = false, m_finished = false;
+  std::string m_label, m_error;
+  // 计时区间内累计的硬件计数器
+  _harness_detail::PerfCounters const* m_perf;
+  std::vector<_harness_detail::PerfReading> m_perfStart, m_perfNow;
+  std::vector<double> m_perfTotal;
+};
+
+class Benchmark {
+public:
+  using Function = void (*)(State&);
+
+  Benchmark(std::string name, Function fn) : m_name(std::move(name)), m_fn(fn) {}
+
+  Benchmark* Arg(int64_t x) { return Args({x}); }
+
+  Benchmark* Args(std::vector<int64_t> args) {
+    m_args.push_back(std::move(args));
+    return this;
+  }
+
+  /// @brief 以 RangeMultiplier 为倍率在 [lo, hi] 中取值
+  Benchmark* Range(int64_t lo, int64_t hi) {
+    Arg(lo);
+    for (int64_t x = 1; x < hi; x *= m_multiplier) {
+      if (x > lo) Arg(x);
+    }
+    if (hi != lo) Arg(hi);
+    return this;
+  }
+
+  // 倍率小于 2 时 Range 的取值不会增长；注册发生在静态初始化期间，与 Google Benchmark 一样直接报错退出
+  Benchmark* RangeMultiplier(int multiplier) {
+    if (multiplier < 2) {
+      std::fprintf(stderr, "%s: RangeMultiplier must be at least 2, got %d\n", m_name.c_str(), multiplier);
+      std::abort();
+    }
+    m_multiplier = multiplier;
+    return this;
+  }
+
+  Benchmark* DenseRange(int64_t lo, int64_t hi, int64_t step = 1) {
+    for (int64_t x = lo; x <= hi; x += step) Arg(x);
+    return this;
+  }
+
+  Benchmark* ArgName(std::string name) { return ArgNames({std::move(name)}); }
+
+  Benchmark* ArgNames(std::vector<std::string> names) {
+    m_argNames = std::move(names);
+    return this;
+  }
+
+  Benchmark* Unit(TimeUnit unit) {
+    m_unit = unit;
+    return this;
+  }
+
+  Benchmark* MinTime(double seconds) {
+    m_minTime = seconds;
+    return this;
+  }
+
+  Benchmark* MinWarmUpTime(double seconds) {
+    m_warmUpTime = seconds;
+    return this;
+  }
+
+  Benchmark* Iterations(int64_t n) {
+    m_iterations = n;
+    return this;
+  }
+
+  Benchmark* Repetitions(int n) {
+    m_repetitions = n;
+    return this;
+  }
+
+  /// @brief 以墙上时间（而非进程 CPU 时间）决定迭代次数与吞吐率，多线程基准应当使用
+  Benchmark* UseRealTime() {
+    m_useRealTime = true;
+    return this;
+  }
+
+private:
+  friend class _harness_detail::Runner;
+
+  std::string m_name;
+  Function m_fn;
+  std::vector<std::vector<int64_t>> m_args;
+  std::vector<std::string> m_argNames;
+  int m_multiplier = 8;
+  TimeUnit m_unit = kNanosecond;
+  double m_minTime = -1, m_warmUpTime = -1;
+  int64_t m_iterations = 0;
+  int m_repetitions = 0;
+  bool m_useRealTime = false;
+};
+
+namespace _harness_detail {
+inline std::vector<std::unique_ptr<Benchmark>>& registry() {
+  static std::vector<std::unique_ptr<Benchmark>> s_registry;
+  return s_registry;
+}
+} // namespace _harness_detail
+
+inline Benchmark* RegisterBenchmark(std::string name, Benchmark::Function fn) {
+  auto& registry = _harness_detail::registry();
+  registry.push_back(std::make_unique<Benchmark>(std::move(name), fn));
+  return registry.back().get();
+}
+
+namespace _harness_detail {
+constexpr int64_t k_max_iterations = 1'000'000'000;
+
+struct Options {
+  std::string filter = ".";
+  double min_time = 0.5;
+  int64_t fixed_iterations = 0;
+  double warm_up_time = 0.1;
+  int repetitions = 1;
+  bool aggregates_only = false;
+  std::string format = "console";
+  std::string out;
+  std::string out_format = "json";
+  int cpu = -1;
+  std::vector<std::string> perf_counters;
+  bool list = false;
+};
+
+// 一次运行（或一组重复的统计结果）对应的一行报告
+struct Row {
+  std::string name;
+  std::string run_name;
+  std::string aggregate_name;
+  int repetitions = 1;
+  int repetition_index = 0;
+  int64_t iterations = 0;
+  double real_time = 0; // 单次迭代耗时，单位为 unit
+  double cpu_time = 0;
+  TimeUnit unit = kNanosecond;
+  std::map<std::string, double> counters;
+  std::string label;
+  std::string error;
+};
+
+inline const char* unitName(TimeUnit unit) {
+  constexpr const char* names[] = {"ns", "us", "ms", "s"};
+  return names[unit];
+}
+
+inline double unitMultiplier(TimeUnit unit) {
+  constexpr double multipliers[] = {1e9, 1e6, 1e3, 1};
+  return multipliers[unit];
+}
+
+inline std::string humanReadable(double value, bool binary) {
+  constexpr const char* prefixes[] = {"", "k", "M", "G", "T", "P"};
+  const double base = binary ? 1024 : 1000;
+  size_t i = 0;
+  while (std::abs(value) >= base && i + 1 < std::size(prefixes)) {
+    value /= base;
+    ++i;
+  }
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.4g%s%s", value, prefixes[i], binary && i > 0 ? "i" : "");
+  return buf;
+}
+
+inline std::string jsonEscape(std::string_view s) {
+  std::string res;
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      res += '\\';
+      res += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+      res += buf;
+    } else {
+      res += c;
+    }
+  }
+  return res;
+}
+
+inline std::string csvEscape(std::string_view s) {
+  std::string res = "\"";
+  for (char c : s) {
+    if (c == '"') res += '"';
+    res += c;
+  }
+  return res + '"';
+}
+
+inline std::string formatNumber(double value) {
+  if (!std::isfinite(value)) return "0";
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.10g", value);
+  return buf;
+}
+
+inline bool pinToCpu(int cpu) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+class Runner {
+public:
+  explicit Runner(Options options) : m_options(std::move(options)) {}
+
+  int run(const char* executable) {
+    auto instances = collect();
+    if (m_options.list) {
+      for (auto const& instance : instances) std::cout << instance.name << '\n';
+      return 0;
+    }
+
+    bool pinned = m_options.cpu >= 0 && pinToCpu(m_options.cpu);
+    if (m_options.cpu >= 0 && !pinned) std::cerr << "warning: failed to pin to CPU " << m_options.cpu << '\n';
+    if (!m_options.perf_counters.empty()) openPerfCounters();
+    m_context = {executable, pinned};
+
+    bool console = m_options.format == "console";
+    if (console) {
+      size_t width = 10;
+      for (auto const& instance : instances) width = std::max(width, instance.name.size() + 7);
+      m_nameWidth = width;
+      printHeader();
+    }
+
+    std::vector<Row> rows;
+    for (auto const& instance : instances) {
+      for (auto& row : runInstance(instance)) {
+        if (console) printRow(row);
+        rows.push_back(std::move(row));
+      }
+    }
+
+    if (m_options.format == "json") writeJson(std::cout, rows);
+    if (m_options.format == "csv") writeCsv(std::cout, rows);
+    if (!m_options.out.empty()) {
+      std::ofstream out(m_options.out);
+      if (!out) {
+        std::cerr << "error: cannot open " << m_options.out << '\n';
+        return 1;
+      }
+      if (m_options.out_format == "csv") {
+        writeCsv(out, rows);
+      } else {
+        writeJson(out, rows);
+      }
+    }
+    return 0;
+  }
+
+private:
+  struct Instance {
+    std::string name;
+    Benchmark* benchmark;
+    std::vector<int64_t> args;
+  };
+
+  struct Context {
+    std::string executable;
+    bool pinned = false;
+  };
+
+  // 计数器不可用时只给出警告，基准照常计时
+  void openPerfCounters() {
+    auto unavailable = m_perf.open(m_options.perf_counters);
+    if (unavailable.empty()) return;
+    std::cerr << "warning: performance counters unavailable:";
+    for (auto const& name : unavailable) std::cerr << ' ' << name;
+    if (m_perf.empty()) std::cerr << " (reporting time only)";
+    std::cerr << '\n';
+  }
+
+  // 单次运行的原始数据
+  struct Measurement {
+    int64_t iterations = 0;
+    double real_time = 0, cpu_time = 0;
+    int64_t items = 0, bytes = 0;
+    std::map<std::string, double> counters;
+    std::vector<double> perf;
+    std::string label, error;
+  };
+
+  std::vector<Instance> collect() const {
+    std::string pattern = m_options.filter;
+    bool negative = !pattern.empty() && pattern[0] == '-';
+    if (negative) pattern.erase(0, 1);
+    if (pattern == "all") pattern = ".";
+    std::regex re(pattern);
+
+    std::vector<Instance> res;
+    for (auto const& benchmark : registry()) {
+      auto arg_lists = benchmark->m_args;
+      if (arg_lists.empty()) arg_lists.emplace_back();
+      for (auto& args : arg_lists) {
+        std::string name = benchmark->m_name;
+        for (size_t i = 0; i < args.size(); ++i) {
+          name += '/';
+          if (i < benchmark->m_argNames.size() && !benchmark->m_argNames[i].empty()) {
+            name += benchmark->m_argNames[i] + ':';
+          }
+          name += std::to_string(args[i]);
+        }
+        if (std::regex_search(name, re) != negative) res.push_back({std::move(name), benchmark.get(), args});
+      }
+    }
+    return res;
+  }
+
+  Measurement measure(Instance const& instance, int64_t iterations) const {
+    State state(iterations, instance.args, m_perf.empty() ? nullptr : &m_perf);
+    instance.benchmark->m_fn(state);
+
+    Measurement res;
+    res.iterations = iterations;
+    res.real_time = state.m_realTime;
+    res.cpu_time = state.m_cpuTime;
+    res.items = state.m_items;
+    res.bytes = state.m_bytes;
+    res.counters = std::move(state.counters);
+    res.perf = std::move(state.m_perfTotal);
+    res.label = std::move(state.m_label);
+    res.error = std::move(state.m_error);
+    if (res.error.empty() && !(state.m_started && state.m_finished)) {
+      res.error = "benchmark did not run the State loop to completion";
+    }
+    return res;
+  }
+
+  double timeOf(Instance const& instance, Measurement const& m) const {
+    return instance.benchmark->m_useRealTime ? m.real_time : m.cpu_time;
+  }
+
+  // 与 Google Benchmark 相同的迭代次数增长策略：耗时显著时按比例外推并留 40% 余量，否则乘以 10
+  static int64_t nextIterations(int64_t iterations, double elapsed, double target) {
+    double multiplier = target * 1.4 / std::max(elapsed, 1e-9);
+    if (elapsed / target <= 0.1) multiplier = 10.0;
+    auto next = static_cast<int64_t>(static_cast<double>(iterations) * multiplier);
+    return std::min(std::max(next, iterations + 1), k_max_iterations);
+  }
+
+  std::vector<Row> runInstance(Instance const& instance) const {
+    Benchmark const& benchmark = *instance.benchmark;
+    double min_time = benchmark.m_minTime >= 0 ? benchmark.m_minTime : m_options.min_time;
+    double warm_up_time = benchmark.m_warmUpTime >= 0 ? benchmark.m_warmUpTime : m_options.warm_up_time;
+    int64_t fixed = benchmark.m_iterations > 0 ? benchmark.m_iterations : m_options.fixed_iterations;
+    int repetitions = benchmark.m_repetitions > 0 ? benchmark.m_repetitions : m_options.repetitions;
+
+    int64_t iterations = fixed > 0 ? fixed : 1;
+    // 预热：结果丢弃，同时为校准提供起始迭代次数
+    for (double spent = 0; spent < warm_up_time;) {
+      auto m = measure(instance, iterations);
+      if (!m.error.empty()) return {makeRow(instance, m, 1, 0)};
+      spent += m.real_time;
+      if (fixed == 0) iterations = nextIterations(iterations, timeOf(instance, m), warm_up_time);
+    }
+
+    std::vector<Measurement> measurements;
+    // 校准：迭代次数增长到单次运行耗时不少于 min_time 为止，最后一次运行即为第一次重复
+    while (true) {
+      auto m = measure(instance, iterations);
+      if (!m.error.empty()) return {makeRow(instance, m, 1, 0)};
+      if (fixed > 0 || timeOf(instance, m) >= min_time || iterations >= k_max_iterations) {
+        measurements.push_back(std::move(m));
+        break;
+      }
+      iterations = nextIterations(iterations, timeOf(instance, m), min_time);
+    }
+    while (static_cast<int>(measurements.size()) < repetitions) {
+      measurements.push_back(measure(instance, iterations));
+    }
+
+    std::vector<Row> rows;
+    for (size_t i = 0; i < measurements.size(); ++i) {
+      rows.push_back(makeRow(instance, measurements[i], repetitions, static_cast<int>(i)));
+    }
+    if (repetitions > 1) {
+      auto aggregates = aggregate(rows);
+      if (m_options.aggregates_only) rows.clear();
+      rows.insert(rows.end(), aggregates.begin(), aggregates.end());
+    }
+    return rows;
+  }
+
+  Row makeRow(Instance const& instance, Measurement const& m, int repetitions, int index) const {
+    Benchmark const& benchmark = *instance.benchmark;
+    Row row;
+    row.name = row.run_name = instance.name;
+    row.repetitions = repetitions;
+    row.repetition_index = index;
+    row.iterations = m.iterations;
+    row.unit = benchmark.m_unit;
+    row.label = m.label;
+    row.error = m.error;
+    if (!m.error.empty()) return row;
+
+    double iterations = static_cast<double>(m.iterations);
+    row.real_time = m.real_time / iterations * unitMultiplier(row.unit);
+    row.cpu_time = m.cpu_time / iterations * unitMultiplier(row.unit);
+    double seconds = timeOf(instance, m);
+    if (m.items > 0) row.counters["items_per_second"] = static_cast<double>(m.items) / seconds;
+    if (m.bytes > 0) row.counters["bytes_per_second"] = static_cast<double>(m.bytes) / seconds;
+    for (auto const& [name, value] : m.counters) row.counters[name] = value;
+
+    double cycles = 0, instructions = 0;
+    for (size_t i = 0; i < m.perf.size(); ++i) {
+      std::string const& name = m_perf.names()[i];
+      row.counters[name] = m.perf[i] / iterations;
+      if (m.items > 0) row.counters[name + "/item"] = m.perf[i] / static_cast<double>(m.items);
+      if (name == "cycles") cycles = m.perf[i];
+      if (name == "instructions") instructions = m.perf[i];
+    }
+    if (cycles > 0 && instructions > 0) row.counters["IPC"] = instructions / cycles;
+    return row;
+  }
+
+  static std::vector<Row> aggregate(std::vector<Row> const& rows) {
+    auto stats = [&](auto&& get) {
+      std::vector<double> values;
+      for (auto const& row : rows) values.push_back(get(row));
+      double n = static_cast<double>(values.size());
+      double mean = 0;
+      for (double v : values) mean += v / n;
+      double var = 0;
+      for (double v : values) var += (v - mean) * (v - mean) / (n - 1);
+      double stddev = std::sqrt(var);
+      std::sort(values.begin(), values.end());
+      size_t mid = values.size() / 2;
+      double median = values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+      return std::map<std::string, double>{
+          {"mean", mean}, {"median", median}, {"stddev", stddev}, {"cv", mean != 0 ? stddev / mean : 0}};
+    };
+
+    auto real = stats([](Row const& r) { return r.real_time; });
+    auto cpu = stats([](Row const& r) { return r.cpu_time; });
+    std::map<std::string, std::map<std::string, double>> counters;
+    for (auto const& [name, value] : rows.front().counters) {
+      counters[name] = stats([&](Row const& r) {
+        auto it = r.counters.find(name);
+        return it == r.counters.end() ? 0.0 : it->second;
+      });
+    }
+
+    std::vector<Row> res;
+    for (const char* kind : {"mean", "median", "stddev", "cv"}) {
+      Row row = rows.front();
+      row.name = row.run_name + "_" + kind;
+      row.aggregate_name = kind;
+      row.iterations = static_cast<int64_t>(rows.size());
+      row.real_time = real[kind];
+      row.cpu_time = cpu[kind];
+      for (auto& [name, value] : row.counters) value = counters[name][kind];
+      res.push_back(std::move(row));
+    }
+    return res;
+  }
+
+  static std::string dateString() {
+    std::time_t now = std::time(nullptr);
+    char buf[64];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+    return buf;
+  }
+
+  void printHeader() const {
+    std::cout << dateString() << "\nRunning " << m_context.executable << "\nRun on ("
+              << std::thread::hardware_concurrency() << " X CPU s)";
+    if (m_context.pinned) std::cout << ", pinned to CPU " << m_options.cpu;
+    std::cout << '\n';
+    std::string line(m_nameWidth + 61, '-');
+    char buf[256];
+    std::snprintf(buf, sizeof(buf), "%-*s %15s %15s %12s %s", static_cast<int>(m_nameWidth), "Benchmark", "Time", "CPU",
+                  "Iterations", "UserCounters...");
+    std::cout << line << '\n' << buf << '\n' << line << std::endl;
+  }
+
+  static std::string formatTime(double t) {
+    char buf[32];
+    const char* fmt = t < 1 ? "%12.3f" : t < 10 ? "%12.2f" : t < 100 ? "%12.1f" : "%12.0f";
+    std::snprintf(buf, sizeof(buf), fmt, t);
+    return buf;
+  }
+
+  void printRow(Row const& row) const {
+    char buf[256];
+    if (!row.error.empty()) {
+      std::snprintf(buf, sizeof(buf), "%-*s ERROR: ", static_cast<int>(m_nameWidth), row.name.c_str());
+      std::cout << buf << row.error << std::endl;
+      return;
+    }
+    bool cv = row.aggregate_name == "cv";
+    auto time = [&](double t) {
+      if (cv) {
+        std::snprintf(buf, sizeof(buf), "%13.2f %%", t * 100);
+        return std::string(buf);
+      }
+      return formatTime(t) + " " + std::string(unitName(row.unit)) + (row.unit == kSecond ? " " : "");
+    };
+    std::string real = time(row.real_time), cpu = time(row.cpu_time);
+    std::snprintf(buf, sizeof(buf), "%-*s %s %s %12lld", static_cast<int>(m_nameWidth), row.name.c_str(), real.c_str(),
+                  cpu.c_str(), static_cast<long long>(row.iterations));
+    std::cout << buf;
+    for (auto const& [name, value] : row.counters) {
+      std::cout << ' ' << name << '=';
+      if (cv) {
+        std::snprintf(buf, sizeof(buf), "%.2f%%", value * 100);
+        std::cout << buf;
+      } else if (name == "bytes_per_second") {
+        std::cout << humanReadable(value, true) << "B/s";
+      } else if (name == "items_per_second") {
+        std::cout << humanReadable(value, false) << "/s";
+      } else {
+        std::cout << humanReadable(value, false);
+      }
+    }
+    if (!row.label.empty()) std::cout << ' ' << row.label;
+    std::cout << std::endl;
+  }
+
+  void writeJson(std::ostream& os, std::vector<Row> const& rows) const {
+    os << "{\n  \"context\": {\n"
+       << "    \"date\": \"" << dateString() << "\",\n"
+       << "    \"executable\": \"" << jsonEscape(m_context.executable) << "\",\n"
+       << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+       << "    \"pinned_cpu\": " << (m_context.pinned ? m_options.cpu : -1) << ",\n"
+#ifdef NDEBUG
+       << "    \"library_build_type\": \"release\"\n"
+#else
+       << "    \"library_build_type\": \"debug\"\n"
+#endif
+       << "  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < rows.size(); ++i) {
+      Row const& row = rows[i];
+      os << (i ? ",\n" : "\n") << "    {\n"
+         << "      \"name\": \"" << jsonEscape(row.name) << "\",\n"
+         << "      \"run_name\": \"" << jsonEscape(row.run_name) << "\",\n"
+         << "      \"run_type\": \"" << (row.aggregate_name.empty() ? "iteration" : "aggregate") << "\",\n"
+         << "      \"repetitions\": " << row.repetitions << ",\n";
+      if (row.aggregate_name.empty()) {
+        os << "      \"repetition_index\": " << row.repetition_index << ",\n";
+      } else {
+        os << "      \"aggregate_name\": \"" << row.aggregate_name << "\",\n";
+      }
+      if (!row.error.empty()) {
+        os << "      \"error_occurred\": true,\n"
+           << "      \"error_message\": \"" << jsonEscape(row.error) << "\"\n    }";
+        continue;
+      }
+      os << "      \"iterations\": " << row.iterations << ",\n"
+         << "      \"real_time\": " << formatNumber(row.real_time) << ",\n"
+         << "      \"cpu_time\": " << formatNumber(row.cpu_time) << ",\n"
+         << "      \"time_unit\": \"" << unitName(row.unit) << "\"";
+      for (auto const& [name, value] : row.counters) {
+        os << ",\n      \"" << jsonEscape(name) << "\": " << formatNumber(value);
+      }
+      if (!row.label.empty()) os << ",\n      \"label\": \"" << jsonEscape(row.label) << "\"";
+      os << "\n    }";
+    }
+    os << "\n  ]\n}\n";
+  }
+
+  static void writeCsv(std::ostream& os, std::vector<Row> const& rows) {
+    std::vector<std::string> extra;
+    for (auto const& row : rows) {
+      for (auto const& [name, value] : row.counters) {
+        if (name != "items_per_second" && name != "bytes_per_second" &&
+            std::find(extra.begin(), extra.end(), name) == extra.end()) {
+          extra.push_back(name);
+        }
+      }
+    }
+    os << "name,iterations,real_time,cpu_time,time_unit,bytes_per_second,items_per_second,label,error_occurred,"
+          "error_message";
+    for (auto const& name : extra) os << ',' << csvEscape(name);
+    os << '\n';
+
+    auto counter = [](Row const& row, std::string const& name) {
+      auto it = row.counters.find(name);
+      return it == row.counters.end() ? std::string() : formatNumber(it->second);
+    };
+    for (auto const& row : rows) {
+      os << csvEscape(row.name) << ',';
+      if (row.error.empty()) {
+        os << row.iterations << ',' << formatNumber(row.real_time) << ',' << formatNumber(row.cpu_time) << ','
+           << unitName(row.unit) << ',' << counter(row, "bytes_per_second") << ','
+           << counter(row, "items_per_second") << ',' << csvEscape(row.label) << ",,";
+      } else {
+        os << ",,,,,," << csvEscape(row.label) << ",true," << csvEscape(row.error);
+      }
+      for (auto const& name : extra) os << ',' << counter(row, name);
+      os << '\n';
+    }
+  }
+
+  Options m_options;
+  Context m_context;
+  PerfCounters m_perf;
+  size_t m_nameWidth = 10;
+};
+
+// 解析 --name=value 形式的参数，value 缺省时视为 "true"
+inline bool parseFlag(std::string_view arg, std::string_view name, std::string& value) {
+  if (arg.substr(0, 2) != "--" || arg.substr(2, name.size()) != name) return false;
+  arg.remove_prefix(2 + name.size());
+  if (arg.empty()) {
+    value = "true";
+    return true;
+  }
+  if (arg[0] != '=') return false;
+  value = arg.substr(1);
+  return true;
+}
+
+inline bool parseBool(std::string const& value) { return value == "true" || value == "1" || value == "yes"; }
+
+inline bool parseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    std::string value;
+    try {
+      if (parseFlag(arg, "benchmark_filter", value)) {
+        options.filter = value;
+      } else if (parseFlag(arg, "benchmark_min_time", value)) {
+        if (!value.empty() && value.back() == 'x') {
+          options.fixed_iterations = std::stoll(value);
+        } else {
+          options.min_time = std::stod(value);
+        }
+      } else if (parseFlag(arg, "benchmark_min_warmup_time", value)) {
+        options.warm_up_time = std::stod(value);
+      } else if (parseFlag(arg, "benchmark_repetitions", value)) {
+        options.repetitions = std::max(1, std::stoi(value));
+      } else if (parseFlag(arg, "benchmark_report_aggregates_only", value)) {
+        options.aggregates_only = parseBool(value);
+      } else if (parseFlag(arg, "benchmark_format", value)) {
+        options.format = value;
+      } else if (parseFlag(arg, "benchmark_out_format", value)) {
+        options.out_format = value;
+      } else if (parseFlag(arg, "benchmark_out", value)) {
+        options.out = value;
+      } else if (parseFlag(arg, "benchmark_cpu", value)) {
+        options.cpu = std::stoi(value);
+      } else if (parseFlag(arg, "benchmark_perf_counters", value)) {
+        if (value == "true") value = "all";
+        std::stringstream ss(value);
+        for (std::string name; std::getline(ss, name, ',');) {
+          if (!name.empty()) options.perf_counters.push_back(name);
+        }
+      } else if (parseFlag(arg, "benchmark_list_tests", value)) {
+        options.list = parseBool(value);
+      } else {
+        std::cerr << "error: unrecognized argument " << arg << '\n';
+        return false;
+      }
+    } catch (std::exception const&) {
+      std::cerr << "error: invalid value in " << arg << '\n';
+      return false;
+    }
+  }
+  for (auto const& format : {options.format, options.out_format}) {
+    if (format != "console" && format != "json" && format != "csv") {
+      std::cerr << "error: unknown format " << format << '\n';
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace _harness_detail
+
+/// @brief 解析命令行参数并运行所有已注册且匹配过滤条件的基准
+inline int RunMain(int argc, char** argv) {
+  _harness_detail::Options options;
+  if (!_harness_detail::parseOptions(argc, argv, options)) return 1;
+  try {
+    return _harness_detail::Runner(std::move(options)).run(argc > 0 ? argv[0] : "benchmark");
+  } catch (std::regex_error const& e) {
+    std::cerr << "error: invalid --benchmark_filter: " << e.what() << '\n';
+    return 1;
+  }
+}
+} // namespace benchmark
+
+#define BENCHMARK_PRIVATE_CONCAT2(a, b) a##b
+#define BENCHMARK_PRIVATE_CONCAT(a, b) BENCHMARK_PRIVATE_CONCAT2(a, b)
+#define BENCHMARK_PRIVATE_NAME() BENCHMARK_PRIVATE_CONCAT(benchmark_registration_, __COUNTER__)
+
+#define BENCHMARK(...)                                                       \
+  [[maybe_unused]] static ::benchmark::Benchmark* BENCHMARK_PRIVATE_NAME() = \
+      ::benchmark::RegisterBenchmark(#__VA_ARGS__, __VA_ARGS__)
+
+#define BENCHMARK_TEMPLATE(f, ...)                                           \
+  [[maybe_unused]] static ::benchmark::Benchmark* BENCHMARK_PRIVATE_NAME() = \
+      ::benchmark::RegisterBenchmark(#f "<" #__VA_ARGS__ ">", f<__VA_ARGS__>)
+
+#define BENCHMARK_MAIN()                                                       \
+  int main(int argc, char** argv) { return ::benchmark::RunMain(argc, argv); } \
+  int main(int, char**)
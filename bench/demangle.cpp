@@ -0,0 +1,62 @@
+// play::demangle 的开销：每次调用 abi::__cxa_demangle、按 type_info 查无锁缓存、按模板参数缓存，以及编译期的 typeName
+#include <map>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "demangle.hpp"
+
+namespace {
+using Type = std::map<std::string, std::vector<int>>;
+
+void BM_demangleAbiToken(benchmark::State& bm) {
+  for (auto _ : bm) {
+    auto name = play::demangleAbiToken(typeid(Type).name());
+    benchmark::DoNotOptimize(name);
+  }
+}
+
+void BM_demangleTypeInfo(benchmark::State& bm) {
+  for (auto _ : bm) {
+    auto name = play::demangle(typeid(Type));
+    benchmark::DoNotOptimize(name);
+  }
+}
+
+// 多个类型轮流查询，缓存中不止一项
+template <int I>
+struct Alt {};
+
+void BM_demangleTypeInfoMixed(benchmark::State& bm) {
+  const std::type_info* types[] = {&typeid(Alt<0>), &typeid(Alt<1>), &typeid(Alt<2>), &typeid(Alt<3>),
+                                   &typeid(Alt<4>), &typeid(Alt<5>), &typeid(Alt<6>), &typeid(Alt<7>)};
+  size_t i = 0;
+  for (auto _ : bm) {
+    auto name = play::demangle(*types[i++ & 7]);
+    benchmark::DoNotOptimize(name);
+  }
+}
+
+void BM_demangleTemplate(benchmark::State& bm) {
+  for (auto _ : bm) {
+    const auto& name = play::demangle<const Type&>();
+    benchmark::DoNotOptimize(name);
+  }
+}
+
+void BM_typeName(benchmark::State& bm) {
+  for (auto _ : bm) {
+    auto name = play::typeName<const Type&>();
+    benchmark::DoNotOptimize(name);
+  }
+}
+} // namespace
+
+BENCHMARK(BM_demangleAbiToken);
+BENCHMARK(BM_demangleTypeInfo);
+BENCHMARK(BM_demangleTypeInfoMixed);
+BENCHMARK(BM_demangleTemplate);
+BENCHMARK(BM_typeName);
+
+BENCHMARK_MAIN();
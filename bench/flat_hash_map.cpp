@@ -0,0 +1,123 @@
+// play::FlatHashMap 与 std::unordered_map 的对比：插入（不预留容量）、命中/未命中的查找、遍历
+// 键值类型取自 print_demo.cpp 中实际使用的 std::unordered_map<std::string, std::variant<int, double>>，
+// 另以 uint64_t 为键对照哈希与比较都很廉价的情形；元素个数由参数给出
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "flat_hash_map.hpp"
+
+namespace {
+using Value = std::variant<int, double>;
+
+using StdStr = std::unordered_map<std::string, Value>;
+using FlatStr = play::FlatHashMap<std::string, Value>;
+using StdInt = std::unordered_map<uint64_t, Value>;
+using FlatInt = play::FlatHashMap<uint64_t, Value>;
+
+template <typename K>
+K makeKey(uint64_t i) {
+  if constexpr (std::is_same_v<K, std::string>) {
+    return "key" + std::to_string(i);
+  } else {
+    return i * 0x9e3779b97f4a7c15ull;
+  }
+}
+
+// 前 count 个用于插入（随机顺序），后 count 个保证不在表中
+template <typename K>
+std::vector<K> makeKeys(size_t count) {
+  std::vector<K> res;
+  for (uint64_t i = 0; i < 2 * count; ++i) res.push_back(makeKey<K>(i));
+  std::shuffle(res.begin(), res.begin() + static_cast<std::ptrdiff_t>(count), std::mt19937_64(114514));
+  return res;
+}
+
+template <typename Map>
+Map makeMap(const std::vector<typename Map::key_type>& keys, size_t count) {
+  Map map;
+  for (size_t i = 0; i < count; ++i) {
+    if (i % 2) {
+      map.emplace(keys[i], static_cast<int>(i));
+    } else {
+      map.emplace(keys[i], static_cast<double>(i));
+    }
+  }
+  return map;
+}
+
+template <typename Map>
+void BM_insert(benchmark::State& bm) {
+  auto count = static_cast<size_t>(bm.range(0));
+  const auto keys = makeKeys<typename Map::key_type>(count);
+  for (auto _ : bm) {
+    Map map = makeMap<Map>(keys, count);
+    benchmark::DoNotOptimize(map);
+  }
+  bm.SetItemsProcessed(bm.iterations() * static_cast<int64_t>(count));
+}
+
+// 命中时查找 [0, count)，未命中时查找 [count, 2 * count)；查找顺序另行打乱，
+// 否则 std::unordered_map 的节点恰好按分配顺序被依次访问
+template <typename Map, bool hit>
+void BM_lookup(benchmark::State& bm) {
+  auto count = static_cast<size_t>(bm.range(0));
+  const auto keys = makeKeys<typename Map::key_type>(count);
+  const Map map = makeMap<Map>(keys, count);
+  auto queries = hit ? std::vector(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(count))
+                     : std::vector(keys.begin() + static_cast<std::ptrdiff_t>(count), keys.end());
+  std::shuffle(queries.begin(), queries.end(), std::mt19937_64(1919810));
+  for (auto _ : bm) {
+    size_t found = 0;
+    for (auto const& key : queries) found += map.find(key) != map.end();
+    benchmark::DoNotOptimize(found);
+  }
+  bm.SetItemsProcessed(bm.iterations() * static_cast<int64_t>(count));
+}
+
+template <typename Map>
+void BM_lookupHit(benchmark::State& bm) {
+  BM_lookup<Map, true>(bm);
+}
+
+template <typename Map>
+void BM_lookupMiss(benchmark::State& bm) {
+  BM_lookup<Map, false>(bm);
+}
+
+template <typename Map>
+void BM_iterate(benchmark::State& bm) {
+  auto count = static_cast<size_t>(bm.range(0));
+  const Map map = makeMap<Map>(makeKeys<typename Map::key_type>(count), count);
+  for (auto _ : bm) {
+    double sum = 0;
+    for (auto const& [key, value] : map) sum += std::visit([](auto x) { return static_cast<double>(x); }, value);
+    benchmark::DoNotOptimize(sum);
+  }
+  bm.SetItemsProcessed(bm.iterations() * static_cast<int64_t>(count));
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_insert, StdStr)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_insert, FlatStr)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_insert, StdInt)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_insert, FlatInt)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_lookupHit, StdStr)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_lookupHit, FlatStr)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_lookupHit, StdInt)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_lookupHit, FlatInt)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_lookupMiss, StdStr)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_lookupMiss, FlatStr)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_lookupMiss, StdInt)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_lookupMiss, FlatInt)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_iterate, StdStr)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_iterate, FlatStr)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_iterate, StdInt)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_iterate, FlatInt)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
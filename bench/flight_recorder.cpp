@@ -0,0 +1,107 @@
+// 飞行记录器的稳态开销：按值记录一条日志，对比当场格式化整行（被静音的级别原先也要付出的代价）
+// 本工具链没有 <format>，两边都用同一个以 ostringstream 替换「{}」的简易格式化代替 std::vformat
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <ctime>
+#include <source_location>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#include "benchmark.hpp"
+#include "flight_recorder.hpp"
+
+namespace {
+template <class... Args>
+std::string formatBraces(std::string_view fmt, Args const&... args) {
+  std::ostringstream oss;
+  size_t pos = 0;
+  auto one = [&](auto const& arg) {
+    size_t open = fmt.find("{}", pos);
+    oss << fmt.substr(pos, open - pos) << arg;
+    pos = open + 2;
+  };
+  (one(args), ...);
+  oss << fmt.substr(pos);
+  return oss.str();
+}
+
+template <class... Args>
+void formatRecord(std::string& out, std::string_view fmt, const std::byte* args) {
+  out += std::apply([&](auto const&... values) { return formatBraces(fmt, values...); },
+                    play::FlightRecorder::decode<Args...>(args));
+}
+
+// 与 output_log 相同的整行：时间、级别、位置与消息
+template <class... Args>
+std::string formatLine(LogLevel lv, const std::source_location& loc, std::string_view fmt, Args const&... args) {
+  time_t now = time(nullptr);
+  tm local;
+  localtime_r(&now, &local);
+  char buf[32];
+  size_t n = strftime(buf, sizeof(buf), "%F %X", &local);
+  std::string line(buf, n);
+  line.append(" [").append(getlogLevalName(lv)).append("] ").append(loc.file_name()).append(":");
+  line.append(std::to_string(loc.line())).append(" ").append(formatBraces(fmt, args...)).append("\n");
+  return line;
+}
+
+constexpr std::string_view k_fmt = "request {} from {} took {} ms";
+
+void BM_formatEagerly(benchmark::State& bm) {
+  auto loc = std::source_location::current();
+  int i = 0;
+  for (auto _ : bm) {
+    auto line = formatLine(LogLevel::Debug, loc, k_fmt, ++i, "10.0.0.1", 3.25);
+    benchmark::DoNotOptimize(line);
+  }
+  bm.SetItemsProcessed(bm.iterations());
+}
+
+void BM_record(benchmark::State& bm) {
+  auto& recorder = play::FlightRecorder::instance();
+  auto loc = std::source_location::current();
+  int i = 0;
+  for (auto _ : bm) {
+    recorder.record(LogLevel::Debug, loc, k_fmt, &formatRecord<int, const char*, double>, ++i, "10.0.0.1", 3.25);
+  }
+  bm.SetItemsProcessed(bm.iterations());
+}
+
+// 字符串参数较长时复制的字节更多
+void BM_recordString(benchmark::State& bm) {
+  auto& recorder = play::FlightRecorder::instance();
+  auto loc = std::source_location::current();
+  std::string path(bm.range(0), 'p');
+  for (auto _ : bm) {
+    recorder.record(LogLevel::Trace, loc, "open {}", &formatRecord<std::string>, path);
+  }
+  bm.SetItemsProcessed(bm.iterations());
+}
+
+// 写满本线程的环形缓冲区后整体格式化写出，一次迭代对应一次 dump
+void BM_dump(benchmark::State& bm) {
+  auto& recorder = play::FlightRecorder::instance();
+  recorder.enable("/dev/null");
+  auto loc = std::source_location::current();
+  constexpr int k_records = 512;
+  for (auto _ : bm) {
+    bm.PauseTiming();
+    for (int i = 0; i < k_records; ++i) {
+      recorder.record(LogLevel::Debug, loc, k_fmt, &formatRecord<int, const char*, double>, i, "10.0.0.1", 3.25);
+    }
+    bm.ResumeTiming();
+    recorder.dump();
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_records);
+}
+} // namespace
+
+BENCHMARK(BM_formatEagerly);
+BENCHMARK(BM_record);
+BENCHMARK(BM_recordString)->Arg(16)->Arg(128);
+BENCHMARK(BM_dump);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+// 按文件判断日志是否静音的开销：全局阈值的比较、按文件缓存后的查表，以及规则变化后重新匹配
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "log_level.hpp"
+
+namespace {
+constexpr size_t k_files = 64;
+
+// 模拟 k_files 个源文件的 file_name()：每个文件一个固定地址的字符串
+const std::vector<std::string>& files() {
+  static const std::vector<std::string> s_files = [] {
+    std::vector<std::string> res;
+    for (size_t i = 0; i < k_files; ++i) {
+      res.push_back("src/module" + std::to_string(i % 8) + "/file" + std::to_string(i) + ".cpp");
+    }
+    return res;
+  }();
+  return s_files;
+}
+
+void setRules() {
+  clear_file_mute_log_levels();
+  set_file_mute_log_level("*/module3/*", LogLevel::Trace);
+  set_file_mute_log_level("*/file42.cpp", LogLevel::Warn);
+}
+
+void BM_globalThreshold(benchmark::State& bm) {
+  size_t muted = 0;
+  for (auto _ : bm) {
+    for (size_t i = 0; i < k_files; ++i) {
+      muted += LogLevel::Debug <= g_mute_log_level;
+      // 与按文件的版本一样，每次都重新读取阈值
+      benchmark::ClobberMemory();
+    }
+    benchmark::DoNotOptimize(muted);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_files);
+}
+
+void BM_perFile(benchmark::State& bm) {
+  setRules();
+  auto const& names = files();
+  size_t muted = 0;
+  for (auto _ : bm) {
+    for (auto const& name : names) muted += is_log_muted(LogLevel::Debug, name.c_str());
+    benchmark::DoNotOptimize(muted);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_files);
+}
+
+// 每次迭代都修改规则，所有文件都要重新匹配一次
+void BM_perFileReconfigure(benchmark::State& bm) {
+  auto const& names = files();
+  size_t muted = 0;
+  for (auto _ : bm) {
+    bm.PauseTiming();
+    setRules();
+    bm.ResumeTiming();
+    for (auto const& name : names) muted += is_log_muted(LogLevel::Debug, name.c_str());
+    benchmark::DoNotOptimize(muted);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_files);
+}
+
+// 不缓存、每次都做通配符匹配，作为参照
+void BM_matchEveryCall(benchmark::State& bm) {
+  setRules();
+  auto const& names = files();
+  size_t muted = 0;
+  for (auto _ : bm) {
+    for (auto const& name : names) {
+      uint32_t level = _log_level_detail::matchFile(name.c_str());
+      auto mute = level == _log_level_detail::k_no_override ? g_mute_log_level : static_cast<LogLevel>(level);
+      muted += LogLevel::Debug <= mute;
+    }
+    benchmark::DoNotOptimize(muted);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_files);
+}
+} // namespace
+
+BENCHMARK(BM_globalThreshold);
+BENCHMARK(BM_perFile);
+BENCHMARK(BM_perFileReconfigure);
+BENCHMARK(BM_matchEveryCall);
+
+BENCHMARK_MAIN();
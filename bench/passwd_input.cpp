@@ -0,0 +1,165 @@
+// UnixPasswdInput 从管道读取大量口令：逐字符（getchar + 每字符一次回显）与按块 read()（每块一次回显）的对比
+// 以及 requestSecret 的额外开销；回显写入 /dev/null，仍计入 write 的系统调用开销
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "benchmark.hpp"
+#include "passwd_input.hpp"
+
+namespace {
+constexpr size_t k_lines = 10000;
+
+const std::string& input() {
+  static const std::string s_input = [] {
+    std::string res;
+    for (size_t i = 0; i < k_lines; ++i) res.append("secret-").append(std::to_string(i * 7919)).append("\n");
+    return res;
+  }();
+  return s_input;
+}
+
+// 一次迭代的管道：另一线程写入全部输入后关闭写端（输入大于管道容量，不能先写完再读）
+class Pipe {
+public:
+  Pipe() {
+    int fds[2];
+    if (pipe(fds) != 0) return;
+    m_read = fds[0];
+    m_writer = std::thread([fd = fds[1]] {
+      auto const& data = input();
+      for (size_t off = 0; off < data.size();) {
+        ssize_t n = write(fd, data.data() + off, data.size() - off);
+        if (n <= 0) break;
+        off += static_cast<size_t>(n);
+      }
+      close(fd);
+    });
+  }
+
+  ~Pipe() {
+    if (m_writer.joinable()) m_writer.join();
+    if (m_read >= 0) close(m_read);
+  }
+
+  int fd() const { return m_read; }
+
+private:
+  int m_read = -1;
+  std::thread m_writer;
+};
+
+// 把 fd 临时重定向到 target，析构时恢复
+class Redirect {
+public:
+  Redirect(int fd, int target) : m_fd(fd), m_saved(dup(fd)) { dup2(target, fd); }
+
+  ~Redirect() {
+    dup2(m_saved, m_fd);
+    close(m_saved);
+  }
+
+private:
+  int m_fd;
+  int m_saved;
+};
+
+template <class Read>
+size_t readAll(Read&& read) {
+  size_t lines = 0;
+  size_t bytes = 0;
+  while (true) {
+    auto [size, eof] = read();
+    if (eof && size == 0) break;
+    ++lines;
+    bytes += size;
+  }
+  return lines == k_lines ? bytes : 0;
+}
+
+void BM_charMode(benchmark::State& bm) {
+  int null = open("/dev/null", O_WRONLY);
+  size_t bytes = 0;
+  for (auto _ : bm) {
+    Pipe pipe;
+    fflush(stderr);
+    Redirect in(STDIN_FILENO, pipe.fd());
+    Redirect err(STDERR_FILENO, null);
+    clearerr(stdin);
+    play::UnixPasswdInput passwd;
+    bytes = readAll([&] {
+      auto line = passwd.request();
+      return std::pair(line.size(), passwd.eof());
+    });
+  }
+  close(null);
+  if (bytes == 0) bm.SkipWithError("unexpected line count");
+  bm.SetItemsProcessed(bm.iterations() * k_lines);
+  bm.SetBytesProcessed(bm.iterations() * input().size());
+}
+
+void BM_batchedMode(benchmark::State& bm) {
+  int null = open("/dev/null", O_WRONLY);
+  size_t bytes = 0;
+  for (auto _ : bm) {
+    Pipe pipe;
+    play::UnixPasswdInput passwd(play::UnixPasswdInput::ReadMode::Batched, pipe.fd(), null);
+    bytes = readAll([&] {
+      auto line = passwd.request();
+      return std::pair(line.size(), passwd.eof());
+    });
+  }
+  close(null);
+  if (bytes == 0) bm.SkipWithError("unexpected line count");
+  bm.SetItemsProcessed(bm.iterations() * k_lines);
+  bm.SetBytesProcessed(bm.iterations() * input().size());
+}
+
+// requestSecret：每行额外有 poll 与 SecretString 的 mmap/mlock/munmap
+void BM_secretMode(benchmark::State& bm) {
+  int null = open("/dev/null", O_WRONLY);
+  size_t bytes = 0;
+  for (auto _ : bm) {
+    Pipe pipe;
+    play::UnixPasswdInput passwd(play::UnixPasswdInput::ReadMode::Batched, pipe.fd(), null);
+    bytes = readAll([&] {
+      auto secret = passwd.requestSecret("", std::chrono::seconds(1));
+      return std::pair(secret.size(), passwd.eof());
+    });
+  }
+  close(null);
+  if (bytes == 0) bm.SkipWithError("unexpected line count");
+  bm.SetItemsProcessed(bm.iterations() * k_lines);
+  bm.SetBytesProcessed(bm.iterations() * input().size());
+}
+
+// 复用同一个 SecretString，只剩 poll 的开销
+void BM_secretReuse(benchmark::State& bm) {
+  int null = open("/dev/null", O_WRONLY);
+  size_t bytes = 0;
+  play::SecretString secret(256);
+  for (auto _ : bm) {
+    Pipe pipe;
+    play::UnixPasswdInput passwd(play::UnixPasswdInput::ReadMode::Batched, pipe.fd(), null);
+    bytes = readAll([&] {
+      auto status = passwd.requestSecret("", std::chrono::seconds(1), secret);
+      return std::pair(secret.size(), status == play::UnixPasswdInput::Status::Eof);
+    });
+  }
+  close(null);
+  if (bytes == 0) bm.SkipWithError("unexpected line count");
+  bm.SetItemsProcessed(bm.iterations() * k_lines);
+  bm.SetBytesProcessed(bm.iterations() * input().size());
+}
+} // namespace
+
+BENCHMARK(BM_charMode)->UseRealTime();
+BENCHMARK(BM_batchedMode)->UseRealTime();
+BENCHMARK(BM_secretMode)->UseRealTime();
+BENCHMARK(BM_secretReuse)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,139 @@
+#pragma once
+
+// 通过 Linux perf_event_open 读取硬件性能计数器，供 benchmark.hpp 在计时区间内累计
+// 计数器不可用时（非 Linux、容器内无权限、虚拟机未暴露 PMU 等）只跳过对应事件，不影响计时
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace benchmark::_harness_detail {
+struct PerfEvent {
+  const char* name;
+  uint32_t type;
+  uint64_t config;
+};
+
+#if defined(__linux__)
+constexpr uint64_t cacheConfig(uint64_t cache, uint64_t op, uint64_t result) { return cache | op << 8 | result << 16; }
+
+inline constexpr PerfEvent k_perf_events[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"l1d_misses", PERF_TYPE_HW_CACHE,
+     cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"stalled_cycles_frontend", PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND},
+    {"stalled_cycles_backend", PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND},
+};
+#else
+inline constexpr PerfEvent k_perf_events[] = {
+    {"cycles", 0, 0},
+    {"instructions", 0, 0},
+    {"l1d_misses", 0, 0},
+    {"llc_misses", 0, 0},
+    {"branch_misses", 0, 0},
+    {"stalled_cycles_frontend", 0, 0},
+    {"stalled_cycles_backend", 0, 0},
+};
+#endif
+
+// 一次读数，enabled/running 用于在事件被内核分时复用时按比例还原
+struct PerfReading {
+  uint64_t value = 0;
+  uint64_t enabled = 0;
+  uint64_t running = 0;
+};
+
+class PerfCounters {
+public:
+  PerfCounters() = default;
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  ~PerfCounters() {
+#if defined(__linux__)
+    for (int fd : m_fds) close(fd);
+#endif
+  }
+
+  /// @brief 打开 names 中的事件（"all" 表示全部），返回无法打开的事件名
+  std::vector<std::string> open(std::vector<std::string> const& names) {
+    std::vector<std::string> unavailable;
+    for (auto const& event : k_perf_events) {
+      bool wanted = false;
+      for (auto const& name : names) wanted = wanted || name == "all" || name == event.name;
+      if (!wanted) continue;
+      int fd = openEvent(event);
+      if (fd < 0) {
+        unavailable.emplace_back(event.name);
+        continue;
+      }
+      m_fds.push_back(fd);
+      m_names.emplace_back(event.name);
+    }
+    for (auto const& name : names) {
+      bool known = name == "all";
+      for (auto const& event : k_perf_events) known = known || name == event.name;
+      if (!known) unavailable.push_back(name);
+    }
+    return unavailable;
+  }
+
+  bool empty() const { return m_fds.empty(); }
+
+  size_t size() const { return m_fds.size(); }
+
+  std::vector<std::string> const& names() const { return m_names; }
+
+  void read(std::vector<PerfReading>& out) const {
+    out.resize(m_fds.size());
+#if defined(__linux__)
+    for (size_t i = 0; i < m_fds.size(); ++i) {
+      uint64_t buf[3] = {};
+      if (::read(m_fds[i], buf, sizeof(buf)) == static_cast<ssize_t>(sizeof(buf))) out[i] = {buf[0], buf[1], buf[2]};
+    }
+#endif
+  }
+
+  /// @brief 两次读数之间的事件数，按 enabled/running 还原被复用期间的计数
+  static double delta(PerfReading const& begin, PerfReading const& end) {
+    double value = static_cast<double>(end.value - begin.value);
+    uint64_t enabled = end.enabled - begin.enabled, running = end.running - begin.running;
+    if (running == 0) return 0;
+    return running < enabled ? value * static_cast<double>(enabled) / static_cast<double>(running) : value;
+  }
+
+private:
+  static int openEvent([[maybe_unused]] PerfEvent const& event) {
+#if defined(__linux__)
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // 同时统计基准内部创建的线程
+    attr.inherit = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    if (fd < 0) return -1;
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    return fd;
+#else
+    return -1;
+#endif
+  }
+
+  std::vector<int> m_fds;
+  std::vector<std::string> m_names;
+};
+} // namespace benchmark::_harness_detail
@@ -0,0 +1,118 @@
+// play::formatTo（供 std::formatter 使用，直接写入输出迭代器）与 play::toString（每层一个 std::ostringstream）的对比，
+// 以及输出被截断到固定长度的情形：BM_formatToN 以 TruncatingIterator 模拟 std::format_to_n，
+// 标准库有 <format> 时另有 BM_stdFormatToN 经由 std::formatter<play::Printable<T>> 调用真正的 std::format_to_n
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "print_format.hpp"
+
+namespace {
+// 写满 n 个字符后丢弃后续输出，但仍计数，语义同 std::format_to_n
+class TruncatingIterator {
+public:
+  TruncatingIterator(char* out, size_t n) : m_out(out), m_left(n) {}
+
+  TruncatingIterator& operator*() { return *this; }
+  TruncatingIterator& operator++() { return *this; }
+  TruncatingIterator& operator++(int) { return *this; }
+
+  TruncatingIterator& operator=(char c) {
+    if (m_left) {
+      *m_out++ = c;
+      --m_left;
+    }
+    ++m_size;
+    return *this;
+  }
+
+  size_t size() const { return m_size; }
+
+private:
+  char* m_out;
+  size_t m_left;
+  size_t m_size = 0;
+};
+
+std::vector<int> makeVector() {
+  std::vector<int> res;
+  for (int i = 0; i < 64; ++i) res.push_back(i * 114514);
+  return res;
+}
+
+std::map<std::string, std::vector<double>> makeMap() {
+  std::map<std::string, std::vector<double>> res;
+  for (int i = 0; i < 16; ++i) res["key" + std::to_string(i)] = {i * 0.5, i * 1.25, i * 3.0};
+  return res;
+}
+
+template <class T>
+void BM_toString(benchmark::State& bm, T const& value) {
+  size_t bytes = 0;
+  for (auto _ : bm) bytes += play::toString(value).size();
+  bm.SetBytesProcessed(bytes);
+}
+
+// 与 std::format_to(std::back_inserter(buffer), ...) 相同：复用同一个缓冲区
+template <class T>
+void BM_formatTo(benchmark::State& bm, T const& value) {
+  std::string buffer;
+  size_t bytes = 0;
+  for (auto _ : bm) {
+    buffer.clear();
+    play::formatTo(std::back_inserter(buffer), value);
+    bytes += buffer.size();
+  }
+  bm.SetBytesProcessed(bytes);
+}
+
+template <class T>
+void BM_formatToN(benchmark::State& bm, T const& value) {
+  char buffer[64];
+  size_t bytes = 0;
+  for (auto _ : bm) {
+    auto it = play::formatTo(TruncatingIterator(buffer, sizeof(buffer)), value);
+    benchmark::DoNotOptimize(buffer);
+    bytes += it.size();
+  }
+  bm.SetBytesProcessed(bytes);
+}
+
+#if defined(__cpp_lib_format)
+template <class T>
+void BM_stdFormatToN(benchmark::State& bm, T const& value) {
+  char buffer[64];
+  size_t bytes = 0;
+  for (auto _ : bm) {
+    auto res = std::format_to_n(buffer, sizeof(buffer), "{}", play::printable(value));
+    benchmark::DoNotOptimize(buffer);
+    bytes += static_cast<size_t>(res.size);
+  }
+  bm.SetBytesProcessed(bytes);
+}
+
+void BM_stdFormatToNVector(benchmark::State& bm) { BM_stdFormatToN(bm, makeVector()); }
+void BM_stdFormatToNMap(benchmark::State& bm) { BM_stdFormatToN(bm, makeMap()); }
+#endif
+
+void BM_toStringVector(benchmark::State& bm) { BM_toString(bm, makeVector()); }
+void BM_formatToVector(benchmark::State& bm) { BM_formatTo(bm, makeVector()); }
+void BM_formatToNVector(benchmark::State& bm) { BM_formatToN(bm, makeVector()); }
+void BM_toStringMap(benchmark::State& bm) { BM_toString(bm, makeMap()); }
+void BM_formatToMap(benchmark::State& bm) { BM_formatTo(bm, makeMap()); }
+void BM_formatToNMap(benchmark::State& bm) { BM_formatToN(bm, makeMap()); }
+} // namespace
+
+BENCHMARK(BM_toStringVector);
+BENCHMARK(BM_formatToVector);
+BENCHMARK(BM_formatToNVector);
+BENCHMARK(BM_toStringMap);
+BENCHMARK(BM_formatToMap);
+BENCHMARK(BM_formatToNMap);
+#if defined(__cpp_lib_format)
+BENCHMARK(BM_stdFormatToNVector);
+BENCHMARK(BM_stdFormatToNMap);
+#endif
+
+BENCHMARK_MAIN();
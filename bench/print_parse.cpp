@@ -0,0 +1,90 @@
+// play::fromString 的解析吞吐，与同一数据经 play::toString / play::formatTo 序列化的开销对照（往返）
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "print_parse.hpp"
+
+namespace {
+std::vector<int> makeInts() {
+  std::vector<int> res;
+  for (int i = 0; i < 4096; ++i) res.push_back(i * 7919 - 1000000);
+  return res;
+}
+
+// 较长的字符串，偶尔含有需要转义的引号
+std::vector<std::string> makeStrings() {
+  std::vector<std::string> res;
+  for (int i = 0; i < 256; ++i) {
+    std::string s(200 + i % 50, 'a' + i % 26);
+    if (i % 8 == 0) s[s.size() / 2] = '"';
+    res.push_back(std::move(s));
+  }
+  return res;
+}
+
+std::map<std::string, std::vector<double>> makeMap() {
+  std::map<std::string, std::vector<double>> res;
+  for (int i = 0; i < 256; ++i) res["key" + std::to_string(i)] = {i * 0.5, i * 1.25, i * 3.0, -i * 0.125};
+  return res;
+}
+
+template <class T>
+void BM_parse(benchmark::State& bm, T const& value) {
+  const std::string text = play::toString(value);
+  size_t bytes = 0;
+  for (auto _ : bm) {
+    auto res = play::fromString<T>(text);
+    if (!res) {
+      bm.SkipWithError("parse failed");
+      break;
+    }
+    benchmark::DoNotOptimize(res);
+    bytes += text.size();
+  }
+  bm.SetBytesProcessed(bytes);
+}
+
+template <class T>
+void BM_serialize(benchmark::State& bm, T const& value) {
+  std::string buffer;
+  size_t bytes = 0;
+  for (auto _ : bm) {
+    buffer.clear();
+    play::formatTo(std::back_inserter(buffer), value);
+    bytes += buffer.size();
+  }
+  bm.SetBytesProcessed(bytes);
+}
+
+void BM_parseInts(benchmark::State& bm) { BM_parse(bm, makeInts()); }
+void BM_serializeInts(benchmark::State& bm) { BM_serialize(bm, makeInts()); }
+void BM_parseStrings(benchmark::State& bm) { BM_parse(bm, makeStrings()); }
+void BM_serializeStrings(benchmark::State& bm) { BM_serialize(bm, makeStrings()); }
+void BM_parseMap(benchmark::State& bm) { BM_parse(bm, makeMap()); }
+void BM_serializeMap(benchmark::State& bm) { BM_serialize(bm, makeMap()); }
+
+// 解析结果复用同一个对象，不计每次构造容器的分配
+void BM_parseStringsReuse(benchmark::State& bm) {
+  const std::string text = play::toString(makeStrings());
+  std::vector<std::string> res;
+  size_t bytes = 0;
+  for (auto _ : bm) {
+    play::fromChars(text.data(), text.data() + text.size(), res);
+    benchmark::DoNotOptimize(res);
+    bytes += text.size();
+  }
+  bm.SetBytesProcessed(bytes);
+}
+} // namespace
+
+BENCHMARK(BM_parseInts);
+BENCHMARK(BM_serializeInts);
+BENCHMARK(BM_parseStrings);
+BENCHMARK(BM_parseStringsReuse);
+BENCHMARK(BM_serializeStrings);
+BENCHMARK(BM_parseMap);
+BENCHMARK(BM_serializeMap);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,107 @@
+// 可平凡迁移（play::is_trivially_relocatable）的元素在 play::SmallVector 中扩容、插入、删除时整段 memcpy/memmove，
+// std::vector 则逐个经由 Variant 的移动构造与析构（各自再按下标分派到备选类型）：
+// - Rel：Variant<int64_t, std::vector<int>, std::unique_ptr<int>, Boxed<Big>>，可平凡迁移
+// - Str：Variant<int64_t, std::string>，libstdc++ 的 std::string 不可平凡迁移，两者走相同的路径，作为对照
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "std/small_vector.hpp"
+#include "std/variant.hpp"
+
+namespace {
+constexpr size_t k_grow_count = 1 << 16;
+constexpr size_t k_erase_size = 1 << 14;
+constexpr size_t k_erase_count = 256;
+
+struct Big {
+  int64_t words[16];
+};
+
+using Rel = play::Variant<int64_t, std::vector<int>, std::unique_ptr<int>, play::Boxed<Big>>;
+using Str = play::Variant<int64_t, std::string>;
+
+static_assert(play::is_trivially_relocatable_v<Rel> && !play::is_trivially_relocatable_v<Str>);
+
+// 各备选类型轮流出现；字符串超过 SSO 的长度
+template <typename V>
+V makeValue(size_t i) {
+  if constexpr (std::is_same_v<V, Rel>) {
+    switch (i % 4) {
+      case 0: return V(static_cast<int64_t>(i));
+      case 1: return V(std::vector<int>{static_cast<int>(i)});
+      case 2: return V(std::make_unique<int>(static_cast<int>(i)));
+      default: return V(play::in_place_index<3>, Big{});
+    }
+  } else {
+    if (i % 2 == 0) return V(static_cast<int64_t>(i));
+    return V(std::string(32, static_cast<char>('a' + i % 26)));
+  }
+}
+
+// 不预留容量逐个追加，期间扩容约 16 次，迁移的元素总数约为最终个数
+template <typename Vec>
+void BM_grow(benchmark::State& bm) {
+  using V = typename Vec::value_type;
+  for (auto _ : bm) {
+    Vec vec;
+    for (size_t i = 0; i < k_grow_count; ++i) vec.push_back(makeValue<V>(i));
+    benchmark::DoNotOptimize(vec.data());
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_grow_count);
+}
+
+// 逐个删除靠前的元素，每次都要把其后约 16K 个元素前移一位
+template <typename Vec>
+void BM_eraseFront(benchmark::State& bm) {
+  using V = typename Vec::value_type;
+  for (auto _ : bm) {
+    bm.PauseTiming();
+    Vec vec;
+    vec.reserve(k_erase_size);
+    for (size_t i = 0; i < k_erase_size; ++i) vec.push_back(makeValue<V>(i));
+    bm.ResumeTiming();
+    for (size_t i = 0; i < k_erase_count; ++i) vec.erase(vec.begin() + 1);
+    benchmark::DoNotOptimize(vec.data());
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_erase_count);
+}
+
+// 逐个插入到开头，每次都要把全部元素后移一位
+template <typename Vec>
+void BM_insertFront(benchmark::State& bm) {
+  using V = typename Vec::value_type;
+  for (auto _ : bm) {
+    bm.PauseTiming();
+    Vec vec;
+    vec.reserve(k_erase_size + k_erase_count);
+    for (size_t i = 0; i < k_erase_size; ++i) vec.push_back(makeValue<V>(i));
+    bm.ResumeTiming();
+    for (size_t i = 0; i < k_erase_count; ++i) vec.insert(vec.begin(), makeValue<V>(i));
+    benchmark::DoNotOptimize(vec.data());
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_erase_count);
+}
+
+using StdRel = std::vector<Rel>;
+using SmallRel = play::SmallVector<Rel, 4>;
+using StdStr = std::vector<Str>;
+using SmallStr = play::SmallVector<Str, 4>;
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_grow, StdRel);
+BENCHMARK_TEMPLATE(BM_grow, SmallRel);
+BENCHMARK_TEMPLATE(BM_grow, StdStr);
+BENCHMARK_TEMPLATE(BM_grow, SmallStr);
+BENCHMARK_TEMPLATE(BM_eraseFront, StdRel);
+BENCHMARK_TEMPLATE(BM_eraseFront, SmallRel);
+BENCHMARK_TEMPLATE(BM_eraseFront, StdStr);
+BENCHMARK_TEMPLATE(BM_eraseFront, SmallStr);
+BENCHMARK_TEMPLATE(BM_insertFront, StdRel);
+BENCHMARK_TEMPLATE(BM_insertFront, SmallRel);
+BENCHMARK_TEMPLATE(BM_insertFront, StdStr);
+BENCHMARK_TEMPLATE(BM_insertFront, SmallStr);
+
+BENCHMARK_MAIN();
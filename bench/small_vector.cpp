@@ -0,0 +1,181 @@
+// play::SmallVector / play::InlineString 与 std::vector / std::string 在日志与序列化热路径上的对比基准
+// 通过替换全局 operator new 统计每次迭代的堆分配次数（allocs），SSO 放不下的短字符串与小数组在 std 版本中每次都要分配
+// 注意：logLine 与 serialize 是按 output_log、_serializer 的输出格式手写的替身，两者本身仍使用 std::string
+// 与 std::ostringstream（logger.hpp 还依赖 <format>，不一定能编入基准），allocs 之差是改用 InlineString 后
+// 可省下的分配次数的估计；BM_serializePrint 测的才是现有的 play::toString
+#include <charconv>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "print.hpp"
+#include "std/inline_string.hpp"
+#include "std/small_vector.hpp"
+
+namespace {
+size_t s_allocs = 0;
+
+// 不内联，避免 GCC 把 operator new 与 free 配对后误报 -Wmismatched-new-delete
+[[gnu::noinline]] void* rawAllocate(size_t size) { return std::malloc(size == 0 ? 1 : size); }
+
+[[gnu::noinline]] void rawFree(void* p) noexcept { std::free(p); }
+} // namespace
+
+void* operator new(size_t size) {
+  ++s_allocs;
+  if (void* p = rawAllocate(size)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { rawFree(p); }
+
+void operator delete(void* p, size_t) noexcept { rawFree(p); }
+
+namespace {
+constexpr size_t k_count = 1024;
+
+// 计时区间内的分配次数，按迭代平均
+class AllocCounter {
+public:
+  explicit AllocCounter(benchmark::State& bm) : m_bm(bm), m_begin(s_allocs) {}
+
+  ~AllocCounter() {
+    if (m_bm.iterations() > 0) {
+      m_bm.counters["allocs"] = static_cast<double>(s_allocs - m_begin) / static_cast<double>(m_bm.iterations());
+    }
+  }
+
+private:
+  benchmark::State& m_bm;
+  size_t m_begin;
+};
+
+template <typename String>
+void appendInt(String& out, long value) {
+  char buf[24];
+  auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+  out.append(std::string_view(buf, end - buf));
+}
+
+// 日志行（替身）：与 output_log 相同的布局「时间 [级别] 文件:行号 消息」，长度超过 libstdc++ 的 15 字节 SSO
+template <typename String>
+String formatLogLine(std::string_view time, std::string_view level, std::string_view file, long line,
+                     std::string_view msg) {
+  String out;
+  out.append(time);
+  out.append(" [");
+  out.append(level);
+  out.append("] ");
+  out.append(file);
+  out.append(":");
+  appendInt(out, line);
+  out.append(" ");
+  out.append(msg);
+  out.append("\n");
+  return out;
+}
+
+template <typename String>
+void BM_logLine(benchmark::State& bm) {
+  long total = 0;
+  AllocCounter counter(bm);
+  for (auto _ : bm) {
+    for (size_t i = 0; i < k_count; ++i) {
+      auto line = formatLogLine<String>("2024-01-01 12:00:00", "Info", "src/passwd_input.hpp", static_cast<long>(i),
+                                        "read password");
+      total += static_cast<long>(line.size());
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+
+// 序列化（替身）：与 print.hpp 中可迭代对象的输出格式相同的「[1, 2, 3, 4]」，每个元素先单独转为字符串再拼接
+template <typename String>
+String serializeItem(int value) {
+  String out;
+  appendInt(out, value);
+  return out;
+}
+
+template <typename String>
+String serialize(const std::vector<int>& items) {
+  String out;
+  out.append("[");
+  bool flag = false;
+  for (int item : items) {
+    if (flag) out.append(", ");
+    flag = true;
+    out.append(std::string_view(serializeItem<String>(item)));
+  }
+  out.append("]");
+  return out;
+}
+
+template <typename String>
+void BM_serialize(benchmark::State& bm) {
+  std::vector<int> items{114514, 1919810, 42, 2024};
+  long total = 0;
+  AllocCounter counter(bm);
+  for (auto _ : bm) {
+    for (size_t i = 0; i < k_count; ++i) {
+      items[0] = static_cast<int>(i);
+      total += static_cast<long>(serialize<String>(items).size());
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+
+// 现有的 play::toString（基于 std::ostringstream），作为参照
+void BM_serializePrint(benchmark::State& bm) {
+  std::vector<int> items{114514, 1919810, 42, 2024};
+  long total = 0;
+  AllocCounter counter(bm);
+  for (auto _ : bm) {
+    for (size_t i = 0; i < k_count; ++i) {
+      items[0] = static_cast<int>(i);
+      total += static_cast<long>(play::toString(items).size());
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+
+// 日志参数收集：每条日志把不超过 range(0) 个参数的视图放进一个临时数组
+template <typename Vector>
+void BM_collectArgs(benchmark::State& bm) {
+  size_t args = bm.range(0);
+  std::string_view arg = "value";
+  size_t total = 0;
+  AllocCounter counter(bm);
+  for (auto _ : bm) {
+    for (size_t i = 0; i < k_count; ++i) {
+      Vector fields;
+      for (size_t j = 0; j < args; ++j) fields.push_back(arg);
+      for (auto const& field : fields) total += field.size();
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+
+using StdString = std::string;
+using InlineString128 = play::InlineString<128>;
+using StdVector = std::vector<std::string_view>;
+using SmallVector8 = play::SmallVector<std::string_view, 8>;
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_logLine, StdString);
+BENCHMARK_TEMPLATE(BM_logLine, InlineString128);
+BENCHMARK(BM_serializePrint);
+BENCHMARK_TEMPLATE(BM_serialize, StdString);
+BENCHMARK_TEMPLATE(BM_serialize, InlineString128);
+// 8 个以内全部内联，16 个时 SmallVector 也要分配一次
+BENCHMARK_TEMPLATE(BM_collectArgs, StdVector)->Arg(2)->Arg(8)->Arg(16);
+BENCHMARK_TEMPLATE(BM_collectArgs, SmallVector8)->Arg(2)->Arg(8)->Arg(16);
+
+BENCHMARK_MAIN();
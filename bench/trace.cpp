@@ -0,0 +1,75 @@
+// 追踪宏的开销：关闭时（一次 relaxed 读取）与开启时（两次取时间 + 写入本线程缓冲区），以及写出 JSON 的吞吐
+#include <sstream>
+
+#include "benchmark.hpp"
+#include "trace.hpp"
+
+namespace {
+// 每批记录后清空缓冲区，避免写满后只测到丢弃的路径
+constexpr size_t k_batch = 1024;
+
+void BM_scopeDisabled(benchmark::State& bm) {
+  play::Tracer::enable(false);
+  for (auto _ : bm) {
+    PLAY_TRACE_SCOPE("disabled");
+    benchmark::ClobberMemory();
+  }
+  bm.SetItemsProcessed(bm.iterations());
+}
+
+void BM_scopeEnabled(benchmark::State& bm) {
+  play::Tracer::enable();
+  for (auto _ : bm) {
+    for (size_t i = 0; i < k_batch; ++i) {
+      PLAY_TRACE_SCOPE("enabled");
+      benchmark::ClobberMemory();
+    }
+    bm.PauseTiming();
+    play::Tracer::instance().clear();
+    bm.ResumeTiming();
+  }
+  play::Tracer::enable(false);
+  bm.SetItemsProcessed(bm.iterations() * k_batch);
+}
+
+void BM_beginEndEnabled(benchmark::State& bm) {
+  play::Tracer::enable();
+  for (auto _ : bm) {
+    for (size_t i = 0; i < k_batch; ++i) {
+      PLAY_TRACE_BEGIN("pair");
+      benchmark::ClobberMemory();
+      PLAY_TRACE_END("pair");
+    }
+    bm.PauseTiming();
+    play::Tracer::instance().clear();
+    bm.ResumeTiming();
+  }
+  play::Tracer::enable(false);
+  bm.SetItemsProcessed(bm.iterations() * k_batch);
+}
+
+void BM_writeJson(benchmark::State& bm) {
+  play::Tracer::enable();
+  size_t bytes = 0;
+  for (auto _ : bm) {
+    bm.PauseTiming();
+    for (size_t i = 0; i < k_batch; ++i) {
+      PLAY_TRACE_SCOPE("write");
+    }
+    std::ostringstream os;
+    bm.ResumeTiming();
+    play::Tracer::instance().write(os);
+    bytes += os.str().size();
+  }
+  play::Tracer::enable(false);
+  bm.SetItemsProcessed(bm.iterations() * k_batch);
+  bm.SetBytesProcessed(bytes);
+}
+} // namespace
+
+BENCHMARK(BM_scopeDisabled);
+BENCHMARK(BM_scopeEnabled);
+BENCHMARK(BM_beginEndEnabled);
+BENCHMARK(BM_writeJson);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,145 @@
+// 按类型路由消息的几种方式：比较 demangle 出的名字、逐个比较 type_info、以 type_index 查散列表、以 typeId 编号查数组
+#include <memory>
+#include <random>
+#include <string_view>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "demangle.hpp"
+#include "type_id.hpp"
+
+namespace {
+constexpr size_t k_count = 1 << 12;
+// 种类少（如 8 种）时逐个比较 type_info 的链式分支反而最快，线性查找的开销随种类数增长，编号查表则不变
+constexpr size_t k_kinds = 32;
+
+struct Message {
+  explicit Message(uint32_t typeId) : typeId(typeId) {}
+  virtual ~Message() = default;
+
+  uint32_t typeId;
+};
+
+template <size_t I>
+struct Alt : Message {
+  Alt() : Message(play::typeId<Alt>()) {}
+
+  uint64_t payload = I;
+};
+
+// 各类型的处理函数，按 I 区分运算避免被合并
+template <size_t I>
+uint64_t handle(const Message& msg) {
+  return static_cast<const Alt<I>&>(msg).payload * (2 * I + 1);
+}
+
+using Handler = uint64_t (*)(const Message&);
+
+template <size_t... Is>
+std::vector<std::unique_ptr<Message>> makeMessages(std::index_sequence<Is...>) {
+  using Factory = std::unique_ptr<Message> (*)();
+  constexpr Factory factories[] = {[]() -> std::unique_ptr<Message> { return std::make_unique<Alt<Is>>(); }...};
+  std::mt19937 gen(114514);
+  std::uniform_int_distribution<size_t> dist(0, k_kinds - 1);
+  std::vector<std::unique_ptr<Message>> res(k_count);
+  for (auto& msg : res) msg = factories[dist(gen)]();
+  return res;
+}
+
+const std::vector<std::unique_ptr<Message>>& messages() {
+  static auto s_messages = makeMessages(std::make_index_sequence<k_kinds>{});
+  return s_messages;
+}
+
+// 各方式都只负责找到处理函数，调用方式相同，比较的是查找本身的开销
+template <size_t... Is>
+Handler routeByName(const Message& msg, std::index_sequence<Is...>) {
+  std::string_view name = play::demangle(typeid(msg));
+  Handler res = nullptr;
+  ((name == play::demangle<Alt<Is>>() ? (res = &handle<Is>, true) : false) || ...);
+  return res;
+}
+
+template <size_t... Is>
+Handler routeByTypeInfo(const Message& msg, std::index_sequence<Is...>) {
+  const std::type_info& info = typeid(msg);
+  Handler res = nullptr;
+  ((info == typeid(Alt<Is>) ? (res = &handle<Is>, true) : false) || ...);
+  return res;
+}
+
+template <size_t... Is>
+std::unordered_map<std::type_index, Handler> makeTypeIndexTable(std::index_sequence<Is...>) {
+  return {{typeid(Alt<Is>), &handle<Is>}...};
+}
+
+template <size_t... Is>
+std::vector<Handler> makeIdTable(std::index_sequence<Is...>) {
+  std::vector<Handler> table(play::TypeRegistry::instance().count());
+  ((table[play::typeId<Alt<Is>>()] = &handle<Is>), ...);
+  return table;
+}
+
+void BM_routeByName(benchmark::State& bm) {
+  auto const& msgs = messages();
+  for (auto _ : bm) {
+    uint64_t sum = 0;
+    for (auto const& msg : msgs) sum += routeByName(*msg, std::make_index_sequence<k_kinds>{})(*msg);
+    benchmark::DoNotOptimize(sum);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+
+void BM_routeByTypeInfo(benchmark::State& bm) {
+  auto const& msgs = messages();
+  for (auto _ : bm) {
+    uint64_t sum = 0;
+    for (auto const& msg : msgs) sum += routeByTypeInfo(*msg, std::make_index_sequence<k_kinds>{})(*msg);
+    benchmark::DoNotOptimize(sum);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+
+void BM_routeByTypeIndexMap(benchmark::State& bm) {
+  auto const& msgs = messages();
+  auto table = makeTypeIndexTable(std::make_index_sequence<k_kinds>{});
+  for (auto _ : bm) {
+    uint64_t sum = 0;
+    for (auto const& msg : msgs) sum += table.find(typeid(*msg))->second(*msg);
+    benchmark::DoNotOptimize(sum);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+
+void BM_routeById(benchmark::State& bm) {
+  auto const& msgs = messages();
+  auto table = makeIdTable(std::make_index_sequence<k_kinds>{});
+  for (auto _ : bm) {
+    uint64_t sum = 0;
+    for (auto const& msg : msgs) sum += table[msg->typeId](*msg);
+    benchmark::DoNotOptimize(sum);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+
+// 反序列化：由类型名查编号，再按编号取大小
+void BM_findByName(benchmark::State& bm) {
+  auto const& registry = play::TypeRegistry::instance();
+  std::string_view name = play::typeName<Alt<3>>();
+  for (auto _ : bm) {
+    auto id = registry.find(name);
+    benchmark::DoNotOptimize(registry.size(*id));
+  }
+}
+} // namespace
+
+BENCHMARK(BM_routeByName);
+BENCHMARK(BM_routeByTypeInfo);
+BENCHMARK(BM_routeByTypeIndexMap);
+BENCHMARK(BM_routeById);
+BENCHMARK(BM_findByName);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,128 @@
+// 备选类型大小悬殊时，把罕见的大备选类型装箱（play::Boxed）对 vector<Variant> 遍历与构造的影响：
+// - Inline：512 字节的备选类型直接存放，每个元素都占 520 字节
+// - Boxed：装箱后每个元素只占 16 字节，大对象经全局 operator new 分配
+// - BoxedPool：同上，但大对象从 play::Pool 分配
+// 元素中只有 1% 是大对象
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "allocator.hpp"
+#include "benchmark.hpp"
+#include "std/variant.hpp"
+
+namespace {
+constexpr size_t k_count = 1 << 16;
+
+struct Big {
+  uint64_t apply() const { return words[0] ^ words[63]; }
+
+  uint64_t words[64];
+};
+
+play::Pool g_big_pool(sizeof(Big), alignof(Big), 1024);
+
+using Inline = play::Variant<uint64_t, double, Big>;
+using Boxed = play::Variant<uint64_t, double, play::Boxed<Big>>;
+using BoxedPool = play::Variant<uint64_t, double, play::Boxed<Big, play::AllocatorBoxPool<g_big_pool>>>;
+
+static_assert(sizeof(Boxed) == 16 && sizeof(BoxedPool) == 16);
+// 移动只转移指针且不抛异常，std::vector 扩容时移动而不是拷贝元素
+static_assert(std::is_nothrow_move_constructible_v<Boxed> && std::is_nothrow_move_constructible_v<BoxedPool>);
+
+// 每个元素的类型下标：0/1 各占 49.5%，2（大对象）占 1%
+std::vector<uint8_t> makeKinds() {
+  std::mt19937_64 gen(114514);
+  std::uniform_int_distribution<int> dist(0, 199);
+  std::vector<uint8_t> res(k_count);
+  for (auto& kind : res) {
+    int r = dist(gen);
+    kind = r < 2 ? 2 : r % 2;
+  }
+  return res;
+}
+
+// reserve 为 false 时逐个追加，期间 std::vector 扩容约 16 次，每次都要移动已有的元素
+template <typename V, bool reserve = true>
+std::vector<V> makeVariants() {
+  static const std::vector<uint8_t> s_kinds = makeKinds();
+  std::vector<V> res;
+  if constexpr (reserve) res.reserve(k_count);
+  uint64_t value = 0;
+  for (auto kind : s_kinds) {
+    ++value;
+    if (kind == 0) {
+      res.emplace_back(play::in_place_index<0>, value);
+    } else if (kind == 1) {
+      res.emplace_back(play::in_place_index<1>, static_cast<double>(value));
+    } else {
+      Big big{};
+      big.words[0] = value;
+      res.emplace_back(play::in_place_index<2>, big);
+    }
+  }
+  return res;
+}
+
+struct Apply {
+  uint64_t operator()(uint64_t x) const { return x; }
+  uint64_t operator()(double x) const { return static_cast<uint64_t>(x) * 3; }
+  uint64_t operator()(const Big& x) const { return x.apply(); }
+};
+
+template <typename V>
+void BM_iterate(benchmark::State& bm) {
+  auto data = makeVariants<V>();
+  for (auto _ : bm) {
+    uint64_t sum = 0;
+    for (auto const& v : data) sum += play::visit(Apply{}, v);
+    benchmark::DoNotOptimize(sum);
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+
+template <typename V>
+void BM_build(benchmark::State& bm) {
+  for (auto _ : bm) {
+    auto data = makeVariants<V>();
+    benchmark::DoNotOptimize(data.data());
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+
+template <typename V>
+void BM_grow(benchmark::State& bm) {
+  for (auto _ : bm) {
+    auto data = makeVariants<V, false>();
+    benchmark::DoNotOptimize(data.data());
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+
+// 拷贝整个数组：Inline 拷贝全部 520 字节的元素，装箱后只深拷贝 1% 的大对象
+template <typename V>
+void BM_copy(benchmark::State& bm) {
+  auto data = makeVariants<V>();
+  for (auto _ : bm) {
+    auto copy = data;
+    benchmark::DoNotOptimize(copy.data());
+  }
+  bm.SetItemsProcessed(bm.iterations() * k_count);
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_iterate, Inline);
+BENCHMARK_TEMPLATE(BM_iterate, Boxed);
+BENCHMARK_TEMPLATE(BM_iterate, BoxedPool);
+BENCHMARK_TEMPLATE(BM_build, Inline);
+BENCHMARK_TEMPLATE(BM_build, Boxed);
+BENCHMARK_TEMPLATE(BM_build, BoxedPool);
+BENCHMARK_TEMPLATE(BM_grow, Inline);
+BENCHMARK_TEMPLATE(BM_grow, Boxed);
+BENCHMARK_TEMPLATE(BM_grow, BoxedPool);
+BENCHMARK_TEMPLATE(BM_copy, Inline);
+BENCHMARK_TEMPLATE(BM_copy, Boxed);
+BENCHMARK_TEMPLATE(BM_copy, BoxedPool);
+
+BENCHMARK_MAIN();
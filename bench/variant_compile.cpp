@@ -0,0 +1,40 @@
+// 编译期基准：以 VARIANT_ALTS 个备选类型实例化 Variant，覆盖构造、拷贝/移动、emplace、get 以及单/双变体访问，
+// 由 bench_variant_compile 目标分别以不同的 VARIANT_ALTS 编译并计时
+#include "std/variant.hpp"
+
+#ifndef VARIANT_ALTS
+#define VARIANT_ALTS 8
+#endif
+
+template <size_t I>
+struct Alt {
+  Alt() = default;
+  Alt(const Alt& rhs) : value(rhs.value) {}
+  ~Alt() {}
+
+  size_t value = I;
+};
+
+template <size_t... Is>
+auto makeVariant(std::index_sequence<Is...>) -> play::Variant<Alt<Is>...>;
+
+using V = decltype(makeVariant(std::make_index_sequence<VARIANT_ALTS>()));
+using Small = play::Variant<Alt<0>, Alt<1>, Alt<2>, Alt<3>>;
+
+size_t exercise(V& a, const Small& s) {
+  V b(play::in_place_index<VARIANT_ALTS - 1>);
+  V c = b;
+  c = a;
+  b = std::move(c);
+  b.emplace<VARIANT_ALTS / 2>();
+  size_t res = play::get<VARIANT_ALTS / 2>(b).value;
+  res += play::visit([](const auto& x) { return x.value; }, a);
+  res += play::visit([](const auto& x, const auto& y) { return x.value + y.value; }, b, s);
+  return res;
+}
+
+int main() {
+  V a;
+  Small s;
+  return static_cast<int>(exercise(a, s));
+}
@@ -0,0 +1,130 @@
+// 对比 never valueless 与可能 valueless 的 Variant 在访问密集路径上的开销：
+// 前者的跳转表不含 variant_npos 槽位，拷贝/移动/析构也不再检查 valueless 状态
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "std/variant.hpp"
+
+namespace {
+// 与 std::string 布局一致，但移动构造可能抛出异常，因此 Variant 仍需处理 valueless 状态
+struct MayThrowString {
+  MayThrowString(const char* s) : value(s) {}
+  MayThrowString(const MayThrowString&) = default;
+  MayThrowString(MayThrowString&& rhs) noexcept(false) : value(std::move(rhs.value)) {}
+  MayThrowString& operator=(const MayThrowString&) = default;
+  MayThrowString& operator=(MayThrowString&&) = default;
+
+  size_t size() const { return value.size(); }
+
+  std::string value;
+};
+
+template <size_t I>
+struct Tag {
+  size_t size() const { return I; }
+};
+
+using NeverValueless = play::Variant<int, double, std::string>;
+using MaybeValueless = play::Variant<int, double, MayThrowString>;
+// 超过 switch 上限，走跳转表
+using NeverValuelessWide =
+    play::Variant<Tag<0>, Tag<1>, Tag<2>, Tag<3>, Tag<4>, Tag<5>, Tag<6>, Tag<7>, Tag<8>, Tag<9>, Tag<10>, Tag<11>,
+                  Tag<12>, Tag<13>, std::string>;
+using MaybeValuelessWide =
+    play::Variant<Tag<0>, Tag<1>, Tag<2>, Tag<3>, Tag<4>, Tag<5>, Tag<6>, Tag<7>, Tag<8>, Tag<9>, Tag<10>, Tag<11>,
+                  Tag<12>, Tag<13>, MayThrowString>;
+
+constexpr size_t k_count = 1 << 14;
+
+template <typename V, size_t I>
+V makeAt() {
+  using T = play::variant_alternative_t<I, V>;
+  if constexpr (std::is_arithmetic_v<T>) {
+    return V(play::in_place_index<I>, I);
+  } else if constexpr (std::is_constructible_v<T, const char*>) {
+    return V(play::in_place_index<I>, "play::variant");
+  } else {
+    return V(play::in_place_index<I>);
+  }
+}
+
+template <typename V, size_t... Is>
+std::vector<V> makeInput(std::index_sequence<Is...>) {
+  constexpr V (*makers[])() = {&makeAt<V, Is>...};
+  std::mt19937 gen(114514);
+  std::uniform_int_distribution<size_t> dist(0, sizeof...(Is) - 1);
+  std::vector<V> res;
+  res.reserve(k_count);
+  for (size_t i = 0; i < k_count; ++i) {
+    res.push_back(makers[dist(gen)]());
+  }
+  return res;
+}
+
+template <typename V>
+std::vector<V> makeInput() {
+  return makeInput<V>(std::make_index_sequence<play::variant_size_v<V>>());
+}
+
+template <typename T>
+size_t weight(const T& t) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    return static_cast<size_t>(t);
+  } else {
+    return t.size();
+  }
+}
+
+template <typename V>
+void BM_visit(benchmark::State& state) {
+  auto input = makeInput<V>();
+  for (auto _ : state) {
+    size_t sum = 0;
+    for (auto const& v : input) {
+      sum += play::visit([](auto const& x) { return weight(x); }, v);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * k_count);
+}
+
+template <typename V>
+void BM_copyAssign(benchmark::State& state) {
+  auto input = makeInput<V>();
+  auto output = makeInput<V>();
+  for (auto _ : state) {
+    for (size_t i = 0; i < k_count; ++i) {
+      output[i] = input[k_count - 1 - i];
+    }
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.SetItemsProcessed(state.iterations() * k_count);
+}
+
+template <typename V>
+void BM_copyDestroy(benchmark::State& state) {
+  auto input = makeInput<V>();
+  for (auto _ : state) {
+    std::vector<V> copy(input);
+    benchmark::DoNotOptimize(copy.data());
+  }
+  state.SetItemsProcessed(state.iterations() * k_count);
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_visit, NeverValueless);
+BENCHMARK_TEMPLATE(BM_visit, MaybeValueless);
+BENCHMARK_TEMPLATE(BM_visit, NeverValuelessWide);
+BENCHMARK_TEMPLATE(BM_visit, MaybeValuelessWide);
+BENCHMARK_TEMPLATE(BM_copyAssign, NeverValueless);
+BENCHMARK_TEMPLATE(BM_copyAssign, MaybeValueless);
+BENCHMARK_TEMPLATE(BM_copyAssign, NeverValuelessWide);
+BENCHMARK_TEMPLATE(BM_copyAssign, MaybeValuelessWide);
+BENCHMARK_TEMPLATE(BM_copyDestroy, NeverValueless);
+BENCHMARK_TEMPLATE(BM_copyDestroy, MaybeValueless);
+BENCHMARK_TEMPLATE(BM_copyDestroy, NeverValuelessWide);
+BENCHMARK_TEMPLATE(BM_copyDestroy, MaybeValuelessWide);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,523 @@
+// play::Variant 与 std::variant、虚函数派发、手写 enum + union + switch 的对比基准：
+// - 2/8/32 个备选类型下的单变体访问（随机分布/按类型排序分布），以及 play::match 的纯 switch 派发
+// - 双变体访问
+// - 跨备选类型的拷贝/移动赋值
+// - 构造/析构
+// 用于确定 doVisit 中 switch 与跳转表的分界（k_switch_cases）以及跳转表是否划算
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "std/match.hpp"
+#include "std/variant.hpp"
+
+namespace {
+constexpr size_t k_count = 1 << 14;
+
+// 每个备选类型的运算各不相同，避免编译器把所有分支合并为一个
+template <size_t I>
+struct Alt {
+  uint64_t apply() const { return value * (2 * I + 1) + I; }
+
+  uint64_t value;
+};
+
+template <size_t I, size_t J>
+uint64_t combine(const Alt<I>& a, const Alt<J>& b) {
+  return a.apply() ^ (b.apply() << 1);
+}
+
+// 输入：每个元素的类型下标与值，sorted 为 true 时按类型下标排序（分支预测友好）
+template <size_t N, bool sorted>
+std::vector<std::pair<size_t, uint64_t>> makeKinds() {
+  std::mt19937_64 gen(114514);
+  std::uniform_int_distribution<size_t> dist(0, N - 1);
+  std::vector<std::pair<size_t, uint64_t>> res(k_count);
+  for (auto& [kind, value] : res) {
+    kind = dist(gen);
+    value = gen() & 0xffff;
+  }
+  if constexpr (sorted) {
+    std::sort(res.begin(), res.end(), [](auto const& l, auto const& r) { return l.first < r.first; });
+  }
+  return res;
+}
+
+template <typename V, size_t I>
+V makeAt(uint64_t value) {
+  return V(std::in_place_index<I>, Alt<I>{value});
+}
+
+template <typename V, size_t I>
+V makePlayAt(uint64_t value) {
+  return V(play::in_place_index<I>, Alt<I>{value});
+}
+
+// play::Variant + play::visit（备选类型超过 k_switch_cases 时走跳转表）
+template <size_t N>
+struct PlayVisit {
+  template <size_t... Is>
+  static auto types(std::index_sequence<Is...>) -> play::Variant<Alt<Is>...>;
+
+  using Value = decltype(types(std::make_index_sequence<N>()));
+
+  template <size_t... Is>
+  static Value make(size_t kind, uint64_t value, std::index_sequence<Is...>) {
+    constexpr Value (*makers[])(uint64_t) = {&makePlayAt<Value, Is>...};
+    return makers[kind](value);
+  }
+
+  static Value make(size_t kind, uint64_t value) { return make(kind, value, std::make_index_sequence<N>()); }
+
+  static uint64_t apply(const Value& v) {
+    return play::visit([](const auto& a) { return a.apply(); }, v);
+  }
+
+  static uint64_t combine(const Value& a, const Value& b) {
+    return play::visit([](const auto& x, const auto& y) { return ::combine(x, y); }, a, b);
+  }
+};
+
+// play::Variant + play::match（始终走 switch）
+template <size_t N>
+struct PlayMatch : PlayVisit<N> {
+  using Value = typename PlayVisit<N>::Value;
+
+  static uint64_t apply(const Value& v) {
+    return play::match(v, [](const auto& a) { return a.apply(); });
+  }
+};
+
+template <size_t N>
+struct StdVisit {
+  template <size_t... Is>
+  static auto types(std::index_sequence<Is...>) -> std::variant<Alt<Is>...>;
+
+  using Value = decltype(types(std::make_index_sequence<N>()));
+
+  template <size_t... Is>
+  static Value make(size_t kind, uint64_t value, std::index_sequence<Is...>) {
+    constexpr Value (*makers[])(uint64_t) = {&makeAt<Value, Is>...};
+    return makers[kind](value);
+  }
+
+  static Value make(size_t kind, uint64_t value) { return make(kind, value, std::make_index_sequence<N>()); }
+
+  static uint64_t apply(const Value& v) {
+    return std::visit([](const auto& a) { return a.apply(); }, v);
+  }
+
+  static uint64_t combine(const Value& a, const Value& b) {
+    return std::visit([](const auto& x, const auto& y) { return ::combine(x, y); }, a, b);
+  }
+};
+
+// 虚函数派发，双变体访问通过两次虚调用实现（double dispatch）
+struct Shape {
+  virtual ~Shape() = default;
+  virtual uint64_t apply() const = 0;
+  virtual uint64_t combine(const Shape& rhs) const = 0;
+  virtual uint64_t combineWith(uint64_t lhs_applied) const = 0;
+};
+
+template <size_t I>
+struct ShapeAt final : Shape {
+  explicit ShapeAt(uint64_t value) : alt{value} {}
+
+  uint64_t apply() const override { return alt.apply(); }
+  uint64_t combine(const Shape& rhs) const override { return rhs.combineWith(alt.apply()); }
+  uint64_t combineWith(uint64_t lhs_applied) const override { return lhs_applied ^ (alt.apply() << 1); }
+
+  Alt<I> alt;
+};
+
+template <size_t I>
+std::unique_ptr<Shape> makeShapeAt(uint64_t value) {
+  return std::make_unique<ShapeAt<I>>(value);
+}
+
+template <size_t N>
+struct Virtual {
+  using Value = std::unique_ptr<Shape>;
+
+  template <size_t... Is>
+  static Value make(size_t kind, uint64_t value, std::index_sequence<Is...>) {
+    constexpr Value (*makers[])(uint64_t) = {&makeShapeAt<Is>...};
+    return makers[kind](value);
+  }
+
+  static Value make(size_t kind, uint64_t value) { return make(kind, value, std::make_index_sequence<N>()); }
+
+  static uint64_t apply(const Value& v) { return v->apply(); }
+
+  static uint64_t combine(const Value& a, const Value& b) { return a->combine(*b); }
+};
+
+// 手写的 enum + union + switch
+struct Tagged {
+  uint8_t tag;
+  union {
+    Alt<0> a0;
+    Alt<1> a1;
+    uint64_t raw;
+  };
+};
+
+#define TAGGED_CASE(I) \
+  case I:              \
+    if constexpr (I < N) return f.template operator()<I>();
+#define TAGGED_SWITCH(tag)                                                                                   \
+  switch (tag) {                                                                                             \
+    TAGGED_CASE(0) TAGGED_CASE(1) TAGGED_CASE(2) TAGGED_CASE(3) TAGGED_CASE(4) TAGGED_CASE(5) TAGGED_CASE(6) \
+    TAGGED_CASE(7) TAGGED_CASE(8) TAGGED_CASE(9) TAGGED_CASE(10) TAGGED_CASE(11) TAGGED_CASE(12)             \
+    TAGGED_CASE(13) TAGGED_CASE(14) TAGGED_CASE(15) TAGGED_CASE(16) TAGGED_CASE(17) TAGGED_CASE(18)          \
+    TAGGED_CASE(19) TAGGED_CASE(20) TAGGED_CASE(21) TAGGED_CASE(22) TAGGED_CASE(23) TAGGED_CASE(24)          \
+    TAGGED_CASE(25) TAGGED_CASE(26) TAGGED_CASE(27) TAGGED_CASE(28) TAGGED_CASE(29) TAGGED_CASE(30)          \
+    TAGGED_CASE(31)                                                                                          \
+    default:                                                                                                 \
+      __builtin_unreachable();                                                                               \
+  }
+
+template <size_t N, typename F>
+uint64_t dispatchTagged(uint8_t tag, F&& f) {
+  static_assert(N <= 32);
+  TAGGED_SWITCH(tag)
+}
+
+#undef TAGGED_SWITCH
+#undef TAGGED_CASE
+
+template <size_t N>
+struct TaggedUnion {
+  using Value = Tagged;
+
+  static Value make(size_t kind, uint64_t value) {
+    Tagged res;
+    res.tag = static_cast<uint8_t>(kind);
+    res.raw = value;
+    return res;
+  }
+
+  static uint64_t apply(const Value& v) {
+    return dispatchTagged<N>(v.tag, [&]<size_t I>() { return Alt<I>{v.raw}.apply(); });
+  }
+
+  static uint64_t combine(const Value& a, const Value& b) {
+    return dispatchTagged<N>(a.tag, [&]<size_t I>() {
+      return dispatchTagged<N>(b.tag, [&]<size_t J>() { return ::combine(Alt<I>{a.raw}, Alt<J>{b.raw}); });
+    });
+  }
+};
+
+template <typename Impl, size_t N, bool sorted>
+std::vector<typename Impl::Value> makeValues() {
+  std::vector<typename Impl::Value> res;
+  res.reserve(k_count);
+  for (auto const& [kind, value] : makeKinds<N, sorted>()) {
+    res.push_back(Impl::make(kind, value));
+  }
+  return res;
+}
+
+template <template <size_t> typename Impl, size_t N, bool sorted>
+void BM_visit(benchmark::State& state) {
+  auto values = makeValues<Impl<N>, N, sorted>();
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (auto const& v : values) {
+      sum += Impl<N>::apply(v);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * k_count);
+}
+
+template <template <size_t> typename Impl, size_t N>
+void BM_visit2(benchmark::State& state) {
+  auto lhs = makeValues<Impl<N>, N, false>();
+  auto rhs = makeValues<Impl<N>, N, false>();
+  std::shuffle(rhs.begin(), rhs.end(), std::mt19937(1919810));
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < k_count; ++i) {
+      sum += Impl<N>::combine(lhs[i], rhs[i]);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * k_count);
+}
+
+// 拷贝/移动/构造析构使用非平凡的备选类型
+using Payload = std::vector<uint32_t>;
+
+std::string makeString(uint64_t value) { return "payload-" + std::to_string(value); }
+
+Payload makePayload(uint64_t value) { return Payload(4, static_cast<uint32_t>(value)); }
+
+template <typename V>
+struct MixedVariant {
+  using Value = V;
+
+  static Value make(size_t kind, uint64_t value) {
+    switch (kind) {
+      case 0:
+        return Value(value);
+      case 1:
+        return Value(static_cast<double>(value));
+      case 2:
+        return Value(makeString(value));
+      default:
+        return Value(makePayload(value));
+    }
+  }
+
+  static Value copy(const Value& v) { return v; }
+};
+
+using PlayMixed = MixedVariant<play::Variant<uint64_t, double, std::string, Payload>>;
+using StdMixed = MixedVariant<std::variant<uint64_t, double, std::string, Payload>>;
+
+struct MixedShape {
+  virtual ~MixedShape() = default;
+  virtual std::unique_ptr<MixedShape> clone() const = 0;
+};
+
+template <typename T>
+struct MixedShapeOf final : MixedShape {
+  explicit MixedShapeOf(T v) : value(std::move(v)) {}
+
+  std::unique_ptr<MixedShape> clone() const override { return std::make_unique<MixedShapeOf>(value); }
+
+  T value;
+};
+
+struct VirtualMixed {
+  // 拷贝语义需要借助 clone
+  struct Value {
+    Value(std::unique_ptr<MixedShape> p) : ptr(std::move(p)) {}
+    Value(const Value& rhs) : ptr(rhs.ptr->clone()) {}
+    Value(Value&&) noexcept = default;
+    Value& operator=(const Value& rhs) {
+      ptr = rhs.ptr->clone();
+      return *this;
+    }
+    Value& operator=(Value&&) noexcept = default;
+
+    std::unique_ptr<MixedShape> ptr;
+  };
+
+  static Value make(size_t kind, uint64_t value) {
+    switch (kind) {
+      case 0:
+        return Value(std::make_unique<MixedShapeOf<uint64_t>>(value));
+      case 1:
+        return Value(std::make_unique<MixedShapeOf<double>>(static_cast<double>(value)));
+      case 2:
+        return Value(std::make_unique<MixedShapeOf<std::string>>(makeString(value)));
+      default:
+        return Value(std::make_unique<MixedShapeOf<Payload>>(makePayload(value)));
+    }
+  }
+};
+
+// 手写的带生命周期管理的 tagged union
+struct TaggedMixed {
+  struct Value {
+    enum class Kind : uint8_t { U64, F64, Str, Vec };
+
+    Value(uint64_t v) : kind(Kind::U64), u64(v) {}
+    Value(double v) : kind(Kind::F64), f64(v) {}
+    Value(std::string v) : kind(Kind::Str) { new (&str) std::string(std::move(v)); }
+    Value(Payload v) : kind(Kind::Vec) { new (&vec) Payload(std::move(v)); }
+    Value(const Value& rhs) { construct(rhs); }
+    Value(Value&& rhs) noexcept { construct(std::move(rhs)); }
+    ~Value() { destroy(); }
+
+    Value& operator=(const Value& rhs) {
+      if (kind == rhs.kind) {
+        switch (kind) {
+          case Kind::U64:
+            u64 = rhs.u64;
+            break;
+          case Kind::F64:
+            f64 = rhs.f64;
+            break;
+          case Kind::Str:
+            str = rhs.str;
+            break;
+          case Kind::Vec:
+            vec = rhs.vec;
+            break;
+        }
+      } else {
+        Value tmp(rhs);
+        destroy();
+        construct(std::move(tmp));
+      }
+      return *this;
+    }
+
+    Value& operator=(Value&& rhs) noexcept {
+      if (kind == rhs.kind) {
+        switch (kind) {
+          case Kind::U64:
+            u64 = rhs.u64;
+            break;
+          case Kind::F64:
+            f64 = rhs.f64;
+            break;
+          case Kind::Str:
+            str = std::move(rhs.str);
+            break;
+          case Kind::Vec:
+            vec = std::move(rhs.vec);
+            break;
+        }
+      } else {
+        destroy();
+        construct(std::move(rhs));
+      }
+      return *this;
+    }
+
+    template <typename V>
+    void construct(V&& rhs) {
+      kind = rhs.kind;
+      switch (kind) {
+        case Kind::U64:
+          u64 = rhs.u64;
+          break;
+        case Kind::F64:
+          f64 = rhs.f64;
+          break;
+        case Kind::Str:
+          new (&str) std::string(std::forward<V>(rhs).str);
+          break;
+        case Kind::Vec:
+          new (&vec) Payload(std::forward<V>(rhs).vec);
+          break;
+      }
+    }
+
+    void destroy() {
+      switch (kind) {
+        case Kind::Str:
+          str.~basic_string();
+          break;
+        case Kind::Vec:
+          vec.~Payload();
+          break;
+        default:
+          break;
+      }
+    }
+
+    Kind kind;
+    union {
+      uint64_t u64;
+      double f64;
+      std::string str;
+      Payload vec;
+    };
+  };
+
+  static Value make(size_t kind, uint64_t value) {
+    switch (kind) {
+      case 0:
+        return Value(value);
+      case 1:
+        return Value(static_cast<double>(value));
+      case 2:
+        return Value(makeString(value));
+      default:
+        return Value(makePayload(value));
+    }
+  }
+};
+
+template <typename Impl>
+void BM_copyAssign(benchmark::State& state) {
+  auto src = makeValues<Impl, 4, false>();
+  auto dst = makeValues<Impl, 4, false>();
+  std::reverse(dst.begin(), dst.end());
+  for (auto _ : state) {
+    for (size_t i = 0; i < k_count; ++i) {
+      dst[i] = src[i];
+    }
+    benchmark::DoNotOptimize(dst.data());
+    // 下一轮重新制造跨类型赋值
+    std::rotate(src.begin(), src.begin() + 1, src.end());
+  }
+  state.SetItemsProcessed(state.iterations() * k_count);
+}
+
+template <typename Impl>
+void BM_moveAssign(benchmark::State& state) {
+  auto values = makeValues<Impl, 4, false>();
+  for (auto _ : state) {
+    // 相邻元素的类型随机，逐个前移即为跨类型移动赋值
+    auto first = std::move(values.front());
+    for (size_t i = 0; i + 1 < k_count; ++i) {
+      values[i] = std::move(values[i + 1]);
+    }
+    values.back() = std::move(first);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * k_count);
+}
+
+template <typename Impl>
+void BM_churn(benchmark::State& state) {
+  auto kinds = makeKinds<4, false>();
+  for (auto _ : state) {
+    std::vector<typename Impl::Value> values;
+    values.reserve(k_count);
+    for (auto const& [kind, value] : kinds) {
+      values.push_back(Impl::make(kind, value));
+    }
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * k_count);
+}
+} // namespace
+
+#define BENCHMARK_VISIT(N, sorted)                    \
+  BENCHMARK_TEMPLATE(BM_visit, PlayVisit, N, sorted); \
+  BENCHMARK_TEMPLATE(BM_visit, PlayMatch, N, sorted); \
+  BENCHMARK_TEMPLATE(BM_visit, StdVisit, N, sorted);  \
+  BENCHMARK_TEMPLATE(BM_visit, Virtual, N, sorted);   \
+  BENCHMARK_TEMPLATE(BM_visit, TaggedUnion, N, sorted);
+
+BENCHMARK_VISIT(2, false)
+BENCHMARK_VISIT(2, true)
+BENCHMARK_VISIT(8, false)
+BENCHMARK_VISIT(8, true)
+BENCHMARK_VISIT(32, false)
+BENCHMARK_VISIT(32, true)
+
+#define BENCHMARK_VISIT2(N)                    \
+  BENCHMARK_TEMPLATE(BM_visit2, PlayVisit, N); \
+  BENCHMARK_TEMPLATE(BM_visit2, StdVisit, N);  \
+  BENCHMARK_TEMPLATE(BM_visit2, Virtual, N);   \
+  BENCHMARK_TEMPLATE(BM_visit2, TaggedUnion, N);
+
+BENCHMARK_VISIT2(2)
+BENCHMARK_VISIT2(8)
+
+#define BENCHMARK_MIXED(f)             \
+  BENCHMARK_TEMPLATE(f, PlayMixed);    \
+  BENCHMARK_TEMPLATE(f, StdMixed);     \
+  BENCHMARK_TEMPLATE(f, VirtualMixed); \
+  BENCHMARK_TEMPLATE(f, TaggedMixed);
+
+BENCHMARK_MIXED(BM_copyAssign)
+BENCHMARK_MIXED(BM_moveAssign)
+BENCHMARK_MIXED(BM_churn)
+
+BENCHMARK_MAIN();
@@ -1,28 +1,172 @@
-#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
 
-constexpr size_t n = 1 << 17;
-std::vector<float> a(n);
+#include "bandwidth.hpp"
+#include "benchmark.hpp"
+#include "reduce.hpp"
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+// 工作集所处的存储层级，用作带宽基准的标签
+const char *memoryLevel(size_t bytes) {
+  static const size_t s_caches[] = {
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+      static_cast<size_t>(sysconf(_SC_LEVEL1_DCACHE_SIZE)),
+      static_cast<size_t>(sysconf(_SC_LEVEL2_CACHE_SIZE)),
+      static_cast<size_t>(sysconf(_SC_LEVEL3_CACHE_SIZE)),
+#else
+      size_t(32) << 10, size_t(1) << 20, size_t(32) << 20,
+#endif
+  };
+  const char *levels[] = {"L1", "L2", "L3"};
+  for (size_t i = 0; i < 3; ++i) {
+    if (bytes <= s_caches[i]) return levels[i];
+  }
+  return "DRAM";
+}
+
+// 带宽基准的缓冲区，同一规模在校准与多次重复之间复用；规模改变时重新分配以释放旧内存
+std::vector<float> &bandwidthBuffer(size_t index, size_t size) {
+  static std::vector<float> buffers[3];
+  if (buffers[index].size() != size) buffers[index] = std::vector<float>(size, 1.0f);
+  return buffers[index];
+}
+
+// 工作集 4 KiB 到 1 GiB
+#define BANDWIDTH_SIZES RangeMultiplier(4)->Range(4 << 10, 1 << 30)
 
 void BM_for(benchmark::State &bm) {
+  auto &a = bandwidthBuffer(0, bm.range(0) / sizeof(float));
   for (auto _ : bm) {
     // fill a with 0
     for (size_t i = 0; i < a.size(); i++) {
       a[i] = .0;
     }
+    benchmark::ClobberMemory();
+  }
+  bm.SetBytesProcessed(bm.iterations() * bm.range(0));
+  bm.SetLabel(memoryLevel(bm.range(0)));
+}
+BENCHMARK(BM_for)->BANDWIDTH_SIZES;
+
+using play::bandwidth::Store;
+
+enum class Kernel { Fill, Copy, Triad };
+enum class Threads { Single, Multi };
+
+// 按 STREAM 的惯例统计字节数：fill 写 1 个数组，copy 读 1 写 1，triad 读 2 写 1；普通写的写分配流量不计入
+template <Kernel kernel, Store store, Threads threads>
+void BM_bandwidth(benchmark::State &bm) {
+  constexpr size_t arrays = kernel == Kernel::Fill ? 1 : kernel == Kernel::Copy ? 2 : 3;
+  size_t size = bm.range(0) / sizeof(float) / arrays;
+  auto &a = bandwidthBuffer(0, size);
+  auto &b = bandwidthBuffer(1, kernel == Kernel::Fill ? 0 : size);
+  auto &c = bandwidthBuffer(2, kernel == Kernel::Triad ? size : 0);
+  for (auto _ : bm) {
+    if constexpr (threads == Threads::Single) {
+      if constexpr (kernel == Kernel::Fill) play::bandwidth::fill(a, 0.0f, store);
+      if constexpr (kernel == Kernel::Copy) play::bandwidth::copy(a, b, store);
+      if constexpr (kernel == Kernel::Triad) play::bandwidth::triad(a, b, c, 3.0f, store);
+    } else {
+      if constexpr (kernel == Kernel::Fill) play::bandwidth::parallelFill(a, 0.0f, 0, store);
+      if constexpr (kernel == Kernel::Copy) play::bandwidth::parallelCopy(a, b, 0, store);
+      if constexpr (kernel == Kernel::Triad) play::bandwidth::parallelTriad(a, b, c, 3.0f, 0, store);
+    }
+    benchmark::ClobberMemory();
   }
+  bm.SetBytesProcessed(bm.iterations() * size * arrays * sizeof(float));
+  bm.SetLabel(memoryLevel(bm.range(0)));
 }
-BENCHMARK(BM_for);
 
+#define BENCHMARK_BANDWIDTH(kernel)                                                               \
+  BENCHMARK_TEMPLATE(BM_bandwidth, kernel, Store::Regular, Threads::Single)->BANDWIDTH_SIZES;     \
+  BENCHMARK_TEMPLATE(BM_bandwidth, kernel, Store::NonTemporal, Threads::Single)->BANDWIDTH_SIZES; \
+  BENCHMARK_TEMPLATE(BM_bandwidth, kernel, Store::Regular, Threads::Multi)                        \
+      ->BANDWIDTH_SIZES->UseRealTime();                                                           \
+  BENCHMARK_TEMPLATE(BM_bandwidth, kernel, Store::NonTemporal, Threads::Multi)                    \
+      ->BANDWIDTH_SIZES->UseRealTime();
+
+BENCHMARK_BANDWIDTH(Kernel::Fill)
+BENCHMARK_BANDWIDTH(Kernel::Copy)
+BENCHMARK_BANDWIDTH(Kernel::Triad)
+
+// 归约的输入，同一规模在校准与多次重复之间复用
+template <typename T>
+const std::vector<T> &reduceInput(size_t size) {
+  static std::vector<T> input;
+  if (input.size() != size) {
+    std::mt19937 gen(114514);
+    std::uniform_real_distribution<T> dist(0, 1);
+    input.resize(size);
+    for (auto &x : input) x = dist(gen);
+  }
+  return input;
+}
+
+template <typename T>
 void BM_reduce(benchmark::State &bm) {
+  auto const &data = reduceInput<T>(bm.range(0));
   for (auto _ : bm) {
-    // calculate sum of a
-    float res = 0;
-    for (size_t i = 0; i < a.size(); i++) {
-      res += a[i];
+    // calculate sum of data
+    T res = 0;
+    for (size_t i = 0; i < data.size(); i++) {
+      res += data[i];
     }
     benchmark::DoNotOptimize(res);
   }
+  bm.SetItemsProcessed(bm.iterations() * data.size());
+  bm.SetBytesProcessed(bm.iterations() * data.size() * sizeof(T));
 }
-BENCHMARK(BM_reduce);
 
-BENCHMARK_MAIN();
\ No newline at end of file
+enum class Reduce { Scalar, SSE, AVX2, AVX512, Kahan, Pairwise, Parallel };
+
+template <typename T, Reduce kind>
+void BM_reduceWith(benchmark::State &bm) {
+  using namespace play::reduce;
+  // Kahan/Pairwise/Parallel 使用运行时检测到的最优指令集
+  constexpr Isa isa = kind == Reduce::Scalar   ? Isa::Scalar
+                      : kind == Reduce::SSE    ? Isa::SSE
+                      : kind == Reduce::AVX2   ? Isa::AVX2
+                      : kind == Reduce::AVX512 ? Isa::AVX512
+                                               : Isa::Auto;
+  if (isa != Isa::Auto && detectIsa() < isa) {
+    bm.SkipWithError("instruction set is not supported by this CPU");
+    return;
+  }
+
+  auto const &data = reduceInput<T>(bm.range(0));
+  for (auto _ : bm) {
+    T res;
+    if constexpr (kind == Reduce::Kahan) {
+      res = sumKahan(data);
+    } else if constexpr (kind == Reduce::Pairwise) {
+      res = sumPairwise(data);
+    } else if constexpr (kind == Reduce::Parallel) {
+      res = parallelSum(data);
+    } else {
+      res = sum(data, isa);
+    }
+    benchmark::DoNotOptimize(res);
+  }
+  bm.SetItemsProcessed(bm.iterations() * data.size());
+  bm.SetBytesProcessed(bm.iterations() * data.size() * sizeof(T));
+}
+
+// 1K 到 32M 个元素：float 为 4 KiB（L1）到 128 MiB（远超 LLC），double 为 8 KiB 到 256 MiB
+#define REDUCE_SIZES RangeMultiplier(4)->Range(1 << 10, 1 << 25)
+#define BENCHMARK_REDUCE(T)                                             \
+  BENCHMARK_TEMPLATE(BM_reduce, T)->REDUCE_SIZES;                       \
+  BENCHMARK_TEMPLATE(BM_reduceWith, T, Reduce::Scalar)->REDUCE_SIZES;   \
+  BENCHMARK_TEMPLATE(BM_reduceWith, T, Reduce::SSE)->REDUCE_SIZES;      \
+  BENCHMARK_TEMPLATE(BM_reduceWith, T, Reduce::AVX2)->REDUCE_SIZES;     \
+  BENCHMARK_TEMPLATE(BM_reduceWith, T, Reduce::AVX512)->REDUCE_SIZES;   \
+  BENCHMARK_TEMPLATE(BM_reduceWith, T, Reduce::Kahan)->REDUCE_SIZES;    \
+  BENCHMARK_TEMPLATE(BM_reduceWith, T, Reduce::Pairwise)->REDUCE_SIZES; \
+  BENCHMARK_TEMPLATE(BM_reduceWith, T, Reduce::Parallel)->REDUCE_SIZES->UseRealTime();
+
+BENCHMARK_REDUCE(float)
+BENCHMARK_REDUCE(double)
+
+BENCHMARK_MAIN();
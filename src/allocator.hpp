@@ -0,0 +1,429 @@
+#pragma once
+
+// 面向大量短生命周期小对象的分配器：
+// - Arena：单调递增分配，按块串成链表，整体释放
+// - Pool：定长块 + 空闲链表
+// - ThreadCachingPool：按大小分级的线程本地缓存，常见路径不加锁，批量与共享池交换内存块
+// 三者都提供 allocate/deallocate 与 create/destroy（基于 play::construct_at）的直接接口，
+// 并可经 MemoryResource 适配为 std::pmr::memory_resource 供 pmr 容器使用
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "std/memory.hpp"
+
+namespace play {
+namespace _allocator_detail {
+// 空闲块首部复用为单向链表节点
+struct Link {
+  Link* next;
+};
+
+// 向上游申请的内存块，首部记录链表指针与大小以便整体归还
+struct Chunk {
+  Chunk* next;
+  size_t size;
+};
+
+constexpr uintptr_t alignUp(uintptr_t n, size_t align) { return (n + align - 1) & ~static_cast<uintptr_t>(align - 1); }
+
+inline void releaseChunks(Chunk*& head, std::pmr::memory_resource* upstream,
+                          size_t align = alignof(std::max_align_t)) {
+  while (head) {
+    Chunk* next = head->next;
+    upstream->deallocate(head, head->size, align);
+    head = next;
+  }
+}
+} // namespace _allocator_detail
+
+/// @brief 单调递增分配器：在当前块内移动指针分配，块用尽时向上游申请加倍大小的新块
+/// deallocate 不回收内存，reset/release 时整体归还；不会调用 create 出的对象的析构函数；非线程安全
+class Arena {
+public:
+  static constexpr size_t s_max_chunk = size_t(1) << 20;
+
+  explicit Arena(size_t initialChunk = 4096, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : m_upstream(upstream), m_initialChunk(std::max(initialChunk, sizeof(_allocator_detail::Chunk) * 2)),
+        m_nextChunk(m_initialChunk) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  ~Arena() { release(); }
+
+  void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+    uintptr_t p = _allocator_detail::alignUp(m_current, align);
+    if (p + bytes > m_end || m_current == 0) [[unlikely]] {
+      return allocateChunk(bytes, align);
+    }
+    m_current = p + bytes;
+    return reinterpret_cast<void*>(p);
+  }
+
+  void deallocate(void*, size_t, size_t = alignof(std::max_align_t)) noexcept {}
+
+  template <typename T, typename... Args>
+  T* create(Args&&... args) {
+    return play::construct_at(static_cast<T*>(allocate(sizeof(T), alignof(T))), std::forward<Args>(args)...);
+  }
+
+  template <typename T>
+  void destroy(T* p) noexcept {
+    std::destroy_at(p);
+  }
+
+  /// @brief 保留最近申请的块供后续分配复用，其余块归还上游；适合逐请求复用同一个 Arena
+  void reset() noexcept {
+    if (!m_chunks) return;
+    _allocator_detail::releaseChunks(m_chunks->next, m_upstream);
+    m_current = reinterpret_cast<uintptr_t>(m_chunks + 1);
+    m_end = reinterpret_cast<uintptr_t>(m_chunks) + m_chunks->size;
+  }
+
+  /// @brief 归还全部块，块大小恢复为初始值
+  void release() noexcept {
+    _allocator_detail::releaseChunks(m_chunks, m_upstream);
+    m_current = m_end = 0;
+    m_nextChunk = m_initialChunk;
+  }
+
+  std::pmr::memory_resource* upstream() const noexcept { return m_upstream; }
+
+private:
+  void* allocateChunk(size_t bytes, size_t align) {
+    using _allocator_detail::Chunk;
+    size_t size = std::max(m_nextChunk, sizeof(Chunk) + align - 1 + bytes);
+    auto* chunk = static_cast<Chunk*>(m_upstream->allocate(size, alignof(std::max_align_t)));
+    *chunk = {m_chunks, size};
+    m_chunks = chunk;
+    m_nextChunk = std::min(m_nextChunk * 2, s_max_chunk);
+
+    uintptr_t p = _allocator_detail::alignUp(reinterpret_cast<uintptr_t>(chunk + 1), align);
+    m_current = p + bytes;
+    m_end = reinterpret_cast<uintptr_t>(chunk) + size;
+    return reinterpret_cast<void*>(p);
+  }
+
+  uintptr_t m_current = 0;
+  uintptr_t m_end = 0;
+  _allocator_detail::Chunk* m_chunks = nullptr;
+  std::pmr::memory_resource* m_upstream;
+  size_t m_initialChunk;
+  size_t m_nextChunk;
+};
+
+/// @brief 定长块对象池：优先复用空闲链表中的块，否则从当前块中切分，块用尽时向上游申请加倍大小的新块
+/// 超过块大小或对齐的请求直接转交上游；析构或 release 时整体归还；非线程安全
+class Pool {
+public:
+  static constexpr size_t s_max_blocks_per_chunk = 4096;
+
+  explicit Pool(size_t blockSize, size_t blockAlign = alignof(std::max_align_t), size_t blocksPerChunk = 32,
+                std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : m_blockAlign(std::max(blockAlign, alignof(_allocator_detail::Link))),
+        m_blockSize(_allocator_detail::alignUp(std::max(blockSize, sizeof(_allocator_detail::Link)), m_blockAlign)),
+        m_initialBlocks(std::max<size_t>(blocksPerChunk, 1)), m_nextBlocks(m_initialBlocks), m_upstream(upstream) {}
+
+  Pool(const Pool&) = delete;
+  Pool& operator=(const Pool&) = delete;
+
+  ~Pool() { release(); }
+
+  /// @brief 分配一个块
+  void* allocate() {
+    if (auto* block = m_free) [[likely]] {
+      m_free = block->next;
+      return block;
+    }
+    if (m_current == m_end) [[unlikely]] allocateChunk();
+    void* block = reinterpret_cast<void*>(m_current);
+    m_current += m_blockSize;
+    return block;
+  }
+
+  /// @brief 归还一个由 allocate() 分配的块
+  void deallocate(void* p) noexcept {
+    auto* block = static_cast<_allocator_detail::Link*>(p);
+    block->next = m_free;
+    m_free = block;
+  }
+
+  void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+    if (bytes > m_blockSize || align > m_blockAlign) [[unlikely]] return m_upstream->allocate(bytes, align);
+    return allocate();
+  }
+
+  void deallocate(void* p, size_t bytes, size_t align = alignof(std::max_align_t)) noexcept {
+    if (bytes > m_blockSize || align > m_blockAlign) [[unlikely]] return m_upstream->deallocate(p, bytes, align);
+    deallocate(p);
+  }
+
+  template <typename T, typename... Args>
+  T* create(Args&&... args) {
+    return play::construct_at(static_cast<T*>(allocate(sizeof(T), alignof(T))), std::forward<Args>(args)...);
+  }
+
+  template <typename T>
+  void destroy(T* p) noexcept {
+    std::destroy_at(p);
+    deallocate(p, sizeof(T), alignof(T));
+  }
+
+  /// @brief 归还全部块；此前分配的块全部失效
+  void release() noexcept {
+    _allocator_detail::releaseChunks(m_chunks, m_upstream, chunkAlign());
+    m_free = nullptr;
+    m_current = m_end = 0;
+    m_nextBlocks = m_initialBlocks;
+  }
+
+  size_t blockSize() const noexcept { return m_blockSize; }
+
+  size_t blockAlign() const noexcept { return m_blockAlign; }
+
+  std::pmr::memory_resource* upstream() const noexcept { return m_upstream; }
+
+private:
+  size_t chunkAlign() const noexcept { return std::max(m_blockAlign, alignof(std::max_align_t)); }
+
+  void allocateChunk() {
+    using _allocator_detail::Chunk;
+    size_t offset = _allocator_detail::alignUp(sizeof(Chunk), m_blockAlign);
+    size_t size = offset + m_nextBlocks * m_blockSize;
+    auto* chunk = static_cast<Chunk*>(m_upstream->allocate(size, chunkAlign()));
+    *chunk = {m_chunks, size};
+    m_chunks = chunk;
+    m_nextBlocks = std::min(m_nextBlocks * 2, s_max_blocks_per_chunk);
+    m_current = reinterpret_cast<uintptr_t>(chunk) + offset;
+    m_end = reinterpret_cast<uintptr_t>(chunk) + size;
+  }
+
+  _allocator_detail::Link* m_free = nullptr;
+  uintptr_t m_current = 0;
+  uintptr_t m_end = 0;
+  _allocator_detail::Chunk* m_chunks = nullptr;
+  size_t m_blockAlign;
+  size_t m_blockSize;
+  size_t m_initialBlocks;
+  size_t m_nextBlocks;
+  std::pmr::memory_resource* m_upstream;
+};
+
+namespace _allocator_detail {
+// 线程缓存池的大小分级：16 字节一级，最大 256 字节，所有块按 16 字节对齐
+inline constexpr size_t k_class_step = 16;
+inline constexpr size_t k_max_size = 256;
+inline constexpr size_t k_classes = k_max_size / k_class_step;
+// 线程缓存与共享池之间每次交换的块数，以及单个分级在线程缓存中的上限
+inline constexpr size_t k_batch = 32;
+inline constexpr size_t k_cache_limit = 2 * k_batch;
+inline constexpr size_t k_central_chunk = 64 << 10;
+
+constexpr size_t sizeClass(size_t bytes) { return bytes == 0 ? 0 : (bytes - 1) / k_class_step; }
+
+// 各线程共享的部分，由互斥锁保护；线程缓存只持有其 weak_ptr，池析构后线程退出时不再归还
+struct Central {
+  explicit Central(std::pmr::memory_resource* upstream) : upstream(upstream) {}
+
+  ~Central() { releaseChunks(chunks, upstream); }
+
+  // 取出至多 k_batch 个块串成链表，返回表头与块数
+  std::pair<Link*, size_t> take(size_t cls) {
+    std::lock_guard lock(mutex);
+    Link* head = free[cls];
+    size_t count = 0;
+    Link* tail = nullptr;
+    for (Link* p = head; p && count < k_batch; p = p->next) {
+      tail = p;
+      ++count;
+    }
+    if (tail) {
+      free[cls] = tail->next;
+      tail->next = nullptr;
+    }
+    // 共享空闲链表不足时从当前块中切分
+    size_t size = (cls + 1) * k_class_step;
+    for (; count < k_batch; ++count) {
+      if (current + size > end) allocateChunk();
+      auto* block = reinterpret_cast<Link*>(current);
+      current += size;
+      block->next = head;
+      head = block;
+    }
+    return {head, count};
+  }
+
+  void give(size_t cls, Link* head, Link* tail) {
+    std::lock_guard lock(mutex);
+    tail->next = free[cls];
+    free[cls] = head;
+  }
+
+  void allocateChunk() {
+    auto* chunk = static_cast<Chunk*>(upstream->allocate(k_central_chunk, alignof(std::max_align_t)));
+    *chunk = {chunks, k_central_chunk};
+    chunks = chunk;
+    current = alignUp(reinterpret_cast<uintptr_t>(chunk + 1), k_class_step);
+    end = reinterpret_cast<uintptr_t>(chunk) + k_central_chunk;
+  }
+
+  std::mutex mutex;
+  Link* free[k_classes] = {};
+  uintptr_t current = 0;
+  uintptr_t end = 0;
+  Chunk* chunks = nullptr;
+  std::pmr::memory_resource* upstream;
+};
+
+// 一个线程在某个池上的缓存
+struct LocalCache {
+  uint64_t id;
+  std::weak_ptr<Central> central;
+  Link* free[k_classes] = {};
+  size_t count[k_classes] = {};
+
+  ~LocalCache() {
+    auto owner = central.lock();
+    if (!owner) return;
+    for (size_t cls = 0; cls < k_classes; ++cls) {
+      if (!free[cls]) continue;
+      Link* tail = free[cls];
+      while (tail->next) tail = tail->next;
+      owner->give(cls, free[cls], tail);
+    }
+  }
+};
+
+// 每个线程的全部缓存，按池的 id 查找；最近使用的一项走快速路径
+struct ThreadCaches {
+  LocalCache& find(uint64_t id, std::shared_ptr<Central> const& central) {
+    for (auto& cache : caches) {
+      if (cache->id == id) return remember(*cache);
+    }
+    // 顺带清理已析构的池留下的缓存，其中的块已随池归还，不能再访问
+    std::erase_if(caches, [](auto const& cache) { return cache->central.expired(); });
+    auto& cache = *caches.emplace_back(new LocalCache{id, central});
+    return remember(cache);
+  }
+
+  LocalCache& remember(LocalCache& cache) {
+    lastId = cache.id;
+    last = &cache;
+    return cache;
+  }
+
+  uint64_t lastId = 0;
+  LocalCache* last = nullptr;
+  std::vector<std::unique_ptr<LocalCache>> caches;
+};
+
+inline ThreadCaches& threadCaches() {
+  thread_local ThreadCaches s_caches;
+  return s_caches;
+}
+} // namespace _allocator_detail
+
+/// @brief 线程安全的小对象池：按 16 字节分级，每个线程持有各级的空闲链表
+/// 分配与释放只访问线程本地缓存，缓存为空或过满时才加锁与共享池批量交换 k_batch 个块；
+/// 在一个线程分配、另一个线程释放的块进入释放方的缓存。超过 256 字节或 16 字节对齐的请求直接转交上游
+class ThreadCachingPool {
+public:
+  explicit ThreadCachingPool(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : m_central(std::make_shared<_allocator_detail::Central>(upstream)), m_id(nextId()) {}
+
+  ThreadCachingPool(const ThreadCachingPool&) = delete;
+  ThreadCachingPool& operator=(const ThreadCachingPool&) = delete;
+
+  void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+    using namespace _allocator_detail;
+    if (bytes > k_max_size || align > k_class_step) [[unlikely]] return m_central->upstream->allocate(bytes, align);
+    auto& cache = localCache();
+    size_t cls = sizeClass(bytes);
+    if (Link* block = cache.free[cls]) [[likely]] {
+      cache.free[cls] = block->next;
+      --cache.count[cls];
+      return block;
+    }
+    auto [head, count] = m_central->take(cls);
+    cache.free[cls] = head->next;
+    cache.count[cls] = count - 1;
+    return head;
+  }
+
+  void deallocate(void* p, size_t bytes, size_t align = alignof(std::max_align_t)) noexcept {
+    using namespace _allocator_detail;
+    if (bytes > k_max_size || align > k_class_step) [[unlikely]] {
+      return m_central->upstream->deallocate(p, bytes, align);
+    }
+    auto& cache = localCache();
+    size_t cls = sizeClass(bytes);
+    auto* block = static_cast<Link*>(p);
+    block->next = cache.free[cls];
+    cache.free[cls] = block;
+    if (++cache.count[cls] > k_cache_limit) [[unlikely]] {
+      // 归还最近释放的 k_batch 个块，保留较早的一半
+      Link* tail = block;
+      for (size_t i = 1; i < k_batch; ++i) tail = tail->next;
+      cache.free[cls] = tail->next;
+      cache.count[cls] -= k_batch;
+      m_central->give(cls, block, tail);
+    }
+  }
+
+  template <typename T, typename... Args>
+  T* create(Args&&... args) {
+    return play::construct_at(static_cast<T*>(allocate(sizeof(T), alignof(T))), std::forward<Args>(args)...);
+  }
+
+  template <typename T>
+  void destroy(T* p) noexcept {
+    std::destroy_at(p);
+    deallocate(p, sizeof(T), alignof(T));
+  }
+
+  std::pmr::memory_resource* upstream() const noexcept { return m_central->upstream; }
+
+private:
+  static uint64_t nextId() {
+    static std::atomic<uint64_t> s_id{0};
+    return ++s_id;
+  }
+
+  _allocator_detail::LocalCache& localCache() {
+    auto& caches = _allocator_detail::threadCaches();
+    if (caches.lastId == m_id) [[likely]] return *caches.last;
+    return caches.find(m_id, m_central);
+  }
+
+  std::shared_ptr<_allocator_detail::Central> m_central;
+  uint64_t m_id;
+};
+
+/// @brief 把 Arena、Pool、ThreadCachingPool 适配为 std::pmr::memory_resource，不持有被适配的分配器
+template <typename Alloc>
+class MemoryResource : public std::pmr::memory_resource {
+public:
+  explicit MemoryResource(Alloc& alloc) noexcept : m_alloc(&alloc) {}
+
+  Alloc& get() const noexcept { return *m_alloc; }
+
+private:
+  void* do_allocate(size_t bytes, size_t align) override { return m_alloc->allocate(bytes, align); }
+
+  void do_deallocate(void* p, size_t bytes, size_t align) override { m_alloc->deallocate(p, bytes, align); }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    auto* rhs = dynamic_cast<const MemoryResource*>(&other);
+    return rhs && rhs->m_alloc == m_alloc;
+  }
+
+  Alloc* m_alloc;
+};
+} // namespace play
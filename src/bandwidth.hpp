@@ -0,0 +1,292 @@
+#pragma once
+
+// 访存带宽内核：fill / copy / triad（STREAM 中的 a[i] = b[i] + s * c[i]）
+// - Store::NonTemporal 使用绕过缓存的流式写（movntps），适合远大于 LLC 的缓冲区：省去写分配（RFO）的读流量，
+//   也不会把有用的数据挤出缓存；对能放进缓存的缓冲区反而更慢
+// - parallel* 版本把缓冲区切块交给多个线程，单线程往往无法跑满 DRAM 带宽
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "simd.hpp"
+
+namespace play::bandwidth {
+// 没有 SIMD 内核的平台上 NonTemporal 退化为普通写
+enum class Store { Regular, NonTemporal };
+
+template <typename R>
+concept stream_range = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+                       (std::is_same_v<std::ranges::range_value_t<R>, float> ||
+                        std::is_same_v<std::ranges::range_value_t<R>, double>);
+
+namespace _bandwidth_detail {
+template <typename T>
+void scalarFill(T* dst, size_t n, T value) {
+  for (size_t i = 0; i < n; ++i) dst[i] = value;
+}
+
+template <typename T>
+void scalarCopy(T* dst, const T* src, size_t n) {
+  if (n > 0) std::memcpy(dst, src, n * sizeof(T));
+}
+
+template <typename T>
+void scalarTriad(T* a, const T* b, const T* c, T scalar, size_t n) {
+  for (size_t i = 0; i < n; ++i) a[i] = b[i] + scalar * c[i];
+}
+
+#ifdef PLAY_X86_SIMD
+// 流式写要求目标按向量宽度对齐；以内联汇编而非 intrinsic 实现，使内核主体不必带 target 属性
+#define PLAY_STREAM_STORE(Bytes, ptr, v)                                   \
+  do {                                                                     \
+    using V_ = std::remove_cv_t<decltype(v)>;                              \
+    if constexpr (Bytes == 16) {                                           \
+      asm("movntps %1, %0" : "=m"(*reinterpret_cast<V_*>(ptr)) : "x"(v));  \
+    } else {                                                               \
+      asm("vmovntps %1, %0" : "=m"(*reinterpret_cast<V_*>(ptr)) : "v"(v)); \
+    }                                                                      \
+  } while (0)
+
+// 流式写之前先用普通写处理到对齐边界，返回对齐处的下标
+template <typename T, size_t Bytes>
+[[gnu::always_inline]] inline size_t alignedStart(const T* dst, size_t n) {
+  size_t misalign = reinterpret_cast<uintptr_t>(dst) % Bytes;
+  if (misalign == 0) return 0;
+  return std::min(n, (Bytes - misalign) / sizeof(T));
+}
+
+template <typename T, size_t Bytes, bool nt>
+[[gnu::always_inline]] inline void simdFill(T* dst, size_t n, T value) {
+  using V = simd_t<T, Bytes>;
+  constexpr size_t W = Bytes / sizeof(T);
+  const V v = V{} + value;
+
+  size_t i = nt ? alignedStart<T, Bytes>(dst, n) : 0;
+  scalarFill(dst, i, value);
+  for (; i + W <= n; i += W) {
+    if constexpr (nt) {
+      PLAY_STREAM_STORE(Bytes, dst + i, v);
+    } else {
+      std::memcpy(dst + i, &v, sizeof(V));
+    }
+  }
+  scalarFill(dst + i, n - i, value);
+  if constexpr (nt) asm volatile("sfence" ::: "memory");
+}
+
+template <typename T, size_t Bytes, bool nt>
+[[gnu::always_inline]] inline void simdCopy(T* dst, const T* src, size_t n) {
+  using V = simd_t<T, Bytes>;
+  constexpr size_t W = Bytes / sizeof(T);
+
+  size_t i = nt ? alignedStart<T, Bytes>(dst, n) : 0;
+  scalarCopy(dst, src, i);
+  for (; i + W <= n; i += W) {
+    V v;
+    std::memcpy(&v, src + i, sizeof(V));
+    if constexpr (nt) {
+      PLAY_STREAM_STORE(Bytes, dst + i, v);
+    } else {
+      std::memcpy(dst + i, &v, sizeof(V));
+    }
+  }
+  scalarCopy(dst + i, src + i, n - i);
+  if constexpr (nt) asm volatile("sfence" ::: "memory");
+}
+
+template <typename T, size_t Bytes, bool nt>
+[[gnu::always_inline]] inline void simdTriad(T* a, const T* b, const T* c, T scalar, size_t n) {
+  using V = simd_t<T, Bytes>;
+  constexpr size_t W = Bytes / sizeof(T);
+  const V s = V{} + scalar;
+
+  size_t i = nt ? alignedStart<T, Bytes>(a, n) : 0;
+  scalarTriad(a, b, c, scalar, i);
+  for (; i + W <= n; i += W) {
+    V x, y;
+    std::memcpy(&x, b + i, sizeof(V));
+    std::memcpy(&y, c + i, sizeof(V));
+    V r = x + s * y;
+    if constexpr (nt) {
+      PLAY_STREAM_STORE(Bytes, a + i, r);
+    } else {
+      std::memcpy(a + i, &r, sizeof(V));
+    }
+  }
+  scalarTriad(a + i, b + i, c + i, scalar, n - i);
+  if constexpr (nt) asm volatile("sfence" ::: "memory");
+}
+
+#undef PLAY_STREAM_STORE
+
+#define PLAY_BANDWIDTH_DEFINE_ISA(Name, isa, bytes)                                                    \
+  struct Name {                                                                                        \
+    template <bool nt, typename T>                                                                     \
+    __attribute__((target(isa))) static void fill(T* dst, size_t n, T value) {                         \
+      simdFill<T, bytes, nt>(dst, n, value);                                                           \
+    }                                                                                                  \
+                                                                                                       \
+    template <bool nt, typename T>                                                                     \
+    __attribute__((target(isa))) static void copy(T* dst, const T* src, size_t n) {                    \
+      simdCopy<T, bytes, nt>(dst, src, n);                                                             \
+    }                                                                                                  \
+                                                                                                       \
+    template <bool nt, typename T>                                                                     \
+    __attribute__((target(isa))) static void triad(T* a, const T* b, const T* c, T scalar, size_t n) { \
+      simdTriad<T, bytes, nt>(a, b, c, scalar, n);                                                     \
+    }                                                                                                  \
+  };
+
+PLAY_BANDWIDTH_DEFINE_ISA(SseKernels, "sse2", 16)
+PLAY_BANDWIDTH_DEFINE_ISA(Avx2Kernels, "avx2", 32)
+PLAY_BANDWIDTH_DEFINE_ISA(Avx512Kernels, "avx512f", 64)
+
+#undef PLAY_BANDWIDTH_DEFINE_ISA
+#endif
+
+// 按指令集与写入方式选出内核的函数指针，call 为 XxxKernels 的成员模板名
+#ifdef PLAY_X86_SIMD
+#define PLAY_BANDWIDTH_DISPATCH(isa, store, call, scalar_call)                                           \
+  switch (resolveIsa(isa)) {                                                                             \
+    case Isa::AVX512:                                                                                    \
+      return store == Store::NonTemporal ? Avx512Kernels::call<true, T> : Avx512Kernels::call<false, T>; \
+    case Isa::AVX2:                                                                                      \
+      return store == Store::NonTemporal ? Avx2Kernels::call<true, T> : Avx2Kernels::call<false, T>;     \
+    case Isa::SSE:                                                                                       \
+      return store == Store::NonTemporal ? SseKernels::call<true, T> : SseKernels::call<false, T>;       \
+    default:                                                                                             \
+      return scalar_call;                                                                                \
+  }
+#else
+#define PLAY_BANDWIDTH_DISPATCH(isa, store, call, scalar_call) return scalar_call;
+#endif
+
+template <typename T>
+auto fillKernel(Isa isa, Store store) -> void (*)(T*, size_t, T) {
+  PLAY_BANDWIDTH_DISPATCH(isa, store, template fill, &scalarFill<T>)
+}
+
+template <typename T>
+auto copyKernel(Isa isa, Store store) -> void (*)(T*, const T*, size_t) {
+  PLAY_BANDWIDTH_DISPATCH(isa, store, template copy, &scalarCopy<T>)
+}
+
+template <typename T>
+auto triadKernel(Isa isa, Store store) -> void (*)(T*, const T*, const T*, T, size_t) {
+  PLAY_BANDWIDTH_DISPATCH(isa, store, template triad, &scalarTriad<T>)
+}
+
+#undef PLAY_BANDWIDTH_DISPATCH
+
+// 每个线程至少处理的字节数
+inline constexpr size_t k_parallel_grain_bytes = size_t(1) << 20;
+
+// 把 [0, n) 切块后并行执行 f(begin, end)，块边界按 4 KiB 对齐以免相邻线程写同一缓存行/页
+template <typename T, typename F>
+void parallelFor(size_t n, unsigned threads, F&& f) {
+  size_t max_threads = n * sizeof(T) / k_parallel_grain_bytes;
+  if (max_threads < 2) return f(size_t(0), n);
+  static const unsigned s_hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+  if (threads == 0) threads = s_hardware_threads;
+  threads = static_cast<unsigned>(std::min<size_t>(threads, max_threads));
+  if (threads <= 1) return f(size_t(0), n);
+
+  constexpr size_t k_align = 4096 / sizeof(T);
+  size_t chunk = (n / threads + k_align - 1) / k_align * k_align;
+  auto work = [&](unsigned t) {
+    size_t begin = std::min(n, t * chunk);
+    size_t end = t + 1 == threads ? n : std::min(n, begin + chunk);
+    f(begin, end);
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (unsigned t = 1; t < threads; ++t) workers.emplace_back(work, t);
+  work(0);
+  for (auto& worker : workers) worker.join();
+}
+
+template <typename... Rs>
+void checkSizes(const char* what, size_t n, Rs const&... rs) {
+  if (((std::ranges::size(rs) != n) || ...)) throw std::invalid_argument(what);
+}
+
+template <stream_range R>
+using value_t = std::ranges::range_value_t<R>;
+} // namespace _bandwidth_detail
+
+/// @brief 把 dst 的每个元素置为 value
+template <stream_range R>
+void fill(R&& dst, _bandwidth_detail::value_t<R> value, Store store = Store::Regular, Isa isa = Isa::Auto) {
+  _bandwidth_detail::fillKernel<_bandwidth_detail::value_t<R>>(isa, store)(std::ranges::data(dst),
+                                                                          std::ranges::size(dst), value);
+}
+
+/// @brief 把 src 复制到 dst，长度不同时抛出 std::invalid_argument
+template <stream_range R1, stream_range R2>
+  requires std::is_same_v<_bandwidth_detail::value_t<R1>, _bandwidth_detail::value_t<R2>>
+void copy(R1&& dst, R2 const& src, Store store = Store::Regular, Isa isa = Isa::Auto) {
+  size_t n = std::ranges::size(dst);
+  _bandwidth_detail::checkSizes("play::bandwidth::copy: size mismatch", n, src);
+  _bandwidth_detail::copyKernel<_bandwidth_detail::value_t<R1>>(isa, store)(std::ranges::data(dst),
+                                                                           std::ranges::data(src), n);
+}
+
+/// @brief a[i] = b[i] + scalar * c[i]，长度不同时抛出 std::invalid_argument
+template <stream_range R1, stream_range R2, stream_range R3>
+  requires std::is_same_v<_bandwidth_detail::value_t<R1>, _bandwidth_detail::value_t<R2>> &&
+           std::is_same_v<_bandwidth_detail::value_t<R1>, _bandwidth_detail::value_t<R3>>
+void triad(R1&& a, R2 const& b, R3 const& c, _bandwidth_detail::value_t<R1> scalar, Store store = Store::Regular,
+           Isa isa = Isa::Auto) {
+  size_t n = std::ranges::size(a);
+  _bandwidth_detail::checkSizes("play::bandwidth::triad: size mismatch", n, b, c);
+  _bandwidth_detail::triadKernel<_bandwidth_detail::value_t<R1>>(isa, store)(
+      std::ranges::data(a), std::ranges::data(b), std::ranges::data(c), scalar, n);
+}
+
+/// @brief 多线程 fill，threads 为 0 时使用硬件线程数；小缓冲区直接在当前线程完成
+template <stream_range R>
+void parallelFill(R&& dst, _bandwidth_detail::value_t<R> value, unsigned threads = 0, Store store = Store::Regular,
+                  Isa isa = Isa::Auto) {
+  using T = _bandwidth_detail::value_t<R>;
+  auto kernel = _bandwidth_detail::fillKernel<T>(isa, store);
+  T* p = std::ranges::data(dst);
+  _bandwidth_detail::parallelFor<T>(std::ranges::size(dst), threads,
+                                    [&](size_t begin, size_t end) { kernel(p + begin, end - begin, value); });
+}
+
+template <stream_range R1, stream_range R2>
+  requires std::is_same_v<_bandwidth_detail::value_t<R1>, _bandwidth_detail::value_t<R2>>
+void parallelCopy(R1&& dst, R2 const& src, unsigned threads = 0, Store store = Store::Regular, Isa isa = Isa::Auto) {
+  using T = _bandwidth_detail::value_t<R1>;
+  size_t n = std::ranges::size(dst);
+  _bandwidth_detail::checkSizes("play::bandwidth::parallelCopy: size mismatch", n, src);
+  auto kernel = _bandwidth_detail::copyKernel<T>(isa, store);
+  T* d = std::ranges::data(dst);
+  const T* s = std::ranges::data(src);
+  _bandwidth_detail::parallelFor<T>(n, threads,
+                                    [&](size_t begin, size_t end) { kernel(d + begin, s + begin, end - begin); });
+}
+
+template <stream_range R1, stream_range R2, stream_range R3>
+  requires std::is_same_v<_bandwidth_detail::value_t<R1>, _bandwidth_detail::value_t<R2>> &&
+           std::is_same_v<_bandwidth_detail::value_t<R1>, _bandwidth_detail::value_t<R3>>
+void parallelTriad(R1&& a, R2 const& b, R3 const& c, _bandwidth_detail::value_t<R1> scalar, unsigned threads = 0,
+                   Store store = Store::Regular, Isa isa = Isa::Auto) {
+  using T = _bandwidth_detail::value_t<R1>;
+  size_t n = std::ranges::size(a);
+  _bandwidth_detail::checkSizes("play::bandwidth::parallelTriad: size mismatch", n, b, c);
+  auto kernel = _bandwidth_detail::triadKernel<T>(isa, store);
+  T* pa = std::ranges::data(a);
+  const T *pb = std::ranges::data(b), *pc = std::ranges::data(c);
+  _bandwidth_detail::parallelFor<T>(n, threads, [&](size_t begin, size_t end) {
+    kernel(pa + begin, pb + begin, pc + begin, scalar, end - begin);
+  });
+}
+} // namespace play::bandwidth
@@ -1,8 +1,15 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <type_traits>
-#if defined(__GUNC__) || defined(__clang__)
+#include <typeinfo>
+#if defined(__GNUC__) || defined(__clang__)
 #include <cstdlib>
 #include <cxxabi.h>
 #endif
@@ -11,7 +18,7 @@ namespace play {
 
 // 将 abi 标识符转换为源码标识符
 inline std::string demangleAbiToken(const char* token) {
-#if defined(__GUNC__) || defined(__clang__)
+#if defined(__GNUC__) || defined(__clang__)
   char* cp = abi::__cxa_demangle(token, NULL, NULL, NULL);
   std::string name(cp ? cp : token);
   free(cp);
@@ -21,19 +28,141 @@ inline std::string demangleAbiToken(const char* token) {
   return name;
 }
 
-/// @brief 获取 T 的真实类型表示
-/// @tparam T
+namespace _demangle_detail {
+// 函数签名中包含模板实参的名字，T 前后的部分对任意 T 都相同
 template <class T>
-std::string demangle() {
-  // 基类型
-  std::string name(demangleAbiToken(typeid(std::remove_cv_t<std::remove_reference_t<T>>).name()));
-  // 追加修饰符
-  if constexpr (std::is_const_v<std::remove_reference_t<T>>) name.append(" const");
-  if constexpr (std::is_volatile_v<std::remove_reference_t<T>>) name.append(" volatile");
-  if constexpr (std::is_lvalue_reference_v<T>) name.append(" &");
-  if constexpr (std::is_rvalue_reference_v<T>) name.append(" &&");
+constexpr std::string_view signature() {
+#if defined(__clang__) || defined(__GNUC__)
+  return __PRETTY_FUNCTION__;
+#elif defined(_MSC_VER)
+  return __FUNCSIG__;
+#else
+  return "";
+#endif
+}
 
-  return name;
+// 用已知的 int 定位 T 在签名中的起止位置
+inline constexpr std::string_view k_probe = signature<int>();
+inline constexpr size_t k_prefix = k_probe.find("int");
+inline constexpr size_t k_suffix = k_prefix == std::string_view::npos ? 0 : k_probe.size() - k_prefix - 3;
+
+template <class T>
+constexpr std::string_view extractTypeName() {
+  if constexpr (k_prefix == std::string_view::npos) {
+    return "unknown";
+  } else {
+    constexpr std::string_view sig = signature<T>();
+    return sig.substr(k_prefix, sig.size() - k_prefix - k_suffix);
+  }
+}
+
+// 只保留类型名本身（以 '\0' 结尾），不必把整个函数签名留在只读数据段中
+template <class T>
+struct type_name_storage {
+  static constexpr std::string_view s_view = extractTypeName<T>();
+  static constexpr auto s_value = [] {
+    std::array<char, s_view.size() + 1> res{};
+    for (size_t i = 0; i < s_view.size(); ++i) res[i] = s_view[i];
+    return res;
+  }();
+};
+
+// 以 type_info 为键的无锁缓存：开放寻址的散列表，槽位一经写入不再修改，表满时串接一张两倍大小的新表
+// 名字在首次查询时解析，与散列表一样保存至进程退出
+struct DemangleSlot {
+  std::atomic<const std::type_info*> key{nullptr};
+  std::atomic<const char*> name{nullptr};
+};
+
+struct DemangleTable {
+  static constexpr size_t s_max_probes = 16;
+
+  explicit DemangleTable(size_t capacity) : capacity(capacity), slots(new DemangleSlot[capacity]) {}
+
+  ~DemangleTable() {
+    for (size_t i = 0; i < capacity; ++i) delete[] slots[i].name.load(std::memory_order_relaxed);
+    delete next.load(std::memory_order_relaxed);
+  }
+
+  size_t capacity;
+  std::unique_ptr<DemangleSlot[]> slots;
+  std::atomic<DemangleTable*> next{nullptr};
+};
+
+inline const char* copyName(const std::string& name) {
+  char* res = new char[name.size() + 1];
+  std::memcpy(res, name.c_str(), name.size() + 1);
+  return res;
+}
+
+inline std::string_view cachedDemangle(const std::type_info& ti) {
+  // 不析构，其它静态对象析构时仍可使用
+  static DemangleTable* const s_table = new DemangleTable(256);
+  // hash_code() 每次都对名字求散列，这里改用对象地址；同一类型在不同动态库中的多个 type_info 会各占一个槽位
+  uint64_t hash = (reinterpret_cast<uintptr_t>(&ti) >> 4) * 0x9e3779b97f4a7c15ull;
+  hash ^= hash >> 32;
+  const char* name = nullptr;
+  for (DemangleTable* table = s_table;;) {
+    for (size_t probe = 0; probe < DemangleTable::s_max_probes; ++probe) {
+      auto& slot = table->slots[(hash + probe) & (table->capacity - 1)];
+      const std::type_info* key = slot.key.load(std::memory_order_acquire);
+      if (!key) {
+        // 先在槽位外解析，占到槽位后再发布名字；其它线程在这段极短的间隙内自旋等待
+        if (!name) name = copyName(demangleAbiToken(ti.name()));
+        if (slot.key.compare_exchange_strong(key, &ti, std::memory_order_acq_rel)) {
+          slot.name.store(name, std::memory_order_release);
+          return name;
+        }
+      }
+      if (key == &ti || *key == ti) {
+        // 与其它线程同时解析了同一个类型，丢弃自己的结果
+        delete[] name;
+        const char* res;
+        while (!(res = slot.name.load(std::memory_order_acquire))) {
+        }
+        return res;
+      }
+    }
+    DemangleTable* next = table->next.load(std::memory_order_acquire);
+    if (!next) {
+      auto* fresh = new DemangleTable(table->capacity * 2);
+      if (table->next.compare_exchange_strong(next, fresh, std::memory_order_acq_rel)) {
+        next = fresh;
+      } else {
+        delete fresh;
+      }
+    }
+    table = next;
+  }
+}
+} // namespace _demangle_detail
+
+/// @brief 编译期得到 T 的类型名（含 cv 与引用修饰），无运行时开销；格式由编译器决定，如 GCC 下 std::string 为
+/// std::__cxx11::basic_string<char>，不一定与 demangle 的结果一致
+template <class T>
+constexpr std::string_view typeName() {
+  using Storage = _demangle_detail::type_name_storage<T>;
+  return {Storage::s_value.data(), Storage::s_view.size()};
+}
+
+/// @brief 运行时类型的源码名字，同一类型只解析一次，此后查表返回；线程安全且不加锁，返回的视图在进程内始终有效
+inline std::string_view demangle(const std::type_info& ti) { return _demangle_detail::cachedDemangle(ti); }
+
+/// @brief 获取 T 的真实类型表示，结果按 T 缓存，返回的引用在进程内始终有效
+/// @tparam T
+template <class T>
+const std::string& demangle() {
+  static const std::string s_name = [] {
+    // 基类型
+    std::string name(demangle(typeid(std::remove_cv_t<std::remove_reference_t<T>>)));
+    // 追加修饰符
+    if constexpr (std::is_const_v<std::remove_reference_t<T>>) name.append(" const");
+    if constexpr (std::is_volatile_v<std::remove_reference_t<T>>) name.append(" volatile");
+    if constexpr (std::is_lvalue_reference_v<T>) name.append(" &");
+    if constexpr (std::is_rvalue_reference_v<T>) name.append(" &&");
+    return name;
+  }();
+  return s_name;
 }
 
 } // namespace play
@@ -0,0 +1,657 @@
+#pragma once
+
+// 开放寻址的扁平哈希表（SwissTable 风格）：元素直接存放在槽数组中，另有一个控制字节数组
+// - 控制字节：空槽为 0x80，有元素的槽为哈希值的低 7 位（h2），查找时一次比较 16 个控制字节，只对 h2 相同的槽比较键
+// - 线性探测：从 h1 & mask 开始以 16 个槽为一个窗口向后查找，窗口中出现空槽即可判定不存在；
+//   控制字节数组末尾复制了开头的 15 个字节，从任意位置起都能一次读入 16 个字节
+// - 删除时把同一簇中后面的元素前移填补空位（backward shift），不留墓碑，查找与插入的探测长度不随删除次数增长
+// - value_type 为 std::pair<const K, V>，与 std::unordered_map 相同，print.hpp 按 map 输出，print_parse.hpp 可解析
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "simd.hpp"
+#include "std/memory.hpp"
+#include "std/relocate.hpp"
+
+#if defined(PLAY_X86_SIMD) && defined(__SSE2__)
+#define PLAY_FLAT_HASH_SSE2
+#endif
+
+namespace play {
+/// @brief FlatHashMap 默认的哈希：字符串类的键可以直接用 std::string_view、const char* 查找而不构造 std::string
+template <typename K>
+struct FlatHash : std::hash<K> {};
+
+template <>
+struct FlatHash<std::string> {
+  using is_transparent = void;
+
+  size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>()(s); }
+};
+
+template <>
+struct FlatHash<std::string_view> : FlatHash<std::string> {};
+
+namespace _flat_hash_detail {
+inline constexpr size_t k_group = 16;
+inline constexpr int8_t k_empty = -128;
+
+inline constexpr size_t k_min_capacity = 16;
+
+// 最大负载因子 3/4：线性探测的簇长随负载急剧增长，删除时前移元素需要重新计算其哈希值
+constexpr size_t maxLoad(size_t capacity) noexcept { return capacity - capacity / 4; }
+
+// std::hash 对整数是恒等映射，低位与高位都要可用，先乘法混合一次
+inline uint64_t mixHash(uint64_t h) noexcept {
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 m = static_cast<unsigned __int128>(h) * 0x9e3779b97f4a7c15ull;
+  return static_cast<uint64_t>(m >> 64) ^ static_cast<uint64_t>(m);
+#else
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  return h ^ (h >> 33);
+#endif
+}
+
+// 从某个位置起的 16 个控制字节，各种匹配结果以位掩码表示，第 i 位对应第 i 个字节
+class Group {
+public:
+  explicit Group(const int8_t* ctrl) noexcept {
+#ifdef PLAY_FLAT_HASH_SSE2
+    std::memcpy(&m_bytes, ctrl, sizeof(m_bytes));
+#else
+    std::memcpy(m_bytes, ctrl, sizeof(m_bytes));
+#endif
+  }
+
+  unsigned match(int8_t h2) const noexcept {
+#ifdef PLAY_FLAT_HASH_SSE2
+    return static_cast<unsigned>(__builtin_ia32_pmovmskb128(m_bytes == Bytes{} + h2));
+#else
+    unsigned res = 0;
+    for (size_t i = 0; i < k_group; ++i) res |= unsigned(m_bytes[i] == h2) << i;
+    return res;
+#endif
+  }
+
+  // 只有空槽的最高位为 1
+  unsigned matchEmpty() const noexcept {
+#ifdef PLAY_FLAT_HASH_SSE2
+    return static_cast<unsigned>(__builtin_ia32_pmovmskb128(m_bytes));
+#else
+    unsigned res = 0;
+    for (size_t i = 0; i < k_group; ++i) res |= unsigned(m_bytes[i] < 0) << i;
+    return res;
+#endif
+  }
+
+  unsigned matchFull() const noexcept { return ~matchEmpty() & 0xffffu; }
+
+private:
+#ifdef PLAY_FLAT_HASH_SSE2
+  using Bytes = simd_t<char, k_group>;
+  Bytes m_bytes;
+#else
+  int8_t m_bytes[k_group];
+#endif
+};
+
+template <typename Hash, typename KeyEqual>
+inline constexpr bool s_transparent = requires {
+  typename Hash::is_transparent;
+  typename KeyEqual::is_transparent;
+};
+} // namespace _flat_hash_detail
+
+/// @brief 开放寻址的哈希表，接口与 std::unordered_map 基本一致
+/// 与 std::unordered_map 不同：插入（扩容）与删除都会移动元素，迭代器、指针与引用在任何修改后都失效，
+/// 因而要求 K 与 V 的移动构造不抛出异常（元素可平凡迁移时按字节搬移，不调用移动构造）；
+/// 按迭代器删除不返回迭代器，遍历中删除使用 erase_if；
+/// Hash 与 KeyEqual 都有 is_transparent 时（如默认的字符串键）find/contains/count/at/erase/try_emplace 接受异构的键
+template <typename K, typename V, typename Hash = FlatHash<K>, typename KeyEqual = std::equal_to<>>
+class FlatHashMap {
+  // 扩容与删除逐个搬移元素，中途抛出异常时无法恢复已搬移的槽位
+  static_assert(is_trivially_relocatable_v<std::pair<const K, V>> ||
+                    (std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>),
+                "FlatHashMap requires nothrow move constructible K and V");
+
+  using Group = _flat_hash_detail::Group;
+
+  template <typename Q>
+  static constexpr bool s_key_like =
+      std::is_same_v<std::remove_cvref_t<Q>, K> || _flat_hash_detail::s_transparent<Hash, KeyEqual>;
+
+public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<const K, V>;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+
+private:
+  // 只提供存储，元素的构造与析构由控制字节决定
+  union Slot {
+    Slot() {}
+    ~Slot() {}
+
+    value_type value;
+  };
+
+  template <bool is_const>
+  class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FlatHashMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<is_const, const value_type&, value_type&>;
+    using pointer = std::conditional_t<is_const, const value_type*, value_type*>;
+
+    Iterator() = default;
+
+    operator Iterator<true>() const noexcept
+      requires(!is_const)
+    {
+      return Iterator<true>(m_ctrl, m_slot, m_end);
+    }
+
+    reference operator*() const noexcept { return m_slot->value; }
+
+    pointer operator->() const noexcept { return &m_slot->value; }
+
+    Iterator& operator++() noexcept {
+      ++m_ctrl;
+      ++m_slot;
+      skipEmpty();
+      return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+      Iterator res = *this;
+      ++*this;
+      return res;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.m_ctrl == rhs.m_ctrl; }
+
+  private:
+    friend class FlatHashMap;
+    template <bool>
+    friend class Iterator;
+
+    using SlotPtr = std::conditional_t<is_const, const Slot*, Slot*>;
+
+    Iterator(const int8_t* ctrl, SlotPtr slot, const int8_t* end) noexcept : m_ctrl(ctrl), m_slot(slot), m_end(end) {}
+
+    // 一次跳过 16 个控制字节中的空槽；越过末尾（读到复制的控制字节）时停在 end
+    void skipEmpty() noexcept {
+      while (m_ctrl < m_end) {
+        if (unsigned full = Group(m_ctrl).matchFull()) {
+          auto offset = static_cast<size_t>(__builtin_ctz(full));
+          m_ctrl += offset;
+          m_slot += offset;
+          break;
+        }
+        m_ctrl += _flat_hash_detail::k_group;
+        m_slot += _flat_hash_detail::k_group;
+      }
+      if (m_ctrl > m_end) {
+        m_slot -= m_ctrl - m_end;
+        m_ctrl = m_end;
+      }
+    }
+
+    const int8_t* m_ctrl = nullptr;
+    SlotPtr m_slot = nullptr;
+    const int8_t* m_end = nullptr;
+  };
+
+public:
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  FlatHashMap() = default;
+
+  explicit FlatHashMap(size_t capacity, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+      : m_hash(hash), m_equal(equal) {
+    if (capacity) reserve(capacity);
+  }
+
+  FlatHashMap(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+  template <std::input_iterator It>
+  FlatHashMap(It first, It last) {
+    insert(first, last);
+  }
+
+  // 容量与控制字节原样复制，元素在相同的槽中拷贝构造，不需要重新计算哈希
+  FlatHashMap(const FlatHashMap& rhs) : m_hash(rhs.m_hash), m_equal(rhs.m_equal) {
+    if (rhs.m_size == 0) return;
+    allocate(rhs.m_capacity);
+    try {
+      for (size_t i = 0; i < m_capacity; ++i) {
+        if (rhs.m_ctrl[i] != _flat_hash_detail::k_empty) {
+          play::construct_at(&m_slots[i].value, rhs.m_slots[i].value);
+          m_ctrl[i] = rhs.m_ctrl[i];
+        }
+      }
+    } catch (...) {
+      destroyAll();
+      deallocate();
+      throw;
+    }
+    std::memcpy(m_ctrl, rhs.m_ctrl, ctrlBytes(m_capacity));
+    m_size = rhs.m_size;
+  }
+
+  FlatHashMap(FlatHashMap&& rhs) noexcept
+      : m_hash(std::move(rhs.m_hash)), m_equal(std::move(rhs.m_equal)), m_ctrl(std::exchange(rhs.m_ctrl, nullptr)),
+        m_slots(std::exchange(rhs.m_slots, nullptr)), m_size(std::exchange(rhs.m_size, 0)),
+        m_capacity(std::exchange(rhs.m_capacity, 0)) {}
+
+  FlatHashMap& operator=(const FlatHashMap& rhs) {
+    if (this != &rhs) {
+      FlatHashMap tmp(rhs);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  FlatHashMap& operator=(FlatHashMap&& rhs) noexcept {
+    if (this != &rhs) {
+      FlatHashMap tmp(std::move(rhs));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  ~FlatHashMap() {
+    destroyAll();
+    deallocate();
+  }
+
+  iterator begin() noexcept { return makeBegin<iterator>(m_slots); }
+
+  const_iterator begin() const noexcept { return makeBegin<const_iterator>(m_slots); }
+
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(m_ctrl + m_capacity, m_slots + m_capacity, m_ctrl + m_capacity); }
+
+  const_iterator end() const noexcept {
+    return const_iterator(m_ctrl + m_capacity, m_slots + m_capacity, m_ctrl + m_capacity);
+  }
+
+  const_iterator cend() const noexcept { return end(); }
+
+  bool empty() const noexcept { return m_size == 0; }
+
+  size_t size() const noexcept { return m_size; }
+
+  size_t capacity() const noexcept { return m_capacity; }
+
+  float load_factor() const noexcept { return m_capacity ? float(m_size) / float(m_capacity) : 0.0f; }
+
+  hasher hash_function() const { return m_hash; }
+
+  key_equal key_eq() const { return m_equal; }
+
+  /// @brief 保证插入 count 个元素之前不再扩容
+  void reserve(size_t count) {
+    size_t capacity = _flat_hash_detail::k_min_capacity;
+    while (_flat_hash_detail::maxLoad(capacity) < count) capacity *= 2;
+    if (capacity > m_capacity) rehash(capacity);
+  }
+
+  /// @brief 析构所有元素，保留容量
+  void clear() noexcept {
+    destroyAll();
+    if (m_capacity) std::memset(m_ctrl, _flat_hash_detail::k_empty, ctrlBytes(m_capacity));
+    m_size = 0;
+  }
+
+  template <typename Q>
+    requires s_key_like<Q>
+  iterator find(const Q& key) noexcept {
+    size_t i = findIndex(key);
+    return i == m_capacity ? end() : iteratorAt(i);
+  }
+
+  template <typename Q>
+    requires s_key_like<Q>
+  const_iterator find(const Q& key) const noexcept {
+    size_t i = findIndex(key);
+    return i == m_capacity ? end() : const_iterator(m_ctrl + i, m_slots + i, m_ctrl + m_capacity);
+  }
+
+  iterator find(const K& key) noexcept { return find<K>(key); }
+
+  const_iterator find(const K& key) const noexcept { return find<K>(key); }
+
+  template <typename Q>
+    requires s_key_like<Q>
+  bool contains(const Q& key) const noexcept {
+    return findIndex(key) != m_capacity;
+  }
+
+  bool contains(const K& key) const noexcept { return contains<K>(key); }
+
+  template <typename Q>
+    requires s_key_like<Q>
+  size_t count(const Q& key) const noexcept {
+    return contains(key);
+  }
+
+  size_t count(const K& key) const noexcept { return contains<K>(key); }
+
+  template <typename Q>
+    requires s_key_like<Q>
+  V& at(const Q& key) {
+    size_t i = findIndex(key);
+    if (i == m_capacity) throw std::out_of_range("FlatHashMap::at");
+    return m_slots[i].value.second;
+  }
+
+  template <typename Q>
+    requires s_key_like<Q>
+  const V& at(const Q& key) const {
+    size_t i = findIndex(key);
+    if (i == m_capacity) throw std::out_of_range("FlatHashMap::at");
+    return m_slots[i].value.second;
+  }
+
+  V& at(const K& key) { return at<K>(key); }
+
+  const V& at(const K& key) const { return at<K>(key); }
+
+  V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+  V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+  template <typename Q>
+    requires(s_key_like<Q> && !std::is_same_v<std::remove_cvref_t<Q>, K> && std::is_constructible_v<K, Q>)
+  V& operator[](Q&& key) {
+    return try_emplace(std::forward<Q>(key)).first->second;
+  }
+
+  /// @brief 键不存在时以 args 构造值并插入；存在时不做任何事（args 不被移动）。异构的键只在需要插入时才转换为 K
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    return emplaceKey(key, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    return emplaceKey(std::move(key), std::forward<Args>(args)...);
+  }
+
+  template <typename Q, typename... Args>
+    requires(s_key_like<Q> && !std::is_same_v<std::remove_cvref_t<Q>, K> && std::is_constructible_v<K, Q>)
+  std::pair<iterator, bool> try_emplace(Q&& key, Args&&... args) {
+    return emplaceKey(std::forward<Q>(key), std::forward<Args>(args)...);
+  }
+
+  // 先构造出键值对再查找；已存在时丢弃
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    std::pair<K, V> item(std::forward<Args>(args)...);
+    return try_emplace(std::move(item.first), std::move(item.second));
+  }
+
+  std::pair<iterator, bool> insert(const value_type& item) { return try_emplace(item.first, item.second); }
+
+  template <typename P>
+    requires std::is_constructible_v<std::pair<K, V>, P>
+  std::pair<iterator, bool> insert(P&& item) {
+    return emplace(std::forward<P>(item));
+  }
+
+  template <std::input_iterator It>
+  void insert(It first, It last) {
+    if constexpr (std::forward_iterator<It>) reserve(m_size + static_cast<size_t>(std::distance(first, last)));
+    for (; first != last; ++first) insert(*first);
+  }
+
+  void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+  template <typename Q>
+    requires s_key_like<Q>
+  size_t erase(const Q& key) {
+    size_t i = findIndex(key);
+    if (i == m_capacity) return 0;
+    eraseAt(i);
+    return 1;
+  }
+
+  size_t erase(const K& key) { return erase<K>(key); }
+
+  /// @brief 删除 pos 处的元素；与 std::unordered_map 不同，不返回迭代器
+  /// 删除会把簇中后面的元素前移，簇跨越表尾时表头的元素可能被移到表尾，「it = erase(it)」式的遍历会再次访问到它，
+  /// 因而不提供这种写法；遍历中按条件删除使用 erase_if
+  void erase(const_iterator pos) { eraseAt(static_cast<size_t>(pos.m_ctrl - m_ctrl)); }
+
+  void erase(iterator pos) { erase(const_iterator(pos)); }
+
+  /// @brief 删除所有满足 pred 的元素，每个元素恰好判断一次，返回删除的个数
+  /// 从某个空槽之后开始环绕遍历一周，前移只发生在同一簇内、从后往前，已判断过的元素不会被移到尚未遍历的位置
+  template <typename Pred>
+  friend size_t erase_if(FlatHashMap& map, Pred pred) {
+    if (map.m_size == 0) return 0;
+    size_t mask = map.m_capacity - 1;
+    size_t start = 0;
+    while (map.m_ctrl[start] != _flat_hash_detail::k_empty) ++start;
+    size_t erased = 0;
+    for (size_t n = 0; n < map.m_capacity; ++n) {
+      size_t i = (start + 1 + n) & mask;
+      // 删除后 i 处可能换成了簇中的下一个元素，需要再次判断
+      while (map.m_ctrl[i] != _flat_hash_detail::k_empty && pred(std::as_const(map.m_slots[i].value))) {
+        map.eraseAt(i);
+        ++erased;
+      }
+    }
+    return erased;
+  }
+
+  void swap(FlatHashMap& rhs) noexcept {
+    using std::swap;
+    swap(m_hash, rhs.m_hash);
+    swap(m_equal, rhs.m_equal);
+    swap(m_ctrl, rhs.m_ctrl);
+    swap(m_slots, rhs.m_slots);
+    swap(m_size, rhs.m_size);
+    swap(m_capacity, rhs.m_capacity);
+  }
+
+  friend void swap(FlatHashMap& lhs, FlatHashMap& rhs) noexcept { lhs.swap(rhs); }
+
+  friend bool operator==(const FlatHashMap& lhs, const FlatHashMap& rhs)
+    requires requires(const V& v) { v == v; }
+  {
+    if (lhs.m_size != rhs.m_size) return false;
+    for (auto const& [key, value] : lhs) {
+      size_t i = rhs.findIndex(key);
+      if (i == rhs.m_capacity || !(rhs.m_slots[i].value.second == value)) return false;
+    }
+    return true;
+  }
+
+private:
+  static size_t ctrlBytes(size_t capacity) noexcept { return capacity + _flat_hash_detail::k_group - 1; }
+
+  static int8_t h2(uint64_t hash) noexcept { return static_cast<int8_t>(hash & 0x7f); }
+
+  size_t home(uint64_t hash) const noexcept { return static_cast<size_t>(hash >> 7) & (m_capacity - 1); }
+
+  template <typename Q>
+  uint64_t hashOf(const Q& key) const noexcept {
+    return _flat_hash_detail::mixHash(static_cast<uint64_t>(m_hash(key)));
+  }
+
+  template <typename It, typename SlotPtr>
+  It makeBegin(SlotPtr slots) const noexcept {
+    It it(m_ctrl, slots, m_ctrl + m_capacity);
+    if (m_capacity) it.skipEmpty();
+    return it;
+  }
+
+  iterator iteratorAt(size_t i) noexcept { return iterator(m_ctrl + i, m_slots + i, m_ctrl + m_capacity); }
+
+  // 同时写入末尾复制的控制字节
+  void setCtrl(size_t i, int8_t value) noexcept {
+    m_ctrl[i] = value;
+    if (i < _flat_hash_detail::k_group - 1) m_ctrl[m_capacity + i] = value;
+  }
+
+  // 找到时返回 {下标, true}，否则返回 {应当插入的空槽, false}
+  template <typename Q>
+  std::pair<size_t, bool> probe(const Q& key, uint64_t hash) const noexcept {
+    size_t mask = m_capacity - 1;
+    int8_t tag = h2(hash);
+    for (size_t pos = home(hash);; pos = (pos + _flat_hash_detail::k_group) & mask) {
+      Group group(m_ctrl + pos);
+      for (unsigned m = group.match(tag); m; m &= m - 1) {
+        size_t i = (pos + static_cast<size_t>(__builtin_ctz(m))) & mask;
+        if (m_equal(m_slots[i].value.first, key)) return {i, true};
+      }
+      if (unsigned empty = group.matchEmpty()) return {(pos + static_cast<size_t>(__builtin_ctz(empty))) & mask, false};
+    }
+  }
+
+  template <typename Q>
+  size_t findIndex(const Q& key) const noexcept {
+    if (m_size == 0) return m_capacity;
+    auto [i, found] = probe(key, hashOf(key));
+    return found ? i : m_capacity;
+  }
+
+  size_t findEmpty(uint64_t hash) const noexcept {
+    size_t mask = m_capacity - 1;
+    for (size_t pos = home(hash);; pos = (pos + _flat_hash_detail::k_group) & mask) {
+      if (unsigned empty = Group(m_ctrl + pos).matchEmpty()) {
+        return (pos + static_cast<size_t>(__builtin_ctz(empty))) & mask;
+      }
+    }
+  }
+
+  template <typename Q, typename... Args>
+  std::pair<iterator, bool> emplaceKey(Q&& key, Args&&... args) {
+    uint64_t hash = hashOf(key);
+    if (m_capacity) {
+      auto [i, found] = probe(key, hash);
+      if (found) return {iteratorAt(i), false};
+      if (m_size < _flat_hash_detail::maxLoad(m_capacity)) {
+        construct(i, hash, std::forward<Q>(key), std::forward<Args>(args)...);
+        return {iteratorAt(i), true};
+      }
+    }
+    rehash(m_capacity ? m_capacity * 2 : _flat_hash_detail::k_min_capacity);
+    size_t i = findEmpty(hash);
+    construct(i, hash, std::forward<Q>(key), std::forward<Args>(args)...);
+    return {iteratorAt(i), true};
+  }
+
+  template <typename Q, typename... Args>
+  void construct(size_t i, uint64_t hash, Q&& key, Args&&... args) {
+    play::construct_at(&m_slots[i].value, std::piecewise_construct, std::forward_as_tuple(std::forward<Q>(key)),
+                       std::forward_as_tuple(std::forward<Args>(args)...));
+    setCtrl(i, h2(hash));
+    ++m_size;
+  }
+
+  // 把 src 处的元素迁移到未构造的 dest；键是 const 的，不可平凡迁移时移动构造后立即析构源对象
+  static void moveSlot(Slot& src, Slot& dest) noexcept {
+    if constexpr (is_trivially_relocatable_v<value_type>) {
+      play::relocate_at(&src.value, &dest.value);
+    } else {
+      play::construct_at(&dest.value, std::move(const_cast<K&>(src.value.first)), std::move(src.value.second));
+      std::destroy_at(&src.value);
+    }
+  }
+
+  // 线性探测的删除（Knuth 6.4 算法 R）：向后扫描同一簇，家位置不在 (hole, j] 中的元素前移到空位
+  void eraseAt(size_t i) {
+    size_t mask = m_capacity - 1;
+    std::destroy_at(&m_slots[i].value);
+    size_t hole = i;
+    for (size_t j = (i + 1) & mask; m_ctrl[j] != _flat_hash_detail::k_empty; j = (j + 1) & mask) {
+      size_t distance = ((home(hashOf(m_slots[j].value.first)) - hole) & mask) - 1;
+      if (distance < ((j - hole) & mask)) continue;
+      moveSlot(m_slots[j], m_slots[hole]);
+      setCtrl(hole, m_ctrl[j]);
+      hole = j;
+    }
+    setCtrl(hole, _flat_hash_detail::k_empty);
+    --m_size;
+  }
+
+  void allocate(size_t capacity) {
+    m_slots = std::allocator<Slot>().allocate(capacity);
+    try {
+      m_ctrl = std::allocator<int8_t>().allocate(ctrlBytes(capacity));
+    } catch (...) {
+      std::allocator<Slot>().deallocate(m_slots, capacity);
+      m_slots = nullptr;
+      throw;
+    }
+    std::memset(m_ctrl, _flat_hash_detail::k_empty, ctrlBytes(capacity));
+    m_capacity = capacity;
+  }
+
+  void deallocate() noexcept {
+    if (m_capacity == 0) return;
+    std::allocator<Slot>().deallocate(m_slots, m_capacity);
+    std::allocator<int8_t>().deallocate(m_ctrl, ctrlBytes(m_capacity));
+    m_slots = nullptr;
+    m_ctrl = nullptr;
+    m_capacity = 0;
+  }
+
+  void destroyAll() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      for (size_t i = 0; i < m_capacity; ++i) {
+        if (m_ctrl[i] != _flat_hash_detail::k_empty) std::destroy_at(&m_slots[i].value);
+      }
+    }
+  }
+
+  // 迁移到容量为 capacity（2 的幂）的新数组；分配失败时原表不变，此后求哈希与搬移元素都不会抛出异常
+  void rehash(size_t capacity) {
+    FlatHashMap res(0, m_hash, m_equal);
+    res.allocate(capacity);
+    for (size_t i = 0; i < m_capacity; ++i) {
+      if (m_ctrl[i] == _flat_hash_detail::k_empty) continue;
+      uint64_t hash = hashOf(m_slots[i].value.first);
+      size_t j = res.findEmpty(hash);
+      moveSlot(m_slots[i], res.m_slots[j]);
+      res.setCtrl(j, h2(hash));
+      m_ctrl[i] = _flat_hash_detail::k_empty;
+    }
+    res.m_size = std::exchange(m_size, 0);
+    swap(res);
+  }
+
+  [[no_unique_address]] Hash m_hash;
+  [[no_unique_address]] KeyEqual m_equal;
+  int8_t* m_ctrl = nullptr;
+  Slot* m_slots = nullptr;
+  size_t m_size = 0;
+  size_t m_capacity = 0;
+};
+} // namespace play
+
+#undef PLAY_FLAT_HASH_SSE2
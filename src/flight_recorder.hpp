@@ -0,0 +1,308 @@
+#pragma once
+
+// 飞行记录器：所有级别的日志（包括被静音的 Trace/Debug）只把格式串与原始参数按值写入每线程固定大小的环形缓冲区，
+// 不做格式化；仅在致命信号、显式 dump() 或 Error 级别日志时才格式化并写出，平时的开销只是几次内存写入
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "log_level.hpp"
+#include "thread_registry.hpp"
+
+namespace play {
+namespace _flight_detail {
+// 参数按值保存：字符串保存长度与内容（空间不足时截断），算术类型、枚举与其它指针直接复制，其余类型无法按值保存
+template <class T>
+inline constexpr bool k_is_string = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+                                    std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+template <class T>
+inline constexpr bool k_is_value =
+    !k_is_string<T> && (std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T> ||
+                        std::is_null_pointer_v<T>);
+
+template <class T>
+inline constexpr size_t k_fixed_size = k_is_value<T> ? sizeof(T) : sizeof(uint32_t);
+
+// 解码后的参数类型：字符串以指向记录内部的 string_view 给出
+template <class T>
+using Decoded = std::conditional_t<k_is_string<std::decay_t<T>>, std::string_view, std::decay_t<T>>;
+
+// fixedLeft 为其后各参数固定部分的大小，字符串只能使用除此之外的空间
+template <class T>
+void encode(std::byte*& out, std::byte* end, size_t fixedLeft, const T& value) {
+  using U = std::decay_t<T>;
+  if constexpr (k_is_value<U>) {
+    U v = value;
+    std::memcpy(out, &v, sizeof(U));
+    out += sizeof(U);
+  } else {
+    std::string_view s(value);
+    size_t room = static_cast<size_t>(end - out) - sizeof(uint32_t) - fixedLeft;
+    auto n = static_cast<uint32_t>(std::min(s.size(), room));
+    std::memcpy(out, &n, sizeof(n));
+    std::memcpy(out + sizeof(n), s.data(), n);
+    out += sizeof(n) + n;
+  }
+}
+
+template <class T>
+Decoded<T> decodeOne(const std::byte*& in) {
+  using U = std::decay_t<T>;
+  if constexpr (k_is_value<U>) {
+    U v;
+    std::memcpy(&v, in, sizeof(U));
+    in += sizeof(U);
+    return v;
+  } else {
+    uint32_t n;
+    std::memcpy(&n, in, sizeof(n));
+    std::string_view s(reinterpret_cast<const char*>(in + sizeof(n)), n);
+    in += sizeof(n) + n;
+    return s;
+  }
+}
+
+/// @brief 把记录中的参数格式化为消息并追加到 out；由调用方按参数类型实例化（如基于 std::vformat）
+using FormatFn = void (*)(std::string& out, std::string_view fmt, const std::byte* args);
+
+inline constexpr size_t k_slot_size = 256;
+inline constexpr size_t k_args_size = 200;
+inline constexpr size_t k_ring_slots = 512;
+
+// 环形缓冲区中的一条记录；seq 为 0 表示正在写入或从未写入，写完后为（该线程的记录序号 + 1）
+struct alignas(64) Slot {
+  std::atomic<uint64_t> seq{0};
+  int64_t time;
+  const char* file;
+  std::string_view fmt;
+  FormatFn format;
+  uint32_t line;
+  LogLevel level;
+  std::byte args[k_args_size];
+};
+static_assert(sizeof(Slot) == k_slot_size);
+
+// dump 时复制出的记录
+struct Record {
+  int64_t time;
+  const char* file;
+  std::string_view fmt;
+  FormatFn format;
+  uint32_t line;
+  LogLevel level;
+  uint32_t ring;
+  std::byte args[k_args_size];
+};
+
+// 每个线程的环形缓冲区，由 ThreadRegistry 分配；被新线程复用时其中的旧记录仍可被 dump
+struct Ring {
+  explicit Ring(uint32_t id) : id(id) {}
+
+  template <class... Args>
+  void write(LogLevel lv, const std::source_location& loc, std::string_view fmt, FormatFn format,
+             const Args&... args) {
+    uint64_t h = head.load(std::memory_order_relaxed);
+    Slot& slot = slots[h % k_ring_slots];
+    // 顺序锁：先标记为写入中，dump 读到前后不一致的序号时丢弃该记录
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+    slot.file = loc.file_name();
+    slot.line = loc.line();
+    slot.level = lv;
+    slot.fmt = fmt;
+    slot.format = format;
+    std::byte* out = slot.args;
+    size_t fixedLeft = (k_fixed_size<std::decay_t<Args>> + ... + 0);
+    ((fixedLeft -= k_fixed_size<std::decay_t<Args>>, encode(out, slot.args + k_args_size, fixedLeft, args)), ...);
+    slot.seq.store(h + 1, std::memory_order_release);
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  // 把 [max(dumped, head - 容量), head) 中完整的记录追加到 out
+  void collect(std::vector<Record>& out) {
+    uint64_t h = head.load(std::memory_order_acquire);
+    uint64_t begin = std::max(dumped, h > k_ring_slots ? h - k_ring_slots : 0);
+    for (uint64_t i = begin; i < h; ++i) {
+      Slot& slot = slots[i % k_ring_slots];
+      if (slot.seq.load(std::memory_order_acquire) != i + 1) continue;
+      Record& rec = out.emplace_back();
+      rec.time = slot.time;
+      rec.file = slot.file;
+      rec.fmt = slot.fmt;
+      rec.format = slot.format;
+      rec.line = slot.line;
+      rec.level = slot.level;
+      rec.ring = id;
+      std::memcpy(rec.args, slot.args, k_args_size);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.seq.load(std::memory_order_relaxed) != i + 1) out.pop_back();
+    }
+    dumped = h;
+  }
+
+  std::atomic<uint64_t> head{0};
+  uint64_t dumped = 0; // 由 dump 的锁保护
+  uint32_t id;
+  Slot slots[k_ring_slots];
+};
+} // namespace _flight_detail
+
+class FlightRecorder {
+public:
+  using FormatFn = _flight_detail::FormatFn;
+
+  /// @brief 参数能否全部按值保存（字符串会被截断到记录的剩余空间）
+  template <class... Args>
+  static constexpr bool s_capturable =
+      ((_flight_detail::k_is_value<std::decay_t<Args>> || _flight_detail::k_is_string<std::decay_t<Args>>) && ...) &&
+      (_flight_detail::k_fixed_size<std::decay_t<Args>> + ... + 0) <= _flight_detail::k_args_size;
+
+  static FlightRecorder& instance() {
+    static FlightRecorder* const s_recorder = new FlightRecorder;
+    return *s_recorder;
+  }
+
+  FlightRecorder(const FlightRecorder&) = delete;
+  FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+  /// @brief 开启记录并安装致命信号的处理；dump 追加写入 path，为空时写至标准错误
+  void enable(std::string_view path = {}) {
+    {
+      std::lock_guard lock(m_dumpMutex);
+      size_t n = std::min(path.size(), m_path.size() - 1);
+      std::memcpy(m_path.data(), path.data(), n);
+      m_path[n] = '\0';
+    }
+    installSignalHandlers();
+    m_enabled.store(true, std::memory_order_relaxed);
+  }
+
+  bool enabled() const noexcept { return m_enabled.load(std::memory_order_relaxed); }
+
+  /// @brief 记录一条日志：fmt 必须指向静态存储（如字符串字面量），format 在 dump 时以 decode<Args...> 的结果格式化消息
+  template <class... Args>
+  void record(LogLevel lv, const std::source_location& loc, std::string_view fmt, FormatFn format,
+              const Args&... args) {
+    static_assert(s_capturable<Args...>, "arguments cannot be captured by value");
+    m_rings.local().write(lv, loc, fmt, format, args...);
+  }
+
+  /// @brief 把 record 保存的参数还原为 tuple，字符串以 string_view 给出
+  template <class... Args>
+  static std::tuple<_flight_detail::Decoded<Args>...> decode(const std::byte* args) {
+    // 花括号初始化保证从左到右求值
+    return std::tuple<_flight_detail::Decoded<Args>...>{_flight_detail::decodeOne<Args>(args)...};
+  }
+
+  /// @brief 格式化并写出各线程自上次 dump 以来仍在缓冲区中的记录，按时间排序
+  void dump(std::string_view reason = "dump") {
+    std::lock_guard lock(m_dumpMutex);
+    dumpLocked(reason);
+  }
+
+private:
+  using Ring = _flight_detail::Ring;
+  using Record = _flight_detail::Record;
+
+  FlightRecorder() = default;
+
+  void dumpLocked(std::string_view reason) {
+    std::vector<Record> records;
+    m_rings.forEach([&](Ring& ring) { ring.collect(records); });
+    std::stable_sort(records.begin(), records.end(), [](auto const& a, auto const& b) { return a.time < b.time; });
+
+    int fd = m_path[0] ? open(m_path.data(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644) : STDERR_FILENO;
+    if (fd < 0) return;
+    std::string out;
+    out.append("==== flight recorder: ").append(reason).append(" ====\n");
+    for (auto const& rec : records) {
+      appendTime(out, rec.time);
+      out.append(" [").append(getlogLevalName(rec.level)).append("] [t").append(std::to_string(rec.ring));
+      out.append("] ").append(rec.file).append(":").append(std::to_string(rec.line)).append(" ");
+      try {
+        rec.format(out, rec.fmt, rec.args);
+      } catch (...) {
+        out.append("<format error: ").append(rec.fmt).append(">");
+      }
+      out.push_back('\n');
+      if (out.size() >= s_flush_size) flush(fd, out);
+    }
+    flush(fd, out);
+    if (fd != STDERR_FILENO) close(fd);
+  }
+
+  // 与 output_log 相同的「%F %X」，并附上微秒
+  static void appendTime(std::string& out, int64_t ns) {
+    time_t sec = static_cast<time_t>(ns / 1'000'000'000);
+    tm local;
+    localtime_r(&sec, &local);
+    char buf[48];
+    size_t n = strftime(buf, sizeof(buf), "%F %X", &local);
+    n += snprintf(buf + n, sizeof(buf) - n, ".%06ld", static_cast<long>(ns / 1000 % 1'000'000));
+    out.append(buf, n);
+  }
+
+  static void flush(int fd, std::string& out) {
+    for (size_t off = 0; off < out.size();) {
+      ssize_t n = write(fd, out.data() + off, out.size() - off);
+      if (n <= 0) break;
+      off += static_cast<size_t>(n);
+    }
+    out.clear();
+  }
+
+  // 致命信号：尽力写出记录后以默认方式重新处理该信号。格式化会分配内存，并非异步信号安全，只求在崩溃现场尽量留下记录
+  static void onSignal(int sig) {
+    auto& self = instance();
+    // 崩溃的线程可能正持有锁（如在 dump 中崩溃），等待片刻后不再等待
+    bool locked = false;
+    for (int i = 0; i < 100 && !(locked = self.m_dumpMutex.try_lock()); ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    char reason[32];
+    snprintf(reason, sizeof(reason), "signal %d", sig);
+    self.dumpLocked(reason);
+    if (locked) self.m_dumpMutex.unlock();
+    raise(sig);
+  }
+
+  static void installSignalHandlers() {
+    struct sigaction sa{};
+    sa.sa_handler = &onSignal;
+    sigemptyset(&sa.sa_mask);
+    // 处理一次后恢复默认行为，onSignal 中重新发出的信号按默认方式终止进程（并产生 core）
+    sa.sa_flags = SA_RESETHAND;
+    for (int sig : {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT}) sigaction(sig, &sa, nullptr);
+  }
+
+  static constexpr size_t s_flush_size = 1 << 16;
+
+  std::atomic<bool> m_enabled{false};
+  ThreadRegistry<Ring> m_rings;
+  std::mutex m_dumpMutex;
+  std::array<char, 4096> m_path{};
+};
+
+} // namespace play
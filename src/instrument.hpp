@@ -0,0 +1,283 @@
+#pragma once
+
+// 热路径计时：PLAY_SCOPED_TIMER("name") 在作用域结束时把耗时记入本线程、本调用处的对数-线性直方图（HDR 风格），
+// 记录时不加锁、不分配内存（每个线程首次经过某个调用处时除外）；按需汇总各线程的直方图，给出计数与 p50/p90/p99/p999
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <vector>
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+
+#include "preprocessor.hpp"
+#include "thread_registry.hpp"
+
+namespace play {
+namespace _instrument_detail {
+// 时间戳计数：x86-64 上读 TSC（比 steady_clock 便宜数倍），汇总时再按校准出的频率换算为纳秒
+inline uint64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+inline int64_t steadyNs() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// 每个 2 的幂区间再线性分为 2^k_sub_bits 个桶，相对误差约 3%；小于 2^(k_sub_bits + 1) 的值各占一桶
+inline constexpr unsigned k_sub_bits = 5;
+inline constexpr unsigned k_max_bits = 42;
+inline constexpr size_t k_buckets = ((k_max_bits - k_sub_bits) << k_sub_bits) + (size_t(1) << (k_sub_bits + 1));
+
+inline constexpr size_t bucketOf(uint64_t v) noexcept {
+  if (v < (uint64_t(1) << (k_sub_bits + 1))) return static_cast<size_t>(v);
+  unsigned shift = static_cast<unsigned>(std::bit_width(v)) - 1 - k_sub_bits;
+  size_t idx = (size_t(shift) << k_sub_bits) + static_cast<size_t>(v >> shift);
+  return std::min(idx, k_buckets - 1);
+}
+
+// 桶的代表值（区间中点）
+inline constexpr double bucketValue(size_t idx) noexcept {
+  if (idx < (size_t(1) << (k_sub_bits + 1))) return static_cast<double>(idx);
+  unsigned shift = static_cast<unsigned>(idx >> k_sub_bits) - 1;
+  uint64_t low = ((uint64_t(1) << k_sub_bits) + (idx & ((size_t(1) << k_sub_bits) - 1))) << shift;
+  return static_cast<double>(low) + static_cast<double>(uint64_t(1) << shift) / 2;
+}
+static_assert(bucketOf(64) == 64 && bucketOf(127) == 95 && bucketOf(128) == 96);
+
+// 只由所属线程写入：以 load + store 代替 fetch_add，避免带 lock 前缀的指令；汇总线程只做 relaxed 读取
+class Histogram {
+public:
+  void record(uint64_t v) noexcept {
+    bump(m_buckets[bucketOf(v)], 1);
+    bump(m_count, 1);
+    bump(m_sum, v);
+    if (v > m_max.load(std::memory_order_relaxed)) m_max.store(v, std::memory_order_relaxed);
+  }
+
+  // 累加到 out（按桶计数），返回 {count, sum, max}
+  std::array<uint64_t, 3> mergeInto(std::vector<uint64_t>& out) const {
+    for (size_t i = 0; i < k_buckets; ++i) out[i] += m_buckets[i].load(std::memory_order_relaxed);
+    return {m_count.load(std::memory_order_relaxed), m_sum.load(std::memory_order_relaxed),
+            m_max.load(std::memory_order_relaxed)};
+  }
+
+private:
+  static void bump(std::atomic<uint64_t>& a, uint64_t n) noexcept {
+    a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<uint64_t> m_sum{0};
+  std::atomic<uint64_t> m_max{0};
+  std::array<std::atomic<uint64_t>, k_buckets> m_buckets{};
+};
+
+inline constexpr size_t k_max_sites = 1024;
+
+// 每个线程一组按调用处编号索引的直方图，首次记录时分配；由 ThreadRegistry 分给各线程，被新线程复用时计数继续累加
+struct ThreadTimers {
+  std::array<std::atomic<Histogram*>, k_max_sites> sites{};
+};
+} // namespace _instrument_detail
+
+/// @brief 一个计时点的汇总结果，时间单位为纳秒
+struct TimerStats {
+  std::string_view name;
+  std::string_view file;
+  uint32_t line;
+  uint64_t count;
+  double mean;
+  double p50;
+  double p90;
+  double p99;
+  double p999;
+  double max;
+};
+
+class Timers {
+public:
+  static Timers& instance() {
+    static Timers* const s_timers = new Timers;
+    return *s_timers;
+  }
+
+  Timers(const Timers&) = delete;
+  Timers& operator=(const Timers&) = delete;
+
+  /// @brief 登记一个计时点，返回其编号；超过容量时返回 k_max_sites，此后的记录被忽略
+  uint32_t addSite(std::string_view name, const std::source_location& loc) {
+    std::lock_guard lock(m_mutex);
+    if (m_sites.size() >= _instrument_detail::k_max_sites) return _instrument_detail::k_max_sites;
+    m_sites.push_back({name, loc.file_name(), loc.line()});
+    return static_cast<uint32_t>(m_sites.size() - 1);
+  }
+
+  /// @brief 把以 ticks() 计的耗时记入本线程的直方图
+  void record(uint32_t site, uint64_t ticks) {
+    if (site >= _instrument_detail::k_max_sites) return;
+    auto& slot = m_threads.local().sites[site];
+    auto* hist = slot.load(std::memory_order_relaxed);
+    if (!hist) {
+      hist = new _instrument_detail::Histogram;
+      slot.store(hist, std::memory_order_release);
+    }
+    hist->record(ticks);
+  }
+
+  /// @brief 汇总所有线程，按登记顺序给出有记录的计时点
+  std::vector<TimerStats> snapshot() {
+    using namespace _instrument_detail;
+    double nsPerTick = calibrate();
+    std::vector<Site> sites;
+    {
+      std::lock_guard lock(m_mutex);
+      sites = m_sites;
+    }
+    std::vector<TimerStats> res;
+    std::vector<uint64_t> buckets(k_buckets);
+    for (size_t i = 0; i < sites.size(); ++i) {
+      std::fill(buckets.begin(), buckets.end(), 0);
+      uint64_t count = 0, sum = 0, max = 0;
+      m_threads.forEach([&](ThreadTimers& t) {
+        if (auto* hist = t.sites[i].load(std::memory_order_acquire)) {
+          auto [c, s, m] = hist->mergeInto(buckets);
+          count += c;
+          sum += s;
+          max = std::max(max, m);
+        }
+      });
+      if (count == 0) continue;
+      // 桶计数与 count 分别读取，并发记录时二者可能略有出入，分位数以桶计数为准
+      uint64_t total = 0;
+      for (uint64_t b : buckets) total += b;
+      auto quantile = [&](double q) {
+        auto rank = static_cast<uint64_t>(q * static_cast<double>(total - 1));
+        uint64_t seen = 0;
+        for (size_t b = 0; b < k_buckets; ++b) {
+          seen += buckets[b];
+          if (seen > rank) return bucketValue(b) * nsPerTick;
+        }
+        return static_cast<double>(max) * nsPerTick;
+      };
+      res.push_back({sites[i].name, sites[i].file, sites[i].line, count,
+                     static_cast<double>(sum) / static_cast<double>(count) * nsPerTick, quantile(0.5), quantile(0.9),
+                     quantile(0.99), quantile(0.999), static_cast<double>(max) * nsPerTick});
+    }
+    return res;
+  }
+
+  /// @brief 每个计时点一行的文本报告
+  std::string report() {
+    std::string res;
+    for (auto const& s : snapshot()) res.append(formatStats(s)).push_back('\n');
+    return res;
+  }
+
+  /// @brief 把报告追加写入文件
+  bool writeReport(const std::string& path) {
+    std::ofstream ofs(path, std::ios::app);
+    ofs << report();
+    return static_cast<bool>(ofs);
+  }
+
+  static std::string formatStats(const TimerStats& s) {
+    std::string res(s.name);
+    res.append(" (").append(s.file).append(":").append(std::to_string(s.line)).append(")");
+    res.append(" count=").append(std::to_string(s.count));
+    for (auto [label, ns] : {std::pair{" mean=", s.mean}, {" p50=", s.p50}, {" p90=", s.p90}, {" p99=", s.p99},
+                             {" p999=", s.p999}, {" max=", s.max}}) {
+      res.append(label).append(formatDuration(ns));
+    }
+    return res;
+  }
+
+  static std::string formatDuration(double ns) {
+    char buf[32];
+    if (ns < 1e3) {
+      snprintf(buf, sizeof(buf), "%.0fns", ns);
+    } else if (ns < 1e6) {
+      snprintf(buf, sizeof(buf), "%.2fus", ns / 1e3);
+    } else if (ns < 1e9) {
+      snprintf(buf, sizeof(buf), "%.2fms", ns / 1e6);
+    } else {
+      snprintf(buf, sizeof(buf), "%.2fs", ns / 1e9);
+    }
+    return buf;
+  }
+
+private:
+  struct Site {
+    std::string_view name;
+    std::string_view file;
+    uint32_t line;
+  };
+
+  Timers() : m_startTicks(_instrument_detail::ticks()), m_startNs(_instrument_detail::steadyNs()) {}
+
+  // 以构造以来的 steady_clock 与计数差求每个计数对应的纳秒数；间隔过短时先等待 1ms 以保证精度
+  double calibrate() {
+#if defined(__x86_64__) || defined(_M_X64)
+    int64_t ns;
+    while ((ns = _instrument_detail::steadyNs() - m_startNs) < 1'000'000) {
+    }
+    return static_cast<double>(ns) / static_cast<double>(_instrument_detail::ticks() - m_startTicks);
+#else
+    return 1.0;
+#endif
+  }
+
+  std::mutex m_mutex;
+  std::vector<Site> m_sites;
+  ThreadRegistry<_instrument_detail::ThreadTimers> m_threads;
+  uint64_t m_startTicks;
+  int64_t m_startNs;
+};
+
+/// @brief 一个计时点：名字与位置在首次经过时登记，之后只保存编号
+class TimerSite {
+public:
+  explicit TimerSite(std::string_view name, std::source_location loc = std::source_location::current())
+      : m_id(Timers::instance().addSite(name, loc)) {}
+
+  uint32_t id() const noexcept { return m_id; }
+
+private:
+  uint32_t m_id;
+};
+
+/// @brief 构造时取时间戳，析构时把耗时记入 site 的直方图
+class ScopedTimer {
+public:
+  explicit ScopedTimer(const TimerSite& site) noexcept : m_site(site.id()), m_start(_instrument_detail::ticks()) {}
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  ~ScopedTimer() { Timers::instance().record(m_site, _instrument_detail::ticks() - m_start); }
+
+private:
+  uint32_t m_site;
+  uint64_t m_start;
+};
+
+#define PLAY_SCOPED_TIMER_IMPL(name, n)                                   \
+  static const ::play::TimerSite PLAY_CONCAT(_play_timer_site_, n){name}; \
+  const ::play::ScopedTimer PLAY_CONCAT(_play_timer_, n){PLAY_CONCAT(_play_timer_site_, n)}
+// 为当前作用域计时，name 须为静态存储的字符串（如字面量）；每个调用处一个直方图，位置取自宏展开处
+#define PLAY_SCOPED_TIMER(name) PLAY_SCOPED_TIMER_IMPL(name, __COUNTER__)
+} // namespace play
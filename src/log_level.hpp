@@ -0,0 +1,191 @@
+#pragma once
+
+// 日志级别及其名字、全局与按文件的静音级别，与格式化无关，供 logger.hpp 与飞行记录器等共用
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define FOR_LOG_LEVEL(f) f(Trace) f(Debug) f(Info) f(Warn) f(Error)
+
+enum class LogLevel : std::uint8_t {
+#define _FUNC(name) name,
+  FOR_LOG_LEVEL(_FUNC)
+#undef _FUNC
+};
+
+inline std::string getlogLevalName(LogLevel lv) {
+#define _FUNC(name) \
+  if (lv == LogLevel::name) return #name;
+  FOR_LOG_LEVEL(_FUNC)
+#undef _FUNC
+  return "unkown";
+}
+
+inline LogLevel getLogLevel(std::string lv) {
+#define _FUNC(name) \
+  if (lv == #name) return LogLevel::name;
+  FOR_LOG_LEVEL(_FUNC)
+#undef _FUNC
+  return LogLevel::Debug;
+}
+
+inline LogLevel g_mute_log_level = []() -> LogLevel {
+  if (auto name = std::getenv("MUTE_LOG_LEVEL")) {
+    return getLogLevel(name);
+  }
+  return LogLevel::Debug;
+}();
+
+inline void set_mute_log_level(LogLevel lv) { g_mute_log_level = lv; };
+
+namespace _log_level_detail {
+// 按文件名覆盖静音级别的规则，整体替换发布，读者无需加锁
+struct Rule {
+  std::string pattern;
+  LogLevel level;
+};
+
+using Rules = std::vector<Rule>;
+
+// 只支持 * 与 ? 的通配符匹配
+inline bool globMatch(std::string_view pattern, std::string_view text) {
+  size_t p = 0, t = 0, star = std::string_view::npos, mark = 0;
+  while (t < text.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+      ++p;
+      ++t;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      mark = t;
+    } else if (star != std::string_view::npos) {
+      p = star + 1;
+      t = ++mark;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') ++p;
+  return p == pattern.size();
+}
+
+// 每个源文件（以 file_name() 返回的地址区分）缓存一次匹配结果：state 高 24 位为解析时的代数，
+// 低 8 位为覆盖的静音级别，k_no_override 表示沿用 g_mute_log_level；代数不一致时重新匹配
+struct FileSlot {
+  std::atomic<const char*> file{nullptr};
+  std::atomic<uint32_t> state{0};
+};
+
+inline constexpr uint32_t k_no_override = 0xff;
+inline constexpr size_t k_file_slots = 1024;
+inline constexpr size_t k_max_probes = 16;
+
+// 规则集不可修改，整体替换；g_rule_readers 为正在匹配的读者数，替换时没有读者才释放被替换下来的规则集，
+// 否则留到之后的某次替换（读者只在各文件的缓存失效时出现，很快就会归零），保留的旧规则集不会无限增长
+inline std::atomic<const Rules*> g_rules{nullptr};
+inline std::atomic<uint32_t> g_rule_readers{0};
+inline std::unique_ptr<const Rules> g_current_rules;
+inline std::vector<std::unique_ptr<const Rules>> g_retired_rules;
+// 每次修改规则后递增，从 1 开始，state 为 0 的槽位一定会被重新匹配
+inline std::atomic<uint32_t> g_generation{1};
+inline FileSlot g_file_slots[k_file_slots];
+inline std::mutex g_rules_mutex;
+
+// 后添加的规则优先；先登记为读者再读取 g_rules，与 publish 中先替换再检查读者数的顺序配对（均为 seq_cst）
+inline uint32_t matchFile(const char* file) {
+  g_rule_readers.fetch_add(1, std::memory_order_seq_cst);
+  uint32_t res = k_no_override;
+  if (auto rules = g_rules.load(std::memory_order_seq_cst)) {
+    for (auto it = rules->rbegin(); it != rules->rend(); ++it) {
+      if (globMatch(it->pattern, file)) {
+        res = static_cast<uint32_t>(it->level);
+        break;
+      }
+    }
+  }
+  g_rule_readers.fetch_sub(1, std::memory_order_release);
+  return res;
+}
+
+inline uint32_t resolve(FileSlot& slot, const char* file, uint32_t generation) {
+  uint32_t state = (generation << 8) | matchFile(file);
+  slot.state.store(state, std::memory_order_release);
+  return state;
+}
+
+inline uint32_t lookup(const char* file) {
+  uint32_t generation = g_generation.load(std::memory_order_acquire) & 0xffffff;
+  uint64_t hash = (reinterpret_cast<uintptr_t>(file) >> 3) * 0x9e3779b97f4a7c15ull;
+  hash ^= hash >> 32;
+  for (size_t probe = 0; probe < k_max_probes; ++probe) {
+    auto& slot = g_file_slots[(hash + probe) & (k_file_slots - 1)];
+    const char* key = slot.file.load(std::memory_order_acquire);
+    if (!key && slot.file.compare_exchange_strong(key, file, std::memory_order_acq_rel)) {
+      return resolve(slot, file, generation);
+    }
+    if (key == file) {
+      uint32_t state = slot.state.load(std::memory_order_acquire);
+      return state >> 8 == generation ? state : resolve(slot, file, generation);
+    }
+  }
+  // 表已满（源文件极多），不再缓存
+  return (generation << 8) | matchFile(file);
+}
+
+// 调用方持有 g_rules_mutex；替换后读者数为 0 时，之后的读者只能读到新的规则集，之前被替换下来的都可以释放
+inline void publish(std::unique_ptr<const Rules> rules) {
+  g_rules.store(rules.get(), std::memory_order_seq_cst);
+  if (g_current_rules) g_retired_rules.push_back(std::move(g_current_rules));
+  g_current_rules = std::move(rules);
+  if (g_rule_readers.load(std::memory_order_seq_cst) == 0) g_retired_rules.clear();
+  uint32_t next = (g_generation.load(std::memory_order_relaxed) + 1) & 0xffffff;
+  g_generation.store(next == 0 ? 1 : next, std::memory_order_release);
+}
+} // namespace _log_level_detail
+
+/// @brief 为文件名匹配 pattern（支持 * 与 ?，与 source_location::file_name() 整体匹配）的日志单独设置静音级别，
+/// 同一 pattern 再次设置时替换，多条规则都匹配时后设置的优先；修改后各文件在下一条日志时重新匹配一次
+inline void set_file_mute_log_level(std::string pattern, LogLevel lv) {
+  using namespace _log_level_detail;
+  std::lock_guard lock(g_rules_mutex);
+  auto* current = g_rules.load(std::memory_order_relaxed);
+  auto rules = current ? std::make_unique<Rules>(*current) : std::make_unique<Rules>();
+  std::erase_if(*rules, [&](Rule const& rule) { return rule.pattern == pattern; });
+  rules->push_back({std::move(pattern), lv});
+  publish(std::move(rules));
+}
+
+inline void clear_file_mute_log_levels() {
+  using namespace _log_level_detail;
+  std::lock_guard lock(g_rules_mutex);
+  publish(std::make_unique<const Rules>());
+}
+
+// 启动时从环境变量读取，如 MUTE_LOG_LEVEL_FILES="*/net/*=Trace,*/db.cpp=Info"
+inline const bool g_file_mute_log_levels_from_env = []() -> bool {
+  auto spec = std::getenv("MUTE_LOG_LEVEL_FILES");
+  if (!spec) return false;
+  std::string_view rest(spec);
+  while (!rest.empty()) {
+    auto item = rest.substr(0, rest.find(','));
+    rest.remove_prefix(std::min(rest.size(), item.size() + 1));
+    if (auto eq = item.rfind('='); eq != std::string_view::npos) {
+      set_file_mute_log_level(std::string(item.substr(0, eq)), getLogLevel(std::string(item.substr(eq + 1))));
+    }
+  }
+  return true;
+}();
+
+/// @brief file 中的日志所用的静音级别；每个文件只在规则变化后匹配一次，之后只需查表比较，不加锁
+inline LogLevel get_mute_log_level(const char* file) {
+  uint32_t level = _log_level_detail::lookup(file) & 0xff;
+  return level == _log_level_detail::k_no_override ? g_mute_log_level : static_cast<LogLevel>(level);
+}
+
+/// @brief 级别为 lv、来自 file 的日志是否被静音
+inline bool is_log_muted(LogLevel lv, const char* file) { return lv <= get_mute_log_level(file); }
@@ -7,29 +7,10 @@
 #include <iostream>
 #include <source_location>
 
-#define FOR_LOG_LEVEL(f) f(Trace) f(Debug) f(Info) f(Warn) f(Error)
-
-enum class LogLevel : std::uint8_t {
-#define _FUNC(name) name,
-  FOR_LOG_LEVEL(_FUNC)
-#undef _FUNC
-};
-
-inline std::string getlogLevalName(LogLevel lv) {
-#define _FUNC(name) \
-  if (lv == LogLevel::name) return #name;
-  FOR_LOG_LEVEL(_FUNC)
-#undef _FUNC
-  return "unkown";
-}
-
-inline LogLevel getLogLevel(std::string lv) {
-#define _FUNC(name) \
-  if (lv == #name) return LogLevel::name;
-  FOR_LOG_LEVEL(_FUNC)
-#undef _FUNC
-  return LogLevel::Debug;
-}
+#include "flight_recorder.hpp"
+#include "instrument.hpp"
+#include "log_level.hpp"
+#include "print_format.hpp"
 
 #if defined(__linux__) || defined(__APPLE__)
 #define ANSI_AVAILABLE
@@ -45,15 +26,6 @@ inline constexpr std::string_view k_ansi_colors[static_cast<std::size_t>(LogLeve
 inline constexpr std::string_view k_ansi_reset = "\E[m";
 #endif
 
-inline LogLevel g_mute_log_level = []() -> LogLevel {
-  if (auto name = std::getenv("MUTE_LOG_LEVEL")) {
-    return getLogLevel(name);
-  }
-  return LogLevel::Debug;
-}();
-
-inline void set_mute_log_level(LogLevel lv) { g_mute_log_level = lv; };
-
 inline std::ofstream g_log_file = []() -> std::ofstream {
   if (auto path = std::getenv("LOG_FILE")) {
     return std::ofstream(path, std::ios::app);
@@ -63,6 +35,19 @@ inline std::ofstream g_log_file = []() -> std::ofstream {
 
 inline void set_log_file(std::string path) { g_log_file = std::ofstream(path, std::ios::app); }
 
+// 飞行记录器模式：所有级别只按值记录参数，致命信号、Error 日志或手动 dump 时才格式化写出（见 flight_recorder.hpp）
+inline const bool g_flight_recorder_from_env = []() -> bool {
+  if (auto path = std::getenv("FLIGHT_RECORDER_FILE")) {
+    play::FlightRecorder::instance().enable(path);
+    return true;
+  }
+  return false;
+}();
+
+inline void set_flight_recorder_file(std::string path) { play::FlightRecorder::instance().enable(path); }
+
+inline void dump_flight_recorder() { play::FlightRecorder::instance().dump(); }
+
 // 介入「格式字符串->std::format_string」的隐式构造，在构造过程中以默认参数的形式顺带构造
 // source_location，以获取调用处的位置信息
 template <class T>
@@ -87,7 +72,7 @@ inline void output_log(LogLevel lv, const std::string &msg, const std::source_lo
   if (g_log_file) {
     g_log_file << final_output;
   }
-  if (lv <= g_mute_log_level) {
+  if (is_log_muted(lv, loc.file_name())) {
     return;
   }
 
@@ -100,10 +85,38 @@ inline void output_log(LogLevel lv, const std::string &msg, const std::source_lo
 #endif
 }
 
+// 在 dump 时由飞行记录器调用，把按值保存的参数还原后格式化
+template <class... Args>
+void format_flight_record(std::string &out, std::string_view fmt, const std::byte *args) {
+  std::apply([&](auto const &...values) { out += std::vformat(fmt, std::make_format_args(values...)); },
+             play::FlightRecorder::decode<Args...>(args));
+}
+
 template <class... Args>
 void generic_log(LogLevel lv, with_source_location<std::format_string<Args...>> fmt, Args &&...args) {
   auto const &loc = fmt.location();
-  auto msg = std::vformat(fmt.format().get(), std::make_format_args(args...));
+  auto &recorder = play::FlightRecorder::instance();
+  if (!recorder.enabled()) {
+    // 被静音且不写日志文件时直接返回，不做格式化
+    if (!g_log_file && is_log_muted(lv, loc.file_name())) return;
+    auto msg = std::vformat(fmt.format().get(), std::make_format_args(args...));
+    output_log(lv, msg, loc);
+    return;
+  }
+  std::string msg;
+  if constexpr (play::FlightRecorder::s_capturable<Args...>) {
+    recorder.record(lv, loc, fmt.format().get(), &format_flight_record<std::decay_t<Args>...>, args...);
+  } else {
+    // 无法按值保存的参数（如自定义类型）只能当场格式化，记录格式化后的消息
+    msg = std::vformat(fmt.format().get(), std::make_format_args(args...));
+    recorder.record(lv, loc, "{}", &format_flight_record<std::string_view>, std::string_view(msg));
+  }
+  if (lv == LogLevel::Error) recorder.dump("error");
+  // 被静音且不写日志文件的级别只留在飞行记录器中，不再格式化
+  if (!g_log_file && is_log_muted(lv, loc.file_name())) return;
+  if constexpr (play::FlightRecorder::s_capturable<Args...>) {
+    msg = std::vformat(fmt.format().get(), std::make_format_args(args...));
+  }
   output_log(lv, msg, loc);
 }
 
@@ -117,6 +130,13 @@ FOR_LOG_LEVEL(_FUNC)
 
 #define LOG_P(x) logDebug(#x " = {}", (x));
 
+// 逐行输出各计时点（PLAY_SCOPED_TIMER）的计数与分位数
+inline void log_timer_report(LogLevel lv = LogLevel::Info) {
+  for (auto const &stats : play::Timers::instance().snapshot()) {
+    generic_log(lv, "timer {}", play::Timers::formatStats(stats));
+  }
+}
+
 // inline void foo() {
 //   int num = 114514;
 //   // 空大括号占位，顺序对应参数顺序
@@ -1,13 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <string>
 #include <string_view>
+#include <type_traits>
 
+#include <poll.h>
 #include <termios.h>
 #include <unistd.h>
 
+#include "secret.hpp"
+
 namespace play {
 
 struct PasswdInput {
@@ -16,15 +24,27 @@ struct PasswdInput {
 };
 
 class UnixPasswdInput : PasswdInput {
+public:
+  // 读取方式：
+  // Char（默认）经由 stdio 的 stdin/stderr 逐字符读取，每个字符回显一次
+  // Batched 直接对文件描述符按块 read()，在缓冲区上处理退格与换行，每块的回显合并为一次 write()；
+  // 读到换行后剩余的字节留在本对象中供下次 request 使用，因此不要再经由 stdio 或其它对象读取同一描述符
+  enum class ReadMode { Char, Batched };
+
+  // 上次 request 的结束原因
+  enum class Status { Line, Eof, Timeout, Error };
+
 private:
   struct PasswdGuard {
+    int fd;
     termios oldtc;
     bool guarded = false;
 
-    PasswdGuard() {
-      if (isatty(STDIN_FILENO)) {
+    PasswdGuard(int fd, bool tty) : fd(fd) {
+      // 非终端（如管道）没有需要关闭的回显与行缓冲，整个跳过 termios
+      if (tty) {
         struct termios tc;
-        tcgetattr(STDIN_FILENO, &tc);
+        tcgetattr(fd, &tc);
         memcpy(&oldtc, &tc, sizeof(tc));
         guarded = true;
         // 一些 io 控制 flag：
@@ -32,24 +52,79 @@ private:
         // ECHO（默认开启），回显用户输入的内容
         tc.c_lflag &= ~ICANON;
         tc.c_lflag &= ~ECHO;
-        tcsetattr(STDIN_FILENO, TCSANOW, &tc);
+        tcsetattr(fd, TCSANOW, &tc);
       }
     }
     ~PasswdGuard() {
       if (guarded) {
-        tcsetattr(STDIN_FILENO, TCSANOW, &oldtc);
+        tcsetattr(fd, TCSANOW, &oldtc);
       }
     }
   };
 
 public:
+  UnixPasswdInput() = default;
+
+  /// @brief 指定读取方式；inFd/outFd 分别为输入与提示、回显的输出（outFd 为 -1 时不输出），
+  /// 用于 Batched 模式与 requestSecret，Char 模式的 request 总是经由 stdio 的 stdin/stderr
+  explicit UnixPasswdInput(ReadMode mode, int inFd = STDIN_FILENO, int outFd = STDERR_FILENO)
+      : m_mode(mode), m_inFd(inFd), m_outFd(outFd), m_tty(isatty(inFd)) {}
+
+  UnixPasswdInput(const UnixPasswdInput&) = delete;
+  UnixPasswdInput& operator=(const UnixPasswdInput&) = delete;
+
+  ~UnixPasswdInput() override { secureZero(m_buffer.data(), m_buffer.size()); }
+
   std::string request(std::string_view prompt = "") override {
+    return m_mode == ReadMode::Batched ? requestBatched(prompt) : requestChar(prompt);
+  };
+
+  /// @brief 在 timeout 内读取一行到预分配、锁定且析构时清零的 SecretString 中，等待期间用 poll 而不是阻塞在 read 上；
+  /// 超时或出错时返回空的 SecretString 并由 status() 给出原因，超出 capacity 的字符被丢弃（见 truncated）；
+  /// 在一行的中途超时后，下一次读取先丢弃该行剩下的部分并返回 Error，而不会把后半行当作完整的一行返回；
+  /// 与 Batched 模式共用读缓冲区，其中已处理的字节会立即清零，不要与 Char 模式的 request 混用
+  SecretString requestSecret(std::string_view prompt, std::chrono::milliseconds timeout,
+                             size_t capacity = s_secret_capacity) {
+    SecretString res(capacity);
+    requestSecret(prompt, timeout, res);
+    return res;
+  }
+
+  /// @brief 同上，但读入调用方提供的 out（先清零），批量读取时可复用同一块锁定内存，省去每行的 mmap 与 mlock
+  Status requestSecret(std::string_view prompt, std::chrono::milliseconds timeout, SecretString& out) {
+    out.clear();
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    readLine(prompt, out, &deadline);
+    if (m_status == Status::Timeout || m_status == Status::Error) out.clear();
+    return m_status;
+  }
+
+  Status status() const noexcept { return m_status; }
+
+  /// @brief 上次 request 是否因输入结束而返回（而不是读到换行）
+  bool eof() const noexcept { return m_status == Status::Eof; }
+
+private:
+  using Deadline = std::chrono::steady_clock::time_point;
+
+  static constexpr size_t s_buffer_size = 4096;
+  static constexpr size_t s_secret_capacity = 256;
+
+  static bool isLineEnd(char c) { return c == '\n' || c == '\r'; }
+
+  static bool isBackspace(char c) { return c == '\b' || c == '\x7f'; }
+
+  std::string requestChar(std::string_view prompt) {
     if (!prompt.empty()) fputs(prompt.data(), stderr);
-    PasswdGuard guard;
+    PasswdGuard guard(STDIN_FILENO, isatty(STDIN_FILENO));
     std::string res;
+    m_status = Status::Line;
     while (true) {
       int c = getchar();
-      if (c == EOF) break;
+      if (c == EOF) {
+        m_status = Status::Eof;
+        break;
+      }
       if (strchr("\n\r", c)) {
         fputc('\n', stderr);
         break;
@@ -65,7 +140,134 @@ public:
       }
     }
     return res;
-  };
+  }
+
+  std::string requestBatched(std::string_view prompt) {
+    std::string res;
+    readLine(prompt, res, nullptr);
+    return res;
+  }
+
+  // 按块读取一行到 res（std::string 或 SecretString），普通字符成段追加，只在退格与换行处停下
+  template <class Out>
+  void readLine(std::string_view prompt, Out& res, const Deadline* deadline) {
+    // 写入 SecretString 时，读缓冲区中已处理的字节随即清零
+    constexpr bool wipe = std::is_same_v<Out, SecretString>;
+    m_echo.clear();
+    m_echo.append(prompt);
+    flushEcho();
+    PasswdGuard guard(m_inFd, m_tty);
+    m_status = Status::Line;
+    if (m_out_of_sync) {
+      // 上次在行中途超时，已读的前半行被丢弃，剩下的半行不能当作一行返回
+      if (skipLine(deadline)) m_status = Status::Error;
+      if (m_status != Status::Timeout) m_out_of_sync = false;
+      flushEcho();
+      return;
+    }
+    bool partial = false;
+    while (m_status == Status::Line) {
+      if (m_begin == m_end && !refill(deadline)) {
+        if (partial && m_status == Status::Timeout) m_out_of_sync = true;
+        break;
+      }
+      partial = true;
+      size_t start = m_begin;
+      size_t i = m_begin;
+      bool done = false;
+      for (; i < m_end; ++i) {
+        char c = m_buffer[i];
+        if (!isLineEnd(c) && !isBackspace(c)) continue;
+        res.append(m_buffer.data() + m_begin, i - m_begin);
+        m_echo.append(i - m_begin, '*');
+        m_begin = i + 1;
+        if (isLineEnd(c)) {
+          m_echo.push_back('\n');
+          done = true;
+          break;
+        }
+        if (!res.empty()) {
+          res.pop_back();
+          m_echo.append("\b \b");
+        }
+      }
+      if (!done) {
+        res.append(m_buffer.data() + m_begin, m_end - m_begin);
+        m_echo.append(m_end - m_begin, '*');
+        m_begin = m_end;
+      }
+      if constexpr (wipe) secureZero(m_buffer.data() + start, m_begin - start);
+      flushEcho();
+      if (done) break;
+    }
+  }
+
+  // 丢弃到下一个换行（含）为止的输入并清零；读到换行时返回 true，否则由 refill 设置 m_status
+  bool skipLine(const Deadline* deadline) {
+    while (true) {
+      if (m_begin == m_end && !refill(deadline)) return false;
+      char* first = m_buffer.data() + m_begin;
+      char* last = m_buffer.data() + m_end;
+      char* it = std::find_if(first, last, isLineEnd);
+      char* stop = it == last ? last : it + 1;
+      secureZero(first, static_cast<size_t>(stop - first));
+      m_begin += static_cast<size_t>(stop - first);
+      if (it != last) return true;
+    }
+  }
+
+  // 读入下一块；deadline 非空时先用 poll 等待。输入结束、超时或出错时设置 m_status 并返回 false
+  bool refill(const Deadline* deadline) {
+    m_begin = m_end = 0;
+    while (true) {
+      if (deadline) {
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now());
+        pollfd pfd{m_inFd, POLLIN, 0};
+        int ready = left.count() > 0 ? poll(&pfd, 1, static_cast<int>(left.count())) : 0;
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready == 0) {
+          m_status = Status::Timeout;
+          return false;
+        }
+        if (ready < 0 || (pfd.revents & POLLNVAL)) {
+          m_status = Status::Error;
+          return false;
+        }
+      }
+      ssize_t n = read(m_inFd, m_buffer.data(), m_buffer.size());
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        m_status = n == 0 ? Status::Eof : Status::Error;
+        return false;
+      }
+      m_end = static_cast<size_t>(n);
+      return true;
+    }
+  }
+
+  void flushEcho() {
+    if (m_outFd >= 0) {
+      for (size_t off = 0; off < m_echo.size();) {
+        ssize_t n = write(m_outFd, m_echo.data() + off, m_echo.size() - off);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        off += static_cast<size_t>(n);
+      }
+    }
+    m_echo.clear();
+  }
+
+  ReadMode m_mode = ReadMode::Char;
+  int m_inFd = STDIN_FILENO;
+  int m_outFd = STDERR_FILENO;
+  bool m_tty = isatty(STDIN_FILENO);
+  Status m_status = Status::Line;
+  // 上次读取在一行的中途超时，下次读取要先跳过该行剩下的部分
+  bool m_out_of_sync = false;
+  std::array<char, s_buffer_size> m_buffer;
+  size_t m_begin = 0;
+  size_t m_end = 0;
+  std::string m_echo;
 };
 
 } // namespace play
@@ -0,0 +1,5 @@
+#pragma once
+
+// 拼接两个记号，参数先展开，如 PLAY_CONCAT(_play_timer_, __COUNTER__) 为每个展开处生成唯一的变量名
+#define PLAY_CONCAT_IMPL(a, b) a##b
+#define PLAY_CONCAT(a, b) PLAY_CONCAT_IMPL(a, b)
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <charconv>
 #include <iomanip>
 #include <iostream>
 #include <optional>
 #include <sstream>
+#include <streambuf>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -101,8 +104,17 @@ struct _is_c_str<T, std::enable_if_t<std::is_pointer_v<std::decay_t<T>> &&
     : std::true_type {};
 DEF_SFINAE_VALUE(_is_c_str)
 
+// 其它可隐式转换为 std::string_view 的字符串类型（如 play::InlineString）
+template <class T, class = void>
+struct _is_string_view_like : std::false_type {};
+
 template <class T>
-struct _is_str_like : std::disjunction<_is_string<T>, _is_c_str<T>> {};
+struct _is_string_view_like<
+    T, std::enable_if_t<std::is_class_v<T> && std::is_convertible_v<T const&, std::string_view>>> : std::true_type {};
+DEF_SFINAE_VALUE(_is_string_view_like)
+
+template <class T>
+struct _is_str_like : std::disjunction<_is_string<T>, _is_c_str<T>, _is_string_view_like<T>> {};
 DEF_SFINAE_VALUE(_is_str_like)
 
 // 兜底方案（如果可以的话，优先使用流格式化，否则使用地址替代）
@@ -195,7 +207,11 @@ template <class T>
 struct _serializer<T, std::enable_if_t<!_if_impl_toString_v<T> && _is_str_like_v<T>>> {
   static std::string toString(T const& t) {
     std::ostringstream oss;
-    oss << std::quoted(t);
+    if constexpr (_is_string_v<T> || _is_c_str_v<T>) {
+      oss << std::quoted(t);
+    } else {
+      oss << std::quoted(std::string_view(t));
+    }
     return oss.str();
   }
 };
@@ -247,6 +263,153 @@ struct _serializer<T, std::enable_if_t<!_if_impl_toString_v<T> && _is_variant_v<
   }
 };
 
+// 以下 formatTo 与 _serializer 的输出完全相同，但逐个元素直接写入输出迭代器，不构造中间字符串（供 std::formatter 使用）
+
+// 按整数输出的算术类型（各种字符类型经由流输出为字符，保持与 toString 一致）
+template <class T>
+struct _is_plain_integer
+    : std::bool_constant<std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> &&
+                         !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char> &&
+                         !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t> && !std::is_same_v<T, char16_t> &&
+                         !std::is_same_v<T, char32_t>> {};
+DEF_SFINAE_VALUE(_is_plain_integer)
+
+// 把流的输出转发到输出迭代器，用于只能通过 operator<< 输出的类型
+template <class Out>
+class _iterator_streambuf : public std::streambuf {
+public:
+  explicit _iterator_streambuf(Out out) : m_out(std::move(out)) {}
+
+  Out out() const { return m_out; }
+
+protected:
+  int_type overflow(int_type c) override {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) *m_out++ = traits_type::to_char_type(c);
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    m_out = std::copy(s, s + n, m_out);
+    return n;
+  }
+
+private:
+  Out m_out;
+};
+
+template <class Out>
+Out _write(Out out, std::string_view s) {
+  return std::copy(s.begin(), s.end(), out);
+}
+
+// 与 std::quoted 相同：前后加上 delim，内部的 delim 与反斜杠前加反斜杠
+template <class Out>
+Out _write_quoted(Out out, std::string_view s, char delim) {
+  *out++ = delim;
+  for (char c : s) {
+    if (c == delim || c == '\\') *out++ = '\\';
+    *out++ = c;
+  }
+  *out++ = delim;
+  return out;
+}
+
+template <class Out, class T>
+Out formatTo(Out out, T const& t);
+
+// 兜底方案，与 _serializer 的主模板相同
+template <class Out, class T>
+Out _format_fallback(Out out, T const& t) {
+  _iterator_streambuf<Out> buf(std::move(out));
+  std::ostream os(&buf);
+  if constexpr (_if_impl_stream_insert_v<T>) {
+    os << t;
+  } else {
+    os << std::hex << std::showbase << "addr("
+       << reinterpret_cast<std::size_t>(reinterpret_cast<void const volatile*>(std::addressof(t))) << ")";
+  }
+  return buf.out();
+}
+
+template <class Out, class T, std::size_t... Idx>
+Out _format_tuple(Out out, T const& t, std::index_sequence<Idx...>) {
+  *out++ = '{';
+  ((out = _write(out, Idx == 0 ? "" : ", "), out = formatTo(out, std::get<Idx>(t))), ...);
+  *out++ = '}';
+  return out;
+}
+
+template <class Out, class T>
+Out formatTo(Out out, T const& t) {
+  if constexpr (_if_impl_toString_v<T>) {
+    return _write(out, t.toString());
+  } else if constexpr (_is_map_v<T>) {
+    *out++ = '{';
+    bool flag = false;
+    for (auto const& [key, value] : t) {
+      if (flag) out = _write(out, ", ");
+      flag = true;
+      out = formatTo(out, key);
+      out = _write(out, ": ");
+      out = formatTo(out, value);
+    }
+    *out++ = '}';
+    return out;
+  } else if constexpr (_is_str_like_v<T>) {
+    return _write_quoted(out, std::string_view(t), '"');
+  } else if constexpr (_is_char_v<T>) {
+    // 与 toString 一样按 C 字符串输出，'\0' 输出为空
+    return _write_quoted(out, std::string_view(&t, t == '\0' ? 0 : 1), '\'');
+  } else if constexpr (_is_iterable_v<T>) {
+    if constexpr (!std::is_same_v<typename std::iterator_traits<decltype(std::begin(t))>::value_type,
+                                  std::decay_t<T>>) {
+      *out++ = '[';
+      bool flag = false;
+      for (auto const& item : t) {
+        if (flag) out = _write(out, ", ");
+        flag = true;
+        out = formatTo(out, item);
+      }
+      *out++ = ']';
+      return out;
+    } else {
+      // 元素类型与自身相同（如 std::filesystem::path），与 toString 一样按兜底方式输出
+      return _format_fallback(out, t);
+    }
+  } else if constexpr (_is_tuple_like_v<T>) {
+    return _format_tuple(out, t, std::make_index_sequence<std::tuple_size_v<T>>{});
+  } else if constexpr (std::is_same_v<T, bool>) {
+    return _write(out, t ? "true" : "false");
+  } else if constexpr (std::is_same_v<T, std::nullptr_t>) {
+    return _write(out, "nullptr");
+  } else if constexpr (std::is_same_v<T, std::nullopt_t>) {
+    return _write(out, "nullopt");
+  } else if constexpr (_is_optional_v<T>) {
+    if (!t) return _write(out, "nullopt");
+    out = _write(out, "opt(");
+    out = formatTo(out, *t);
+    *out++ = ')';
+    return out;
+  } else if constexpr (_is_variant_v<T>) {
+    out = _write(out, "var(");
+    out = std::visit([&](auto const& v) { return formatTo(out, v); }, t);
+    *out++ = ')';
+    return out;
+  } else if constexpr (_is_plain_integer_v<T> || std::is_floating_point_v<T>) {
+    // 与流的默认格式相同：整数按十进制，浮点数相当于 %g（6 位有效数字）
+    char buf[64];
+    std::to_chars_result res;
+    if constexpr (std::is_floating_point_v<T>) {
+      res = std::to_chars(buf, buf + sizeof(buf), t, std::chars_format::general, 6);
+    } else {
+      res = std::to_chars(buf, buf + sizeof(buf), t);
+    }
+    return _write(out, std::string_view(buf, res.ptr - buf));
+  } else {
+    return _format_fallback(out, t);
+  }
+}
+
 template <class T, class... Ts>
 std::string toString(T const& t, Ts const&... ts) {
   std::string res = _serializer<_rmcvref_t<T>>::toString(t);
@@ -280,6 +443,7 @@ void println(T const& t, Ts const&... ts) {
 
 } // namespace _print_details
 
+using _print_details::formatTo;
 using _print_details::oprint;
 using _print_details::oprintln;
 using _print_details::print;
@@ -2,8 +2,12 @@
 
 #include <unordered_map>
 
+#include "flat_hash_map.hpp"
+
 int main([[maybe_unused]] int argc, [[maybe_unused]] char const* argv[]) {
   auto map = std::unordered_map<std::string, std::variant<int, double>>({{"k1", 114}, {"k2", 514.810}});
   play::println(map);
+  auto flat = play::FlatHashMap<std::string, std::variant<int, double>>({{"k1", 114}, {"k2", 514.810}});
+  play::println(flat);
   return 0;
 }
@@ -0,0 +1,52 @@
+#pragma once
+
+// 让 print.hpp 支持的类型可用于 std::format：输出与 toString 完全相同，但直接写入格式化的输出迭代器，
+// 不构造中间字符串，std::format_to_n 截断时也只写入需要的部分。
+// 标准库类型（std::vector、std::map 等）不允许由用户特化 std::formatter（C++23 也已自带其范围格式化），
+// 因此经由 play::printable() 包装后使用：std::format("{}", play::printable(vec))；
+// 实现了 toString() 的自定义类型可直接使用，并支持 std::string_view 的格式说明（宽度、对齐等）
+// 只在标准库提供 <format>（__cpp_lib_format）时生效；GCC 12 等没有 <format> 的标准库上本文件不定义任何内容。
+// 输出全部来自 play::formatTo，其与 toString 的一致性由 test/print_format.cpp 检查
+#include <version>
+
+#include "print.hpp"
+
+#if defined(__cpp_lib_format)
+#include <format>
+
+namespace play {
+/// @brief 按 toString 的格式输出被引用的对象，须在格式化完成前保持有效
+template <class T>
+struct Printable {
+  T const& value;
+};
+
+template <class T>
+Printable<T> printable(T const& t) {
+  return {t};
+}
+} // namespace play
+
+template <class T>
+struct std::formatter<play::Printable<T>, char> {
+  constexpr auto parse(std::format_parse_context& ctx) {
+    auto it = ctx.begin();
+    if (it != ctx.end() && *it != '}') throw std::format_error("play::printable does not accept a format spec");
+    return it;
+  }
+
+  template <class FormatContext>
+  auto format(play::Printable<T> const& p, FormatContext& ctx) const {
+    return play::formatTo(ctx.out(), p.value);
+  }
+};
+
+template <class T>
+  requires play::_print_details::_if_impl_toString_v<T>
+struct std::formatter<T, char> : std::formatter<std::string_view, char> {
+  template <class FormatContext>
+  auto format(T const& t, FormatContext& ctx) const {
+    return std::formatter<std::string_view, char>::format(t.toString(), ctx);
+  }
+};
+#endif
@@ -0,0 +1,305 @@
+#pragma once
+
+// play::toString 输出格式的解析：把文本还原为对应的 C++ 类型，按与 print.hpp 相同的类型特征分派
+// - map {k: v}、可迭代容器 [a, b]、tuple/pair {a, b}、opt(x)/nullopt、var(x)、带引号的字符串与字符、true/false、数字
+// - 数字使用 std::from_chars；字符串以 16 字节为一组比较，查找引号与反斜杠，无转义的片段整段追加
+// - 元素为数字的序列先以同样的方式扫描到 ']' 并统计逗号个数，一次性 reserve
+// 注意：toString 的浮点数只保留 6 位有效数字，往返的精度以此为限；variant 依次尝试各备选类型，取第一个能解析的；
+// 自定义的 toString() 格式无法通用地解析，不受支持
+#include <charconv>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "print.hpp"
+#include "simd.hpp"
+
+// x86-64 的基线即包含 SSE2，不需要按 CPU 分派（字符串通常很短，分派的开销比扫描本身还大）
+#if defined(PLAY_X86_SIMD) && defined(__SSE2__)
+#define PLAY_PARSE_SSE2
+#endif
+
+namespace play {
+namespace _parse_detail {
+using _print_details::_is_char_v;
+using _print_details::_is_iterable_v;
+using _print_details::_is_map_v;
+using _print_details::_is_optional_v;
+using _print_details::_is_plain_integer_v;
+using _print_details::_is_str_like_v;
+using _print_details::_is_string_v;
+using _print_details::_is_tuple_like_v;
+using _print_details::_is_variant_v;
+
+template <class T>
+inline constexpr bool s_is_number = _is_plain_integer_v<T> || std::is_floating_point_v<T>;
+
+#ifdef PLAY_PARSE_SSE2
+using Chunk = simd_t<char, 16>;
+
+// 每个字节与 c 比较，结果的最高位组成 16 位掩码
+[[gnu::always_inline]] inline unsigned matchMask(const Chunk& x, char c) {
+  return static_cast<unsigned>(__builtin_ia32_pmovmskb128(x == Chunk{} + c));
+}
+
+[[gnu::always_inline]] inline Chunk loadChunk(const char* p) {
+  Chunk x;
+  std::memcpy(&x, p, sizeof(x));
+  return x;
+}
+#endif
+
+/// @brief 第一个等于 a 或 b 的字符，没有则返回 last
+inline const char* findEither(const char* first, const char* last, char a, char b) {
+#ifdef PLAY_PARSE_SSE2
+  for (; last - first >= 16; first += 16) {
+    Chunk x = loadChunk(first);
+    if (unsigned m = matchMask(x, a) | matchMask(x, b)) return first + __builtin_ctz(m);
+  }
+#endif
+  while (first != last && *first != a && *first != b) ++first;
+  return first;
+}
+
+/// @brief 统计第一个 close 之前 sep 的个数（加到 count 上），返回 close 的位置，没有则返回 last
+inline const char* countUntil(const char* first, const char* last, char sep, char close, size_t& count) {
+#ifdef PLAY_PARSE_SSE2
+  for (; last - first >= 16; first += 16) {
+    Chunk x = loadChunk(first);
+    unsigned seps = matchMask(x, sep);
+    if (unsigned closes = matchMask(x, close)) {
+      count += static_cast<size_t>(__builtin_popcount(seps & ((closes & -closes) - 1)));
+      return first + __builtin_ctz(closes);
+    }
+    count += static_cast<size_t>(__builtin_popcount(seps));
+  }
+#endif
+  for (; first != last && *first != close; ++first) count += *first == sep;
+  return first;
+}
+
+// 递归下降解析器；失败时 m_cur 停在出错处，输出对象处于有效但未指定的状态
+class Parser {
+public:
+  Parser(const char* first, const char* last) : m_cur(first), m_last(last) {}
+
+  const char* pos() const { return m_cur; }
+
+  std::errc error() const { return m_error; }
+
+  void skipSpace() {
+    while (m_cur != m_last && (*m_cur == ' ' || *m_cur == '\t' || *m_cur == '\n' || *m_cur == '\r')) ++m_cur;
+  }
+
+  template <class T>
+  bool value(T& out) {
+    skipSpace();
+    if constexpr (_is_map_v<T>) {
+      return map(out);
+    } else if constexpr (_is_str_like_v<T>) {
+      static_assert(!std::is_pointer_v<std::decay_t<T>> && !std::is_same_v<T, std::string_view>,
+                    "play::fromString: cannot parse into a non-owning string");
+      if constexpr (_is_string_v<T>) {
+        return string(out);
+      } else {
+        std::string tmp;
+        if (!string(tmp)) return false;
+        out = std::string_view(tmp);
+        return true;
+      }
+    } else if constexpr (_is_char_v<T>) {
+      return character(out);
+    } else if constexpr (_is_iterable_v<T>) {
+      return sequence(out);
+    } else if constexpr (_is_tuple_like_v<T>) {
+      return tuple(out, std::make_index_sequence<std::tuple_size_v<T>>{});
+    } else if constexpr (std::is_same_v<T, bool>) {
+      if (consume("true")) {
+        out = true;
+      } else if (consume("false")) {
+        out = false;
+      } else {
+        return fail();
+      }
+      return true;
+    } else if constexpr (_is_optional_v<T>) {
+      if (consume("nullopt")) {
+        out.reset();
+        return true;
+      }
+      if (!consume("opt(")) return fail();
+      return value(out.emplace()) && close(')');
+    } else if constexpr (_is_variant_v<T>) {
+      if (!consume("var(")) return fail();
+      return alternative<0>(out);
+    } else if constexpr (s_is_number<T>) {
+      auto [ptr, ec] = std::from_chars(m_cur, m_last, out);
+      if (ec != std::errc()) return fail(ec);
+      m_cur = ptr;
+      return true;
+    } else {
+      static_assert(s_is_number<T>, "play::fromString: unsupported type");
+      return false;
+    }
+  }
+
+private:
+  bool fail(std::errc ec = std::errc::invalid_argument) {
+    m_error = ec;
+    return false;
+  }
+
+  bool consume(std::string_view s) {
+    if (static_cast<size_t>(m_last - m_cur) < s.size() || std::memcmp(m_cur, s.data(), s.size()) != 0) return false;
+    m_cur += s.size();
+    return true;
+  }
+
+  bool consume(char c) {
+    skipSpace();
+    if (m_cur == m_last || *m_cur != c) return false;
+    ++m_cur;
+    return true;
+  }
+
+  bool close(char c) { return consume(c) || fail(); }
+
+  // 与 std::quoted 相反：去掉两端的引号，反斜杠后的字符原样保留
+  bool quoted(std::string& out, char delim) {
+    if (m_cur == m_last || *m_cur != delim) return fail();
+    ++m_cur;
+    out.clear();
+    while (true) {
+      const char* p = findEither(m_cur, m_last, delim, '\\');
+      out.append(m_cur, p);
+      m_cur = p;
+      if (p == m_last) return fail();
+      if (*p == delim) break;
+      if (p + 1 == m_last) return fail();
+      out.push_back(p[1]);
+      m_cur = p + 2;
+    }
+    ++m_cur;
+    return true;
+  }
+
+  bool string(std::string& out) { return quoted(out, '"'); }
+
+  // toString 把 '\0' 输出为 ''
+  bool character(char& out) {
+    const char* start = m_cur;
+    std::string tmp;
+    if (!quoted(tmp, '\'')) return false;
+    if (tmp.size() > 1) {
+      m_cur = start;
+      return fail();
+    }
+    out = tmp.empty() ? '\0' : tmp[0];
+    return true;
+  }
+
+  template <class C>
+  bool sequence(C& out) {
+    using Item = typename C::value_type;
+    if (!consume('[')) return fail();
+    out.clear();
+    if constexpr ((s_is_number<Item> || std::is_same_v<Item, bool>) && requires { out.reserve(size_t()); }) {
+      // 数字中不会出现逗号与 ']'，逗号的个数加一即元素个数
+      size_t commas = 0;
+      const char* end = countUntil(m_cur, m_last, ',', ']', commas);
+      skipSpace();
+      if (m_cur != end) out.reserve(commas + 1);
+    }
+    if (consume(']')) return true;
+    do {
+      // 复杂的元素就地构造后解析，避免再移动一次；数字解析到局部变量再追加更快
+      if constexpr (!s_is_number<Item> && requires { { out.emplace_back() } -> std::same_as<Item&>; }) {
+        if (!value(out.emplace_back())) return false;
+      } else {
+        Item item{};
+        if (!value(item)) return false;
+        if constexpr (requires { out.push_back(std::move(item)); }) {
+          out.push_back(std::move(item));
+        } else {
+          out.insert(std::move(item));
+        }
+      }
+    } while (consume(','));
+    return close(']');
+  }
+
+  template <class M>
+  bool map(M& out) {
+    if (!consume('{')) return fail();
+    out.clear();
+    if (consume('}')) return true;
+    do {
+      typename M::key_type key{};
+      if (!value(key) || !close(':')) return false;
+      if constexpr (requires { out.try_emplace(std::move(key)); }) {
+        if (!value(out.try_emplace(std::move(key)).first->second)) return false;
+      } else {
+        typename M::mapped_type mapped{};
+        if (!value(mapped)) return false;
+        out.emplace(std::move(key), std::move(mapped));
+      }
+    } while (consume(','));
+    return close('}');
+  }
+
+  template <class T, size_t... Idx>
+  bool tuple(T& out, std::index_sequence<Idx...>) {
+    if (!consume('{')) return fail();
+    bool ok = true;
+    ((ok = ok && (Idx == 0 || close(',')) && value(std::get<Idx>(out))), ...);
+    return ok && close('}');
+  }
+
+  // 从第 I 个备选类型开始依次尝试，失败则回到 "var(" 之后重来
+  template <size_t I, class V>
+  bool alternative(V& out) {
+    if constexpr (I == std::variant_size_v<V>) {
+      return fail();
+    } else {
+      const char* start = m_cur;
+      if (value(out.template emplace<I>()) && consume(')')) return true;
+      m_cur = start;
+      m_error = std::errc();
+      return alternative<I + 1>(out);
+    }
+  }
+
+  const char* m_cur;
+  const char* m_last;
+  std::errc m_error{};
+};
+} // namespace _parse_detail
+
+/// @brief 从 [first, last) 解析一个 T（toString 的格式，允许多余的空白），接口与 std::from_chars 相同：
+/// 成功时 ptr 指向已解析部分之后；失败时 ec 为 invalid_argument（数值越界为 result_out_of_range），ptr 指向出错处
+template <class T>
+std::from_chars_result fromChars(const char* first, const char* last, T& value) {
+  _parse_detail::Parser parser(first, last);
+  bool ok = parser.value(value);
+  return {parser.pos(), ok ? std::errc() : parser.error()};
+}
+
+/// @brief 解析整个字符串，有多余内容或解析失败时返回 std::nullopt
+template <class T>
+std::optional<T> fromString(std::string_view text) {
+  std::optional<T> res(std::in_place);
+  _parse_detail::Parser parser(text.data(), text.data() + text.size());
+  if (!parser.value(*res)) return std::nullopt;
+  parser.skipSpace();
+  if (parser.pos() != text.data() + text.size()) return std::nullopt;
+  return res;
+}
+} // namespace play
+
+#undef PLAY_PARSE_SSE2
@@ -0,0 +1,368 @@
+#pragma once
+
+// 浮点数组的归约：sum / minimum / maximum / dot / meanVariance，以及 Kahan 与 pairwise 求和
+// - 标量版本使用多个独立累加器打破循环携带依赖
+// - x86 上以 GCC 向量扩展编写同一份内核，分别以 SSE2/AVX2/AVX-512 为目标编译，运行时按 CPU 支持情况分派
+// - parallel* 版本把大数组切块交给多个线程
+// 注意：多累加器改变了求和顺序，结果与顺序求和可能有舍入误差上的差别；Kahan 版本依赖严格的浮点语义，不能配合 -ffast-math
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "simd.hpp"
+
+namespace play::reduce {
+using play::detectIsa;
+using play::Isa;
+
+template <typename T>
+inline constexpr bool is_reducible_v = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template <typename R>
+concept reducible_range = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+                          is_reducible_v<std::ranges::range_value_t<R>>;
+
+template <typename T>
+struct MeanVariance {
+  T mean;
+  T variance; // 总体方差（除以 n）
+};
+
+namespace _reduce_detail {
+enum class Op { Sum, Min, Max, Dot, SquaredDiff };
+
+template <Op op, typename T>
+constexpr T identity() {
+  if constexpr (op == Op::Min) return std::numeric_limits<T>::infinity();
+  if constexpr (op == Op::Max) return -std::numeric_limits<T>::infinity();
+  return T(0);
+}
+
+// 合并两个部分结果
+template <Op op, typename T>
+inline T combine(T x, T y) {
+  if constexpr (op == Op::Min) return y < x ? y : x;
+  if constexpr (op == Op::Max) return y > x ? y : x;
+  return x + y;
+}
+
+// 把第 i 个元素并入部分结果，b 仅用于 Dot，mean 仅用于 SquaredDiff
+template <Op op, typename T>
+inline T step(T acc, const T* a, const T* b, T mean, size_t i) {
+  if constexpr (op == Op::Dot) return acc + a[i] * b[i];
+  if constexpr (op == Op::SquaredDiff) return acc + (a[i] - mean) * (a[i] - mean);
+  return combine<op>(acc, a[i]);
+}
+
+// 多累加器标量内核，在任意平台上可用
+template <Op op, typename T, size_t U>
+T scalarReduce(const T* a, const T* b, T mean, size_t n) {
+  T acc[U];
+  std::fill_n(acc, U, identity<op, T>());
+  size_t blocks = n / U;
+  for (size_t blk = 0; blk < blocks; ++blk) {
+    for (size_t u = 0; u < U; ++u) acc[u] = step<op>(acc[u], a, b, mean, blk * U + u);
+  }
+  for (size_t u = 1; u < U; ++u) acc[0] = combine<op>(acc[0], acc[u]);
+  for (size_t i = blocks * U; i < n; ++i) acc[0] = step<op>(acc[0], a, b, mean, i);
+  return acc[0];
+}
+
+template <typename T>
+inline void kahanAdd(T& sum, T& comp, T x) {
+  T y = x - comp;
+  T t = sum + y;
+  comp = (t - sum) - y;
+  sum = t;
+}
+
+template <typename T, size_t U>
+T scalarKahan(const T* a, size_t n) {
+  T sum[U] = {}, comp[U] = {};
+  size_t blocks = n / U;
+  for (size_t blk = 0; blk < blocks; ++blk) {
+    for (size_t u = 0; u < U; ++u) kahanAdd(sum[u], comp[u], a[blk * U + u]);
+  }
+  T res = 0, c = 0;
+  for (size_t u = 0; u < U; ++u) {
+    kahanAdd(res, c, sum[u]);
+    kahanAdd(res, c, -comp[u]);
+  }
+  for (size_t i = blocks * U; i < n; ++i) kahanAdd(res, c, a[i]);
+  return res - c;
+}
+
+#ifdef PLAY_X86_SIMD
+// 向量内核：U 个宽度为 Bytes 的累加器，内联进带 target 属性的包装函数后按对应指令集生成代码
+// 向量的运算都写在函数体内，避免以向量类型传参/返回（会触发 -Wpsabi）
+template <Op op, typename T, size_t Bytes, size_t U>
+[[gnu::always_inline]] inline T simdReduce(const T* a, const T* b, T mean, size_t n) {
+  using V = simd_t<T, Bytes>;
+  constexpr size_t W = Bytes / sizeof(T);
+  const V m = V{} + mean;
+  V acc[U];
+  for (auto& v : acc) v = V{} + identity<op, T>();
+
+  size_t blocks = n / (U * W);
+  for (size_t blk = 0; blk < blocks; ++blk) {
+    for (size_t u = 0; u < U; ++u) {
+      size_t i = (blk * U + u) * W;
+      V x;
+      std::memcpy(&x, a + i, sizeof(V));
+      if constexpr (op == Op::Sum) {
+        acc[u] += x;
+      } else if constexpr (op == Op::Min) {
+        acc[u] = x < acc[u] ? x : acc[u];
+      } else if constexpr (op == Op::Max) {
+        acc[u] = x > acc[u] ? x : acc[u];
+      } else if constexpr (op == Op::Dot) {
+        V y;
+        std::memcpy(&y, b + i, sizeof(V));
+        acc[u] += x * y;
+      } else {
+        V d = x - m;
+        acc[u] += d * d;
+      }
+    }
+  }
+  for (size_t u = 1; u < U; ++u) {
+    if constexpr (op == Op::Min) {
+      acc[0] = acc[u] < acc[0] ? acc[u] : acc[0];
+    } else if constexpr (op == Op::Max) {
+      acc[0] = acc[u] > acc[0] ? acc[u] : acc[0];
+    } else {
+      acc[0] += acc[u];
+    }
+  }
+
+  T res = identity<op, T>();
+  for (size_t l = 0; l < W; ++l) res = combine<op>(res, acc[0][l]);
+  for (size_t i = blocks * U * W; i < n; ++i) res = step<op>(res, a, b, mean, i);
+  return res;
+}
+
+template <typename T, size_t Bytes, size_t U>
+[[gnu::always_inline]] inline T simdKahan(const T* a, size_t n) {
+  using V = simd_t<T, Bytes>;
+  constexpr size_t W = Bytes / sizeof(T);
+  V sum[U] = {}, comp[U] = {};
+
+  size_t blocks = n / (U * W);
+  for (size_t blk = 0; blk < blocks; ++blk) {
+    for (size_t u = 0; u < U; ++u) {
+      V x;
+      std::memcpy(&x, a + (blk * U + u) * W, sizeof(V));
+      V y = x - comp[u];
+      V t = sum[u] + y;
+      comp[u] = (t - sum[u]) - y;
+      sum[u] = t;
+    }
+  }
+
+  T res = 0, c = 0;
+  for (size_t u = 0; u < U; ++u) {
+    for (size_t l = 0; l < W; ++l) {
+      kahanAdd(res, c, sum[u][l]);
+      kahanAdd(res, c, -comp[u][l]);
+    }
+  }
+  for (size_t i = blocks * U * W; i < n; ++i) kahanAdd(res, c, a[i]);
+  return res - c;
+}
+
+#define PLAY_REDUCE_DEFINE_ISA(Name, isa, bytes)                                             \
+  struct Name {                                                                              \
+    template <Op op, typename T>                                                             \
+    __attribute__((target(isa))) static T reduce(const T* a, const T* b, T mean, size_t n) { \
+      return simdReduce<op, T, bytes, 4>(a, b, mean, n);                                     \
+    }                                                                                        \
+                                                                                             \
+    template <typename T>                                                                    \
+    __attribute__((target(isa))) static T kahan(const T* a, size_t n) {                      \
+      return simdKahan<T, bytes, 4>(a, n);                                                   \
+    }                                                                                        \
+  };
+
+PLAY_REDUCE_DEFINE_ISA(SseKernels, "sse2", 16)
+PLAY_REDUCE_DEFINE_ISA(Avx2Kernels, "avx2", 32)
+PLAY_REDUCE_DEFINE_ISA(Avx512Kernels, "avx512f", 64)
+
+#undef PLAY_REDUCE_DEFINE_ISA
+#endif
+
+template <Op op, typename T>
+T reduceWith(Isa isa, const T* a, const T* b, T mean, size_t n) {
+  switch (resolveIsa(isa)) {
+#ifdef PLAY_X86_SIMD
+    case Isa::AVX512:
+      return Avx512Kernels::reduce<op>(a, b, mean, n);
+    case Isa::AVX2:
+      return Avx2Kernels::reduce<op>(a, b, mean, n);
+    case Isa::SSE:
+      return SseKernels::reduce<op>(a, b, mean, n);
+#endif
+    default:
+      return scalarReduce<op, T, 8>(a, b, mean, n);
+  }
+}
+
+template <typename T>
+T kahanWith(Isa isa, const T* a, size_t n) {
+  switch (resolveIsa(isa)) {
+#ifdef PLAY_X86_SIMD
+    case Isa::AVX512:
+      return Avx512Kernels::kahan(a, n);
+    case Isa::AVX2:
+      return Avx2Kernels::kahan(a, n);
+    case Isa::SSE:
+      return SseKernels::kahan(a, n);
+#endif
+    default:
+      return scalarKahan<T, 4>(a, n);
+  }
+}
+
+// pairwise 求和的叶子大小，叶子内部由向量内核的多路累加完成
+inline constexpr size_t k_pairwise_block = 512;
+
+template <typename T>
+T pairwise(Isa isa, const T* a, size_t n) {
+  if (n <= k_pairwise_block) return reduceWith<Op::Sum>(isa, a, static_cast<const T*>(nullptr), T(0), n);
+  size_t half = n / 2;
+  return pairwise(isa, a, half) + pairwise(isa, a + half, n - half);
+}
+
+// 每个线程至少处理的元素数，低于此值时创建线程的开销超过收益
+inline constexpr size_t k_parallel_grain = size_t(1) << 16;
+
+template <Op op, typename T>
+T parallelReduce(Isa isa, unsigned threads, const T* a, const T* b, T mean, size_t n) {
+  if (n < 2 * k_parallel_grain) return reduceWith<op>(isa, a, b, mean, n);
+  // hardware_concurrency 每次调用都要查询系统，只取一次
+  static const unsigned s_hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+  if (threads == 0) threads = s_hardware_threads;
+  threads = static_cast<unsigned>(std::min<size_t>(threads, n / k_parallel_grain));
+  if (threads <= 1) return reduceWith<op>(isa, a, b, mean, n);
+
+  // 块边界按 64 个元素对齐，避免相邻线程共享缓存行
+  size_t chunk = (n / threads + 63) / 64 * 64;
+  std::vector<T> partial(threads, identity<op, T>());
+  auto work = [&](unsigned t) {
+    size_t begin = std::min(n, t * chunk);
+    size_t end = t + 1 == threads ? n : std::min(n, begin + chunk);
+    partial[t] = reduceWith<op>(isa, a + begin, b ? b + begin : nullptr, mean, end - begin);
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (unsigned t = 1; t < threads; ++t) workers.emplace_back(work, t);
+  work(0);
+  for (auto& worker : workers) worker.join();
+
+  T res = identity<op, T>();
+  for (T x : partial) res = combine<op>(res, x);
+  return res;
+}
+
+template <reducible_range R>
+using value_t = std::ranges::range_value_t<R>;
+
+// 单个范围上的归约
+template <Op op, reducible_range R>
+value_t<R> reduceRange(R const& data, Isa isa) {
+  return reduceWith<op>(isa, std::ranges::data(data), static_cast<const value_t<R>*>(nullptr), value_t<R>(0),
+                        std::ranges::size(data));
+}
+} // namespace _reduce_detail
+
+/// @brief 求和
+template <reducible_range R>
+auto sum(R const& data, Isa isa = Isa::Auto) {
+  return _reduce_detail::reduceRange<_reduce_detail::Op::Sum>(data, isa);
+}
+
+/// @brief 最小值，空范围返回 +inf；含 NaN 时结果未指定
+template <reducible_range R>
+auto minimum(R const& data, Isa isa = Isa::Auto) {
+  return _reduce_detail::reduceRange<_reduce_detail::Op::Min>(data, isa);
+}
+
+/// @brief 最大值，空范围返回 -inf；含 NaN 时结果未指定
+template <reducible_range R>
+auto maximum(R const& data, Isa isa = Isa::Auto) {
+  return _reduce_detail::reduceRange<_reduce_detail::Op::Max>(data, isa);
+}
+
+/// @brief 内积，两个范围长度不同时抛出 std::invalid_argument
+template <reducible_range R1, reducible_range R2>
+  requires std::is_same_v<_reduce_detail::value_t<R1>, _reduce_detail::value_t<R2>>
+auto dot(R1 const& a, R2 const& b, Isa isa = Isa::Auto) {
+  using T = _reduce_detail::value_t<R1>;
+  if (std::ranges::size(a) != std::ranges::size(b)) throw std::invalid_argument("play::reduce::dot: size mismatch");
+  return _reduce_detail::reduceWith<_reduce_detail::Op::Dot>(isa, std::ranges::data(a), std::ranges::data(b), T(0),
+                                                            std::ranges::size(a));
+}
+
+/// @brief 均值与总体方差，两遍扫描（先求均值再求离差平方和）以避免 E[x^2]-E[x]^2 的相消误差
+template <reducible_range R>
+auto meanVariance(R const& data, Isa isa = Isa::Auto) {
+  using T = _reduce_detail::value_t<R>;
+  size_t n = std::ranges::size(data);
+  if (n == 0) return MeanVariance<T>{T(0), T(0)};
+  T mean = sum(data, isa) / static_cast<T>(n);
+  T m2 = _reduce_detail::reduceWith<_reduce_detail::Op::SquaredDiff>(isa, std::ranges::data(data),
+                                                                    static_cast<const T*>(nullptr), mean, n);
+  return MeanVariance<T>{mean, m2 / static_cast<T>(n)};
+}
+
+/// @brief Kahan 补偿求和，误差与元素个数无关，代价约为普通求和的 4 倍运算量
+template <reducible_range R>
+auto sumKahan(R const& data, Isa isa = Isa::Auto) {
+  return _reduce_detail::kahanWith(isa, std::ranges::data(data), std::ranges::size(data));
+}
+
+/// @brief pairwise 求和，误差随 log(n) 增长，速度接近普通求和
+template <reducible_range R>
+auto sumPairwise(R const& data, Isa isa = Isa::Auto) {
+  return _reduce_detail::pairwise(isa, std::ranges::data(data), std::ranges::size(data));
+}
+
+/// @brief 多线程求和，threads 为 0 时使用硬件线程数；小数组直接在当前线程计算
+template <reducible_range R>
+auto parallelSum(R const& data, unsigned threads = 0, Isa isa = Isa::Auto) {
+  using T = _reduce_detail::value_t<R>;
+  return _reduce_detail::parallelReduce<_reduce_detail::Op::Sum>(
+      isa, threads, std::ranges::data(data), static_cast<const T*>(nullptr), T(0), std::ranges::size(data));
+}
+
+template <reducible_range R>
+auto parallelMinimum(R const& data, unsigned threads = 0, Isa isa = Isa::Auto) {
+  using T = _reduce_detail::value_t<R>;
+  return _reduce_detail::parallelReduce<_reduce_detail::Op::Min>(
+      isa, threads, std::ranges::data(data), static_cast<const T*>(nullptr), T(0), std::ranges::size(data));
+}
+
+template <reducible_range R>
+auto parallelMaximum(R const& data, unsigned threads = 0, Isa isa = Isa::Auto) {
+  using T = _reduce_detail::value_t<R>;
+  return _reduce_detail::parallelReduce<_reduce_detail::Op::Max>(
+      isa, threads, std::ranges::data(data), static_cast<const T*>(nullptr), T(0), std::ranges::size(data));
+}
+
+template <reducible_range R1, reducible_range R2>
+  requires std::is_same_v<_reduce_detail::value_t<R1>, _reduce_detail::value_t<R2>>
+auto parallelDot(R1 const& a, R2 const& b, unsigned threads = 0, Isa isa = Isa::Auto) {
+  using T = _reduce_detail::value_t<R1>;
+  if (std::ranges::size(a) != std::ranges::size(b)) {
+    throw std::invalid_argument("play::reduce::parallelDot: size mismatch");
+  }
+  return _reduce_detail::parallelReduce<_reduce_detail::Op::Dot>(isa, threads, std::ranges::data(a),
+                                                                std::ranges::data(b), T(0), std::ranges::size(a));
+}
+} // namespace play::reduce
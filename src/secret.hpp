@@ -0,0 +1,143 @@
+#pragma once
+
+// 保存口令等敏感数据的只移动字符串：容量在构造时确定，之后从不重新分配（不会在堆上留下旧副本），
+// 所在页尽量 mlock 以免被换出到磁盘，析构与 clear 时清零
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace play {
+namespace _secret_detail {
+// 清零且不会被编译器当作死存储消除
+inline void secureZero(void* p, size_t n) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  std::memset(p, 0, n);
+  asm volatile("" : : "r"(p) : "memory");
+#else
+  volatile unsigned char* q = static_cast<volatile unsigned char*>(p);
+  while (n--) *q++ = 0;
+#endif
+}
+
+inline size_t pageSize() noexcept {
+  static const size_t s_page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return s_page;
+}
+} // namespace _secret_detail
+
+using _secret_detail::secureZero;
+
+class SecretString {
+public:
+  SecretString() noexcept = default;
+
+  /// @brief 分配可容纳 capacity 个字符的独占页，分配失败时抛出 std::bad_alloc；
+  /// mlock 失败（如超出 RLIMIT_MEMLOCK）不视为错误，见 locked()
+  explicit SecretString(size_t capacity) {
+    if (capacity == 0) return;
+    size_t page = _secret_detail::pageSize();
+    // 独占整页：munlock 按页生效，与其它对象共用页会解除别人的锁定
+    size_t mapped = (capacity + page - 1) / page * page;
+    void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+    m_data = static_cast<char*>(p);
+    m_mapped = mapped;
+    m_capacity = capacity;
+    m_locked = mlock(p, mapped) == 0;
+#ifdef MADV_DONTDUMP
+    madvise(p, mapped, MADV_DONTDUMP);
+#endif
+  }
+
+  SecretString(const SecretString&) = delete;
+  SecretString& operator=(const SecretString&) = delete;
+
+  SecretString(SecretString&& other) noexcept { swap(other); }
+
+  SecretString& operator=(SecretString&& other) noexcept {
+    if (this != &other) {
+      release();
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~SecretString() { release(); }
+
+  void swap(SecretString& other) noexcept {
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(m_mapped, other.m_mapped);
+    std::swap(m_dropped, other.m_dropped);
+    std::swap(m_locked, other.m_locked);
+  }
+
+  const char* data() const noexcept { return m_data; }
+
+  size_t size() const noexcept { return m_size; }
+
+  size_t capacity() const noexcept { return m_capacity; }
+
+  bool empty() const noexcept { return m_size == 0 && m_dropped == 0; }
+
+  /// @brief 内容的视图；不提供到 std::string_view 的隐式转换，避免被 print 等函数无意中复制或输出
+  std::string_view view() const noexcept { return {m_data, m_size}; }
+
+  /// @brief 是否有字符因超出容量被丢弃
+  bool truncated() const noexcept { return m_dropped > 0; }
+
+  /// @brief 内容所在的页是否已锁定在内存中
+  bool locked() const noexcept { return m_locked; }
+
+  /// @brief 追加字符，超出容量的部分被丢弃但仍计数，使随后的 pop_back 与输入的字符一一对应
+  void append(const char* s, size_t n) noexcept {
+    size_t kept = n < m_capacity - m_size ? n : m_capacity - m_size;
+    if (kept) std::memcpy(m_data + m_size, s, kept);
+    m_size += kept;
+    m_dropped += n - kept;
+  }
+
+  void push_back(char c) noexcept { append(&c, 1); }
+
+  /// @brief 删除最后一个字符（先删除被丢弃的字符）
+  void pop_back() noexcept {
+    if (m_dropped) {
+      --m_dropped;
+    } else if (m_size) {
+      m_data[--m_size] = '\0';
+    }
+  }
+
+  /// @brief 清零已写入的内容，保留容量
+  void clear() noexcept {
+    if (m_data) secureZero(m_data, m_size);
+    m_size = 0;
+    m_dropped = 0;
+  }
+
+private:
+  void release() noexcept {
+    if (!m_data) return;
+    secureZero(m_data, m_capacity);
+    if (m_locked) munlock(m_data, m_mapped);
+    munmap(m_data, m_mapped);
+    m_data = nullptr;
+    m_size = m_capacity = m_mapped = m_dropped = 0;
+    m_locked = false;
+  }
+
+  char* m_data = nullptr;
+  size_t m_size = 0;
+  size_t m_capacity = 0;
+  size_t m_mapped = 0;
+  size_t m_dropped = 0;
+  bool m_locked = false;
+};
+
+} // namespace play
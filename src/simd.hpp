@@ -0,0 +1,42 @@
+#pragma once
+
+// 数值内核共用的指令集检测与 GCC 向量扩展类型
+// 内核以向量扩展编写一份，再由带 __attribute__((target(...))) 的包装函数内联展开，按不同指令集各生成一份代码
+#include <algorithm>
+#include <cstddef>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PLAY_X86_SIMD
+#endif
+
+namespace play {
+/// @brief 内核使用的指令集，按能力递增排列；Auto 表示运行时检测到的最优者
+enum class Isa { Scalar, SSE, AVX2, AVX512, Auto };
+
+/// @brief 当前 CPU（及操作系统）支持的最优指令集，结果在首次调用时缓存
+inline Isa detectIsa() {
+  static const Isa s_isa = [] {
+#ifdef PLAY_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Isa::AVX512;
+    if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+    if (__builtin_cpu_supports("sse2")) return Isa::SSE;
+#endif
+    return Isa::Scalar;
+  }();
+  return s_isa;
+}
+
+/// @brief 请求的指令集不受支持时退回到可用的最优者
+inline Isa resolveIsa(Isa isa) { return std::min(isa, detectIsa()); }
+
+#ifdef PLAY_X86_SIMD
+template <typename T, size_t Bytes>
+struct simd {
+  typedef T type __attribute__((vector_size(Bytes)));
+};
+
+template <typename T, size_t Bytes>
+using simd_t = typename simd<T, Bytes>::type;
+#endif
+} // namespace play
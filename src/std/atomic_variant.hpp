@@ -0,0 +1,330 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#include "variant.hpp"
+
+// x86-64 上用 lock cmpxchg16b 实现 16 字节的原子操作，不依赖 -mcx16 与 libatomic（后者的 16 字节原子操作不保证无锁）
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__) && defined(__GCC_ASM_FLAG_OUTPUTS__)
+#define PLAY_ATOMIC_VARIANT_CX16
+#endif
+
+namespace play {
+namespace _atomic_variant_detail {
+// 打包后的表示：若干个 64 位字，前 k_value_size 个字节存放备选类型的对象（未用到的字节与填充位清零），
+// 其后一个字节存放下标
+template <size_t N>
+using Rep = std::array<uint64_t, N>;
+
+inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+// 由比较/交换的成功序推出失败序，规则同 std::atomic
+constexpr std::memory_order failureOrder(std::memory_order order) noexcept {
+  if (order == std::memory_order_acq_rel) return std::memory_order_acquire;
+  if (order == std::memory_order_release) return std::memory_order_relaxed;
+  return order;
+}
+
+// 顺序锁：写者之间用 m_seq 的 CAS 互斥（奇数表示正在写入），读者不加锁，读到前后不一致的序号时重试
+// 数据按 64 位字逐个以 relaxed 原子操作读写，不构成数据竞争；所有操作至少具有 acquire/release 语义
+template <size_t N>
+class Cell {
+public:
+  static constexpr bool s_lock_free = false;
+
+  explicit Cell(const Rep<N>& rep) noexcept {
+    for (size_t i = 0; i < N; ++i) m_words[i].store(rep[i], std::memory_order_relaxed);
+  }
+
+  Rep<N> load(std::memory_order) const noexcept {
+    Rep<N> res;
+    while (true) {
+      uint64_t seq = m_seq.load(std::memory_order_acquire);
+      if (seq & 1) {
+        cpuRelax();
+        continue;
+      }
+      read(res);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (m_seq.load(std::memory_order_relaxed) == seq) return res;
+    }
+  }
+
+  void store(const Rep<N>& rep, std::memory_order) noexcept {
+    uint64_t seq = lock();
+    write(rep);
+    m_seq.store(seq + 2, std::memory_order_release);
+  }
+
+  Rep<N> exchange(const Rep<N>& rep, std::memory_order) noexcept {
+    Rep<N> old;
+    uint64_t seq = lock();
+    read(old);
+    write(rep);
+    m_seq.store(seq + 2, std::memory_order_release);
+    return old;
+  }
+
+  bool compareExchangeStrong(Rep<N>& expected, const Rep<N>& desired, std::memory_order order,
+                             std::memory_order) noexcept {
+    // 先不加锁读一次：已经不相等时直接失败，不与写者争抢
+    Rep<N> cur = load(order);
+    if (cur != expected) {
+      expected = cur;
+      return false;
+    }
+    uint64_t seq = lock();
+    read(cur);
+    bool ok = cur == expected;
+    if (ok) {
+      write(desired);
+      m_seq.store(seq + 2, std::memory_order_release);
+    } else {
+      m_seq.store(seq, std::memory_order_release);
+      expected = cur;
+    }
+    return ok;
+  }
+
+  bool compareExchangeWeak(Rep<N>& expected, const Rep<N>& desired, std::memory_order success,
+                           std::memory_order failure) noexcept {
+    return compareExchangeStrong(expected, desired, success, failure);
+  }
+
+private:
+  // 返回加锁前的（偶数）序号；未修改数据时以原序号解锁，读者不必重试
+  uint64_t lock() noexcept {
+    uint64_t seq = m_seq.load(std::memory_order_relaxed);
+    while (true) {
+      if (seq & 1) {
+        cpuRelax();
+        seq = m_seq.load(std::memory_order_relaxed);
+      } else if (m_seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    return seq;
+  }
+
+  void read(Rep<N>& out) const noexcept {
+    for (size_t i = 0; i < N; ++i) out[i] = m_words[i].load(std::memory_order_relaxed);
+  }
+
+  void write(const Rep<N>& rep) noexcept {
+    for (size_t i = 0; i < N; ++i) m_words[i].store(rep[i], std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> m_seq{0};
+  std::atomic<uint64_t> m_words[N];
+};
+
+// 8 字节：直接使用 std::atomic<uint64_t>
+template <>
+class Cell<1> {
+public:
+  static constexpr bool s_lock_free = std::atomic<uint64_t>::is_always_lock_free;
+
+  explicit Cell(const Rep<1>& rep) noexcept : m_word(rep[0]) {}
+
+  Rep<1> load(std::memory_order order) const noexcept { return {m_word.load(order)}; }
+
+  void store(const Rep<1>& rep, std::memory_order order) noexcept { m_word.store(rep[0], order); }
+
+  Rep<1> exchange(const Rep<1>& rep, std::memory_order order) noexcept { return {m_word.exchange(rep[0], order)}; }
+
+  bool compareExchangeStrong(Rep<1>& expected, const Rep<1>& desired, std::memory_order success,
+                             std::memory_order failure) noexcept {
+    return m_word.compare_exchange_strong(expected[0], desired[0], success, failure);
+  }
+
+  bool compareExchangeWeak(Rep<1>& expected, const Rep<1>& desired, std::memory_order success,
+                           std::memory_order failure) noexcept {
+    return m_word.compare_exchange_weak(expected[0], desired[0], success, failure);
+  }
+
+private:
+  std::atomic<uint64_t> m_word;
+};
+
+#ifdef PLAY_ATOMIC_VARIANT_CX16
+// 16 字节：所有操作都经由 lock cmpxchg16b，本身即是全屏障，忽略内存序参数
+// x86-64 不保证普通的 16 字节读取是原子的，load 也用 cmpxchg16b 实现（比较值与新值相同），因而读者之间同样争抢缓存行
+template <>
+class Cell<2> {
+public:
+  static constexpr bool s_lock_free = true;
+
+  explicit Cell(const Rep<2>& rep) noexcept
+      : m_storage(static_cast<unsigned __int128>(rep[1]) << 64 | rep[0]) {}
+
+  Rep<2> load(std::memory_order) const noexcept {
+    Rep<2> res{};
+    cas(res, res);
+    return res;
+  }
+
+  void store(const Rep<2>& rep, std::memory_order order) noexcept { exchange(rep, order); }
+
+  Rep<2> exchange(const Rep<2>& rep, std::memory_order) noexcept {
+    // 首次比较通常失败，但会顺带取回当前值
+    Rep<2> old{};
+    while (!cas(old, rep)) {}
+    return old;
+  }
+
+  bool compareExchangeStrong(Rep<2>& expected, const Rep<2>& desired, std::memory_order,
+                             std::memory_order) noexcept {
+    return cas(expected, desired);
+  }
+
+  bool compareExchangeWeak(Rep<2>& expected, const Rep<2>& desired, std::memory_order,
+                           std::memory_order) noexcept {
+    return cas(expected, desired);
+  }
+
+private:
+  // 失败时把当前值写回 expected
+  bool cas(Rep<2>& expected, const Rep<2>& desired) const noexcept {
+    bool ok;
+    asm volatile("lock cmpxchg16b %1"
+                 : "=@ccz"(ok), "+m"(m_storage), "+a"(expected[0]), "+d"(expected[1])
+                 : "b"(desired[0]), "c"(desired[1])
+                 : "memory");
+    return ok;
+  }
+
+  alignas(16) mutable unsigned __int128 m_storage;
+};
+#endif
+
+template <typename... Ts>
+inline constexpr size_t k_value_size = std::max({sizeof(Ts)...});
+
+template <typename... Ts>
+inline constexpr size_t k_words = (k_value_size<Ts...> + 1 + 7) / 8;
+} // namespace _atomic_variant_detail
+
+/// @brief 备选类型均可平凡复制的 Variant 的原子版本，接口同 std::atomic<Variant<Ts...>>
+/// 值与下标打包在一起：总大小不超过 8 字节时基于 std::atomic<uint64_t>，不超过 16 字节时（x86-64）基于 cmpxchg16b，
+/// 两者都是无锁的；更大时退化为顺序锁，读者不加锁但可能因写者而重试，写者之间自旋互斥
+/// compare_exchange 与 std::atomic 一样按对象表示逐字节比较（填充位不参与），如 0.0 与 -0.0 不相等
+template <typename... Ts>
+class AtomicVariant {
+  static_assert((std::is_trivially_copyable_v<Ts> && ...), "AtomicVariant requires trivially copyable alternatives");
+  static_assert(sizeof...(Ts) < 256, "AtomicVariant stores the index in one byte");
+
+  static constexpr size_t s_value_size = _atomic_variant_detail::k_value_size<Ts...>;
+  static constexpr size_t s_words = _atomic_variant_detail::k_words<Ts...>;
+
+  using Rep = _atomic_variant_detail::Rep<s_words>;
+  using Cell = _atomic_variant_detail::Cell<s_words>;
+
+public:
+  using value_type = Variant<Ts...>;
+
+  static constexpr bool is_always_lock_free = Cell::s_lock_free;
+
+  AtomicVariant() noexcept(std::is_nothrow_default_constructible_v<value_type>)
+    requires std::is_default_constructible_v<value_type>
+      : AtomicVariant(value_type()) {}
+
+  AtomicVariant(const value_type& value) noexcept : m_cell(encode(value)) {}
+
+  AtomicVariant(const AtomicVariant&) = delete;
+  AtomicVariant& operator=(const AtomicVariant&) = delete;
+
+  bool is_lock_free() const noexcept { return is_always_lock_free; }
+
+  value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+    return decode(m_cell.load(order));
+  }
+
+  void store(const value_type& value, std::memory_order order = std::memory_order_seq_cst) noexcept {
+    m_cell.store(encode(value), order);
+  }
+
+  value_type exchange(const value_type& value, std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return decode(m_cell.exchange(encode(value), order));
+  }
+
+  bool compare_exchange_strong(value_type& expected, const value_type& desired, std::memory_order success,
+                               std::memory_order failure) noexcept {
+    Rep rep = encode(expected);
+    if (m_cell.compareExchangeStrong(rep, encode(desired), success, failure)) return true;
+    expected = decode(rep);
+    return false;
+  }
+
+  bool compare_exchange_strong(value_type& expected, const value_type& desired,
+                               std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return compare_exchange_strong(expected, desired, order, _atomic_variant_detail::failureOrder(order));
+  }
+
+  bool compare_exchange_weak(value_type& expected, const value_type& desired, std::memory_order success,
+                             std::memory_order failure) noexcept {
+    Rep rep = encode(expected);
+    if (m_cell.compareExchangeWeak(rep, encode(desired), success, failure)) return true;
+    expected = decode(rep);
+    return false;
+  }
+
+  bool compare_exchange_weak(value_type& expected, const value_type& desired,
+                             std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return compare_exchange_weak(expected, desired, order, _atomic_variant_detail::failureOrder(order));
+  }
+
+private:
+  static Rep encode(const value_type& value) noexcept {
+    Rep rep{};
+    auto* bytes = reinterpret_cast<unsigned char*>(rep.data());
+    play::visit(
+        [bytes](const auto& alt) {
+          using T = remove_cvref_t<decltype(alt)>;
+          // 空类型只占一个填充字节，保持为 0；其余先复制到临时缓冲区清除填充位，保证相等的值打包后逐字节相等
+          if constexpr (!std::is_empty_v<T>) {
+            alignas(T) unsigned char buf[sizeof(T)];
+            std::memcpy(buf, &alt, sizeof(T));
+#if __has_builtin(__builtin_clear_padding)
+            __builtin_clear_padding(std::launder(reinterpret_cast<T*>(buf)));
+#endif
+            std::memcpy(bytes, buf, sizeof(T));
+          }
+        },
+        value);
+    bytes[s_value_size] = static_cast<unsigned char>(value.index());
+    return rep;
+  }
+
+  static value_type decode(const Rep& rep) noexcept {
+    auto* bytes = reinterpret_cast<const unsigned char*>(rep.data());
+    return decodeFrom<0>(bytes, bytes[s_value_size]);
+  }
+
+  template <size_t I>
+  static value_type decodeFrom(const unsigned char* bytes, size_t index) noexcept {
+    if constexpr (I + 1 < sizeof...(Ts)) {
+      if (index != I) return decodeFrom<I + 1>(bytes, index);
+    }
+    using T = variant_alternative_t<I, value_type>;
+    alignas(T) unsigned char buf[sizeof(T)];
+    std::memcpy(buf, bytes, sizeof(T));
+    return value_type(in_place_index<I>, *std::launder(reinterpret_cast<const T*>(buf)));
+  }
+
+  Cell m_cell;
+};
+} // namespace play
+
+#undef PLAY_ATOMIC_VARIANT_CX16
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "memory.hpp"
+#include "relocate.hpp"
+#include "trait.hpp"
+
+namespace play {
+// 默认的分配策略：带对齐的全局 operator new/delete
+struct NewDeleteBoxPool {
+  static void* allocate(size_t bytes, size_t align) { return ::operator new(bytes, std::align_val_t(align)); }
+
+  static void deallocate(void* p, size_t bytes, size_t align) noexcept {
+    ::operator delete(p, bytes, std::align_val_t(align));
+  }
+};
+
+// 把具有静态存储期的分配器对象（如 play::Pool、play::ThreadCachingPool）适配为分配策略：
+//   inline play::Pool g_big_pool(sizeof(Big));
+//   using BoxedBig = play::Boxed<Big, play::AllocatorBoxPool<g_big_pool>>;
+template <auto& alloc>
+struct AllocatorBoxPool {
+  static void* allocate(size_t bytes, size_t align) { return alloc.allocate(bytes, align); }
+
+  static void deallocate(void* p, size_t bytes, size_t align) noexcept { alloc.deallocate(p, bytes, align); }
+};
+
+/// @brief 把 T 存放在堆上（经由 Pool 分配）的值语义包装，大小只有一个指针
+/// 作为 Variant 的备选类型时对使用者透明：get/get_if/visit/match 得到的都是 T，按 T 查找与构造备选类型
+/// 拷贝时深拷贝；移动时转移指针，不分配也不抛异常，被移动后的对象为空，只能赋值或析构，解引用是未定义行为（有断言）；
+/// 装着 Boxed 的 Variant 被移动后同样如此，这是与不装箱时唯一的区别
+/// Pool 须提供静态的 allocate(bytes, align) 与 deallocate(p, bytes, align)
+template <typename T, typename Pool = NewDeleteBoxPool>
+class Boxed {
+public:
+  using value_type = T;
+  using pool_type = Pool;
+
+  template <typename... Args>
+    requires(!(sizeof...(Args) == 1 && (std::is_same_v<remove_cvref_t<Args>, Boxed> && ...)) &&
+             std::is_constructible_v<T, Args...>)
+  Boxed(Args&&... args) : m_ptr(create(std::forward<Args>(args)...)) {}
+
+  Boxed(const Boxed& rhs)
+    requires std::is_copy_constructible_v<T>
+      : m_ptr(rhs.m_ptr ? create(*rhs.m_ptr) : nullptr) {}
+
+  Boxed(Boxed&& rhs) noexcept : m_ptr(std::exchange(rhs.m_ptr, nullptr)) {}
+
+  // 两者都非空时直接赋值给已有的 T，不重新分配
+  Boxed& operator=(const Boxed& rhs)
+    requires std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T>
+  {
+    if (!rhs.m_ptr) {
+      reset();
+    } else if (m_ptr) {
+      *m_ptr = *rhs.m_ptr;
+    } else {
+      m_ptr = create(*rhs.m_ptr);
+    }
+    return *this;
+  }
+
+  Boxed& operator=(Boxed&& rhs) noexcept {
+    if (this != &rhs) {
+      reset();
+      m_ptr = std::exchange(rhs.m_ptr, nullptr);
+    }
+    return *this;
+  }
+
+  template <typename U>
+    requires(!std::is_same_v<remove_cvref_t<U>, Boxed> && std::is_constructible_v<T, U> &&
+             std::is_assignable_v<T&, U>)
+  Boxed& operator=(U&& rhs) {
+    if (m_ptr) {
+      *m_ptr = std::forward<U>(rhs);
+    } else {
+      m_ptr = create(std::forward<U>(rhs));
+    }
+    return *this;
+  }
+
+  ~Boxed() { reset(); }
+
+  /// @brief 是否为空（仅在被移动后为空）
+  bool empty() const noexcept { return m_ptr == nullptr; }
+
+  T& operator*() & noexcept {
+    assert(m_ptr && "dereferencing a moved-from Boxed");
+    return *m_ptr;
+  }
+
+  const T& operator*() const& noexcept {
+    assert(m_ptr && "dereferencing a moved-from Boxed");
+    return *m_ptr;
+  }
+
+  T&& operator*() && noexcept {
+    assert(m_ptr && "dereferencing a moved-from Boxed");
+    return std::move(*m_ptr);
+  }
+
+  const T&& operator*() const&& noexcept {
+    assert(m_ptr && "dereferencing a moved-from Boxed");
+    return std::move(*m_ptr);
+  }
+
+  T* operator->() noexcept {
+    assert(m_ptr && "dereferencing a moved-from Boxed");
+    return m_ptr;
+  }
+
+  const T* operator->() const noexcept {
+    assert(m_ptr && "dereferencing a moved-from Boxed");
+    return m_ptr;
+  }
+
+  friend void swap(Boxed& lhs, Boxed& rhs) noexcept { std::swap(lhs.m_ptr, rhs.m_ptr); }
+
+  friend bool operator==(const Boxed& lhs, const Boxed& rhs)
+    requires requires(const T& t) { t == t; }
+  {
+    if (!lhs.m_ptr || !rhs.m_ptr) return lhs.m_ptr == rhs.m_ptr;
+    return *lhs.m_ptr == *rhs.m_ptr;
+  }
+
+private:
+  template <typename... Args>
+  static T* create(Args&&... args) {
+    void* p = Pool::allocate(sizeof(T), alignof(T));
+    try {
+      return play::construct_at(static_cast<T*>(p), std::forward<Args>(args)...);
+    } catch (...) {
+      Pool::deallocate(p, sizeof(T), alignof(T));
+      throw;
+    }
+  }
+
+  void reset() noexcept {
+    if (m_ptr) {
+      std::destroy_at(m_ptr);
+      Pool::deallocate(m_ptr, sizeof(T), alignof(T));
+      m_ptr = nullptr;
+    }
+  }
+
+  T* m_ptr;
+};
+
+// 只持有一个堆指针
+template <typename T, typename Pool>
+struct is_trivially_relocatable<Boxed<T, Pool>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_boxed_v = false;
+
+template <typename T, typename Pool>
+inline constexpr bool is_boxed_v<Boxed<T, Pool>> = true;
+
+template <typename T>
+struct unbox {
+  using type = T;
+};
+
+template <typename T, typename Pool>
+struct unbox<Boxed<T, Pool>> {
+  using type = T;
+};
+
+template <typename T>
+using unbox_t = typename unbox<T>::type;
+
+// 按大小自动选择：超过 limit 字节的类型装箱，其余原样存放，如 Variant<boxed_if_larger_t<Ts, 64>...>
+template <typename T, size_t limit, typename Pool = NewDeleteBoxPool>
+using boxed_if_larger_t = std::conditional_t<(sizeof(T) > limit), Boxed<T, Pool>, T>;
+
+/// @brief 取出被装箱的值（保持值类别），其它类型原样转发；被移动后为空的 Boxed 不能取值
+template <typename T>
+constexpr decltype(auto) unboxed(T&& value) noexcept {
+  if constexpr (is_boxed_v<remove_cvref_t<T>>) {
+    assert(!value.empty() && "unboxing a moved-from Boxed");
+    return *std::forward<T>(value);
+  } else {
+    return std::forward<T>(value);
+  }
+}
+} // namespace play
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "small_vector.hpp"
+
+namespace play {
+/// @brief 带内联缓冲区的字符串：不超过 N 个字符时不分配堆内存，超过后迁移到堆上
+/// 内部以 SmallVector<char, N + 1> 存储并始终以 '\0' 结尾，c_str() 可直接交给 C 接口
+template <size_t N>
+class InlineString {
+public:
+  using value_type = char;
+  using size_type = size_t;
+  using traits_type = std::char_traits<char>;
+  using iterator = char*;
+  using const_iterator = const char*;
+
+  static constexpr size_t npos = std::string_view::npos;
+  static constexpr size_t s_inline_capacity = N;
+
+  InlineString() { m_chars.push_back('\0'); }
+
+  InlineString(const InlineString&) = default;
+
+  // 被移动后的 SmallVector 为空，补上结尾的 '\0'（内联缓冲区非空，不会分配）
+  InlineString(InlineString&& rhs) noexcept : m_chars(std::move(rhs.m_chars)) { rhs.m_chars.push_back('\0'); }
+
+  InlineString& operator=(const InlineString&) = default;
+
+  InlineString& operator=(InlineString&& rhs) noexcept {
+    if (this != &rhs) {
+      m_chars = std::move(rhs.m_chars);
+      rhs.m_chars.push_back('\0');
+    }
+    return *this;
+  }
+
+  InlineString(const char* s) : InlineString(std::string_view(s)) {}
+
+  InlineString(const char* s, size_t count) : InlineString(std::string_view(s, count)) {}
+
+  explicit InlineString(std::string_view sv) {
+    m_chars.reserve(sv.size() + 1);
+    m_chars.append(sv.begin(), sv.end());
+    m_chars.push_back('\0');
+  }
+
+  explicit InlineString(const std::string& s) : InlineString(std::string_view(s)) {}
+
+  InlineString(size_t count, char ch) : m_chars(count, ch) { m_chars.push_back('\0'); }
+
+  InlineString& operator=(std::string_view sv) {
+    clear();
+    return append(sv);
+  }
+
+  InlineString& operator=(const char* s) { return *this = std::string_view(s); }
+
+  char& operator[](size_t i) noexcept { return m_chars[i]; }
+
+  const char& operator[](size_t i) const noexcept { return m_chars[i]; }
+
+  char& front() noexcept { return m_chars.front(); }
+
+  const char& front() const noexcept { return m_chars.front(); }
+
+  char& back() noexcept { return m_chars[size() - 1]; }
+
+  const char& back() const noexcept { return m_chars[size() - 1]; }
+
+  char* data() noexcept { return m_chars.data(); }
+
+  const char* data() const noexcept { return m_chars.data(); }
+
+  const char* c_str() const noexcept { return m_chars.data(); }
+
+  operator std::string_view() const noexcept { return {data(), size()}; }
+
+  std::string_view view() const noexcept { return {data(), size()}; }
+
+  std::string str() const { return std::string(data(), size()); }
+
+  iterator begin() noexcept { return data(); }
+
+  const_iterator begin() const noexcept { return data(); }
+
+  iterator end() noexcept { return data() + size(); }
+
+  const_iterator end() const noexcept { return data() + size(); }
+
+  bool empty() const noexcept { return size() == 0; }
+
+  size_t size() const noexcept { return m_chars.size() - 1; }
+
+  size_t length() const noexcept { return size(); }
+
+  size_t capacity() const noexcept { return m_chars.capacity() - 1; }
+
+  bool isInline() const noexcept { return m_chars.isInline(); }
+
+  void reserve(size_t capacity) { m_chars.reserve(capacity + 1); }
+
+  void shrink_to_fit() { m_chars.shrink_to_fit(); }
+
+  void clear() noexcept {
+    m_chars.clear();
+    m_chars.push_back('\0');
+  }
+
+  void resize(size_t count, char ch = '\0') {
+    m_chars.pop_back();
+    m_chars.resize(count, ch);
+    m_chars.push_back('\0');
+  }
+
+  void push_back(char ch) {
+    m_chars.back() = ch;
+    m_chars.push_back('\0');
+  }
+
+  void pop_back() noexcept {
+    m_chars.pop_back();
+    m_chars.back() = '\0';
+  }
+
+  InlineString& append(std::string_view sv) {
+    size_t required = m_chars.size() + sv.size();
+    if (required > m_chars.capacity()) {
+      // sv 可能指向自身，扩容前先记下偏移
+      bool aliased = sv.data() >= data() && sv.data() <= data() + size();
+      size_t offset = aliased ? sv.data() - data() : 0;
+      m_chars.reserve(std::max(required, m_chars.capacity() * 2));
+      if (aliased) sv = std::string_view(data() + offset, sv.size());
+    }
+    m_chars.pop_back();
+    m_chars.append(sv.begin(), sv.end());
+    m_chars.push_back('\0');
+    return *this;
+  }
+
+  InlineString& append(size_t count, char ch) {
+    resize(size() + count, ch);
+    return *this;
+  }
+
+  InlineString& operator+=(std::string_view sv) { return append(sv); }
+
+  InlineString& operator+=(const char* s) { return append(std::string_view(s)); }
+
+  InlineString& operator+=(char ch) {
+    push_back(ch);
+    return *this;
+  }
+
+  int compare(std::string_view sv) const noexcept { return view().compare(sv); }
+
+  size_t find(std::string_view sv, size_t pos = 0) const noexcept { return view().find(sv, pos); }
+
+  size_t find(char ch, size_t pos = 0) const noexcept { return view().find(ch, pos); }
+
+  std::string_view substr(size_t pos, size_t count = npos) const { return view().substr(pos, count); }
+
+  void swap(InlineString& rhs) noexcept { m_chars.swap(rhs.m_chars); }
+
+  friend void swap(InlineString& lhs, InlineString& rhs) noexcept { lhs.swap(rhs); }
+
+  friend bool operator==(const InlineString& lhs, const InlineString& rhs) noexcept { return lhs.view() == rhs.view(); }
+
+  friend bool operator==(const InlineString& lhs, std::string_view rhs) noexcept { return lhs.view() == rhs; }
+
+  friend bool operator==(const InlineString& lhs, const char* rhs) noexcept { return lhs.view() == rhs; }
+
+  friend std::strong_ordering operator<=>(const InlineString& lhs, const InlineString& rhs) noexcept {
+    return lhs.view() <=> rhs.view();
+  }
+
+  friend std::strong_ordering operator<=>(const InlineString& lhs, std::string_view rhs) noexcept {
+    return lhs.view() <=> rhs;
+  }
+
+  friend std::strong_ordering operator<=>(const InlineString& lhs, const char* rhs) noexcept {
+    return lhs.view() <=> std::string_view(rhs);
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const InlineString& s) { return os << s.view(); }
+
+private:
+  SmallVector<char, N + 1> m_chars;
+};
+} // namespace play
+
+template <size_t N>
+struct std::hash<play::InlineString<N>> {
+  size_t operator()(const play::InlineString<N>& s) const noexcept { return std::hash<std::string_view>()(s.view()); }
+};
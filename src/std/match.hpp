@@ -0,0 +1,61 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "variant.hpp"
+
+namespace play {
+// 将多个可调用对象合并为一个重载集
+template <typename... Fs>
+struct Overloaded : Fs... {
+  using Fs::operator()...;
+};
+
+template <typename... Fs>
+Overloaded(Fs...) -> Overloaded<Fs...>;
+
+namespace _match_detail {
+template <typename Visitor, typename V, typename IdxSeq>
+struct match_traits;
+
+template <typename Visitor, typename V, size_t... Is>
+struct match_traits<Visitor, V, std::index_sequence<Is...>> {
+  template <size_t I>
+  using alt_ref_t = decltype(play::unboxed(_variant_detail::get<I>(std::declval<V>())));
+
+  // 每个备选类型是否都有可匹配的分支
+  static constexpr bool s_exhaustive = (std::is_invocable_v<Visitor, alt_ref_t<Is>> && ...);
+};
+
+template <typename Visitor, typename V, typename IdxSeq, typename = void>
+struct common_result {};
+
+// 各分支的返回值类型不必相同，只要存在公共类型即可
+template <typename Visitor, typename V, size_t... Is>
+struct common_result<
+    Visitor, V, std::index_sequence<Is...>,
+    std::void_t<std::common_type_t<std::invoke_result_t<
+        Visitor, typename match_traits<Visitor, V, std::index_sequence<Is...>>::template alt_ref_t<Is>>...>>> {
+  using type = std::common_type_t<std::invoke_result_t<
+      Visitor, typename match_traits<Visitor, V, std::index_sequence<Is...>>::template alt_ref_t<Is>>...>;
+};
+} // namespace _match_detail
+
+/// @brief 模式匹配：以 fs 构成的重载集访问 var，编译期检查是否覆盖了所有备选类型
+/// 始终通过 switch 分派（而非函数指针跳转表），便于编译器内联各分支
+template <typename V, typename... Fs>
+constexpr decltype(auto) match(V&& var, Fs&&... fs) {
+  using Visitor = Overloaded<std::decay_t<Fs>...>;
+  using IdxSeq = std::make_index_sequence<variant_size_v<V>>;
+  static_assert(_match_detail::match_traits<Visitor, V&&, IdxSeq>::s_exhaustive,
+                "play::match requires a branch for every alternative of the variant");
+  static_assert(!_match_detail::match_traits<Visitor, V&&, IdxSeq>::s_exhaustive ||
+                    requires { typename _match_detail::common_result<Visitor, V&&, IdxSeq>::type; },
+                "play::match requires the results of all branches to have a common type");
+  using Ret = typename _match_detail::common_result<Visitor, V&&, IdxSeq>::type;
+
+  if (var.valueless_by_exception()) throwBadVariantAccess("play::match: variant is valueless");
+  return _variant_detail::switchVisit<Ret, 0>(Visitor{std::forward<Fs>(fs)...}, std::forward<V>(var));
+}
+} // namespace play
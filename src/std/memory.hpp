@@ -1,10 +1,12 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 
 namespace play {
+// C++20 起 std::construct_at 可在常量求值中使用，placement new 则不行
 template <typename T, typename... Args>
-inline void construct_at(T* p, Args&&... args) {
-  new ((void*)p) T(std::forward<Args>(args)...);
+constexpr T* construct_at(T* p, Args&&... args) {
+  return std::construct_at(p, std::forward<Args>(args)...);
 }
 } // namespace play
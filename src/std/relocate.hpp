@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace play {
+/// @brief T 是否可平凡迁移：把对象按字节复制到新地址、且不再对原对象调用析构，等价于移动构造后析构原对象
+/// 默认只有平凡复制（或平凡移动构造且平凡析构）的类型满足；对象内没有指向自身的指针、也不把自身地址登记到别处的类型
+/// 可以特化为 true，如只持有堆指针的句柄类型。play 的 Variant、Boxed 在各自的头文件中特化
+template <typename T>
+struct is_trivially_relocatable
+    : std::bool_constant<std::is_trivially_copyable_v<T> ||
+                         (std::is_trivially_move_constructible_v<T> && std::is_trivially_destructible_v<T>)> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+template <typename T>
+struct is_trivially_relocatable<const T> : is_trivially_relocatable<T> {};
+
+// 标准库中只持有堆指针的类型
+template <typename T, typename D>
+struct is_trivially_relocatable<std::unique_ptr<T, D>> : is_trivially_relocatable<D> {};
+
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <typename T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+
+template <typename T1, typename T2>
+struct is_trivially_relocatable<std::pair<T1, T2>>
+    : std::conjunction<is_trivially_relocatable<T1>, is_trivially_relocatable<T2>> {};
+
+template <typename... Ts>
+struct is_trivially_relocatable<std::tuple<Ts...>> : std::conjunction<is_trivially_relocatable<Ts>...> {};
+
+template <typename T, size_t N>
+struct is_trivially_relocatable<std::array<T, N>> : is_trivially_relocatable<T> {};
+
+template <typename T>
+struct is_trivially_relocatable<std::optional<T>> : is_trivially_relocatable<T> {};
+
+// libstdc++ 与 libc++ 的 vector 只有三个指针；MSVC 的调试迭代器会登记容器地址，不能按字节迁移
+#if defined(__GLIBCXX__) || defined(_LIBCPP_VERSION)
+template <typename T>
+struct is_trivially_relocatable<std::vector<T, std::allocator<T>>> : std::true_type {};
+#endif
+
+// libstdc++ 的 std::string 短字符串时数据指针指向对象内部的缓冲区，不可平凡迁移；libc++ 的短字符串布局与地址无关
+#ifdef _LIBCPP_VERSION
+template <typename C, typename Traits>
+struct is_trivially_relocatable<std::basic_string<C, Traits, std::allocator<C>>> : std::true_type {};
+#endif
+
+/// @brief 把 [first, last) 中的对象迁移到 dest 开始的未初始化内存，返回 dest 的尾后位置，结束后源区间不再有对象
+/// 可平凡迁移的类型整段 memmove，两个区间可以重叠；其它类型先逐个移动构造再析构源对象，两个区间不能重叠，
+/// 移动构造抛出异常时已构造的目标对象被析构，源对象保持原状（可能已被移动过）
+template <typename T>
+T* uninitialized_relocate(T* first, T* last, T* dest) noexcept(is_trivially_relocatable_v<T> ||
+                                                                std::is_nothrow_move_constructible_v<T>) {
+  if constexpr (is_trivially_relocatable_v<T>) {
+    auto count = static_cast<size_t>(last - first);
+    if (count) std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), count * sizeof(T));
+    return dest + count;
+  } else {
+    T* res = std::uninitialized_move(first, last, dest);
+    std::destroy(first, last);
+    return res;
+  }
+}
+
+/// @brief 迁移单个对象，src 与 dest 不能重叠
+template <typename T>
+T* relocate_at(T* src, T* dest) noexcept(is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>) {
+  if constexpr (is_trivially_relocatable_v<T>) {
+    std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), sizeof(T));
+    return dest;
+  } else {
+    T* res = std::construct_at(dest, std::move(*src));
+    std::destroy_at(src);
+    return res;
+  }
+}
+} // namespace play
@@ -0,0 +1,431 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "enable_smfs.hpp"
+#include "memory.hpp"
+#include "relocate.hpp"
+
+namespace play {
+namespace _small_vector_detail {
+// 存储与特殊成员函数：元素不超过 N 个时存放在内联缓冲区中，超过后整体迁移到堆上
+// 拷贝/移动是否可用由 SmallVector 继承的 EnableCopyMove 决定，这里只负责实现
+template <typename T, size_t N>
+class SmallVectorBase {
+public:
+  static_assert(N > 0, "SmallVector must have inline capacity");
+
+  SmallVectorBase() noexcept : m_data(inlineData()) {}
+
+  SmallVectorBase(const SmallVectorBase& rhs) : SmallVectorBase() {
+    reserve(rhs.m_size);
+    std::uninitialized_copy(rhs.m_data, rhs.m_data + rhs.m_size, m_data);
+    m_size = rhs.m_size;
+  }
+
+  SmallVectorBase(SmallVectorBase&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) : SmallVectorBase() {
+    if (!rhs.isInline()) {
+      steal(rhs);
+      return;
+    }
+    play::uninitialized_relocate(rhs.m_data, rhs.m_data + rhs.m_size, m_data);
+    m_size = std::exchange(rhs.m_size, 0);
+  }
+
+  SmallVectorBase& operator=(const SmallVectorBase& rhs) {
+    if (this != &rhs) assign(rhs.m_data, rhs.m_data + rhs.m_size);
+    return *this;
+  }
+
+  SmallVectorBase& operator=(SmallVectorBase&& rhs) noexcept(std::is_nothrow_move_constructible_v<T> &&
+                                                              std::is_nothrow_move_assignable_v<T>) {
+    if (this == &rhs) return *this;
+    if (!rhs.isInline()) {
+      clear();
+      deallocate();
+      steal(rhs);
+      return *this;
+    }
+    assign(std::make_move_iterator(rhs.m_data), std::make_move_iterator(rhs.m_data + rhs.m_size));
+    rhs.clear();
+    return *this;
+  }
+
+  ~SmallVectorBase() {
+    std::destroy(m_data, m_data + m_size);
+    deallocate();
+  }
+
+  void reserve(size_t capacity) {
+    if (capacity > m_capacity) reallocate(capacity);
+  }
+
+  void clear() noexcept {
+    std::destroy(m_data, m_data + m_size);
+    m_size = 0;
+  }
+
+  bool isInline() const noexcept { return m_data == inlineData(); }
+
+protected:
+  T* inlineData() noexcept { return m_inline; }
+
+  const T* inlineData() const noexcept { return m_inline; }
+
+  // 复用已构造的元素赋值，其余部分构造或析构
+  template <typename It>
+  void assign(It first, It last) {
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    if (count > m_capacity) {
+      clear();
+      reallocate(count);
+    }
+    size_t common = std::min(count, m_size);
+    It mid = std::next(first, common);
+    std::copy(first, mid, m_data);
+    if (count > m_size) {
+      std::uninitialized_copy(mid, last, m_data + m_size);
+    } else {
+      std::destroy(m_data + count, m_data + m_size);
+    }
+    m_size = count;
+  }
+
+  size_t nextCapacity(size_t required) const noexcept { return std::max(m_capacity * 2, required); }
+
+  // 迁移到容量为 capacity 的堆内存
+  void reallocate(size_t capacity) {
+    T* data = std::allocator<T>().allocate(capacity);
+    try {
+      relocate(data);
+    } catch (...) {
+      std::allocator<T>().deallocate(data, capacity);
+      throw;
+    }
+    m_data = data;
+    m_capacity = capacity;
+  }
+
+  // 把元素迁移到 data 并释放原有的堆内存；可平凡迁移的元素整段 memcpy，移动构造不抛出异常或不可拷贝时移动，
+  // 否则拷贝以保证强异常安全。抛出异常时原有元素不变，data 由调用者释放
+  void relocate(T* data) {
+    if constexpr (is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T> ||
+                  !std::is_copy_constructible_v<T>) {
+      play::uninitialized_relocate(m_data, m_data + m_size, data);
+    } else {
+      std::uninitialized_copy(m_data, m_data + m_size, data);
+      std::destroy(m_data, m_data + m_size);
+    }
+    deallocate();
+  }
+
+  void deallocate() noexcept {
+    if (!isInline()) std::allocator<T>().deallocate(m_data, m_capacity);
+    m_data = inlineData();
+    m_capacity = N;
+  }
+
+  void steal(SmallVectorBase& rhs) noexcept {
+    m_data = std::exchange(rhs.m_data, rhs.inlineData());
+    m_size = std::exchange(rhs.m_size, 0);
+    m_capacity = std::exchange(rhs.m_capacity, N);
+  }
+
+  T* m_data;
+  size_t m_size = 0;
+  size_t m_capacity = N;
+
+  // 匿名 union 只提供存储，元素的构造与析构由上面的成员函数负责
+  union {
+    T m_inline[N];
+  };
+};
+} // namespace _small_vector_detail
+
+/// @brief 带内联缓冲区的 vector：不超过 N 个元素时不分配堆内存，超过后迁移到堆上
+/// 迁移后即使元素减少也留在堆上，直到 shrink_to_fit
+/// 迭代器与引用在扩容、插入、删除以及移动构造/赋值后失效
+template <typename T, size_t N>
+class SmallVector
+    : private _small_vector_detail::SmallVectorBase<T, N>,
+      private EnableCopyMove<std::is_copy_constructible_v<T>,
+                             std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T>,
+                             std::is_move_constructible_v<T>,
+                             std::is_move_constructible_v<T> && std::is_move_assignable_v<T>, SmallVector<T, N>> {
+  using BaseT = _small_vector_detail::SmallVectorBase<T, N>;
+
+public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  static constexpr size_t s_inline_capacity = N;
+
+  SmallVector() = default;
+  SmallVector(const SmallVector&) = default;
+  SmallVector(SmallVector&&) = default;
+  SmallVector& operator=(const SmallVector&) = default;
+  SmallVector& operator=(SmallVector&&) = default;
+  ~SmallVector() = default;
+
+  explicit SmallVector(size_t count) { resize(count); }
+
+  SmallVector(size_t count, const T& value) { resize(count, value); }
+
+  template <std::input_iterator It>
+  SmallVector(It first, It last) {
+    append(first, last);
+  }
+
+  SmallVector(std::initializer_list<T> init) { append(init.begin(), init.end()); }
+
+  SmallVector& operator=(std::initializer_list<T> init) {
+    this->assign(init.begin(), init.end());
+    return *this;
+  }
+
+  T& operator[](size_t i) noexcept { return this->m_data[i]; }
+
+  const T& operator[](size_t i) const noexcept { return this->m_data[i]; }
+
+  T& at(size_t i) {
+    if (i >= this->m_size) throw std::out_of_range("SmallVector::at");
+    return this->m_data[i];
+  }
+
+  const T& at(size_t i) const {
+    if (i >= this->m_size) throw std::out_of_range("SmallVector::at");
+    return this->m_data[i];
+  }
+
+  T& front() noexcept { return this->m_data[0]; }
+
+  const T& front() const noexcept { return this->m_data[0]; }
+
+  T& back() noexcept { return this->m_data[this->m_size - 1]; }
+
+  const T& back() const noexcept { return this->m_data[this->m_size - 1]; }
+
+  T* data() noexcept { return this->m_data; }
+
+  const T* data() const noexcept { return this->m_data; }
+
+  iterator begin() noexcept { return this->m_data; }
+
+  const_iterator begin() const noexcept { return this->m_data; }
+
+  const_iterator cbegin() const noexcept { return this->m_data; }
+
+  iterator end() noexcept { return this->m_data + this->m_size; }
+
+  const_iterator end() const noexcept { return this->m_data + this->m_size; }
+
+  const_iterator cend() const noexcept { return this->m_data + this->m_size; }
+
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+  bool empty() const noexcept { return this->m_size == 0; }
+
+  size_t size() const noexcept { return this->m_size; }
+
+  size_t capacity() const noexcept { return this->m_capacity; }
+
+  size_t max_size() const noexcept { return std::allocator_traits<std::allocator<T>>::max_size(std::allocator<T>()); }
+
+  using BaseT::clear;
+  using BaseT::isInline;
+  using BaseT::reserve;
+
+  /// @brief 元素个数不超过 N 时迁回内联缓冲区，否则把堆内存收缩到恰好容纳全部元素
+  void shrink_to_fit() {
+    if (this->isInline() || this->m_size == this->m_capacity) return;
+    if (this->m_size > N) {
+      this->reallocate(this->m_size);
+      return;
+    }
+    T* heap = this->m_data;
+    size_t capacity = this->m_capacity;
+    play::uninitialized_relocate(heap, heap + this->m_size, this->inlineData());
+    std::allocator<T>().deallocate(heap, capacity);
+    this->m_data = this->inlineData();
+    this->m_capacity = N;
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (this->m_size < this->m_capacity) [[likely]] {
+      T* p = play::construct_at(this->m_data + this->m_size, std::forward<Args>(args)...);
+      ++this->m_size;
+      return *p;
+    }
+    return growAndEmplaceBack(std::forward<Args>(args)...);
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void pop_back() noexcept {
+    --this->m_size;
+    std::destroy_at(this->m_data + this->m_size);
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    size_t index = pos - begin();
+    emplace_back(std::forward<Args>(args)...);
+    if constexpr (is_trivially_relocatable_v<T>) {
+      // 新元素暂存到栈上，其后的元素整段后移一位，不经过移动构造与析构
+      alignas(T) unsigned char buf[sizeof(T)];
+      T* tmp = reinterpret_cast<T*>(buf);
+      T* last = end() - 1;
+      play::relocate_at(last, tmp);
+      play::uninitialized_relocate(begin() + index, last, begin() + index + 1);
+      play::relocate_at(tmp, begin() + index);
+    } else if (index + 1 < this->m_size) {
+      // 新元素移到临时对象，其间的元素逐个后移一位后再移入空位，比 std::rotate 的两两交换少一半移动
+      T tmp(std::move(back()));
+      std::move_backward(begin() + index, end() - 1, end());
+      (*this)[index] = std::move(tmp);
+    }
+    return begin() + index;
+  }
+
+  iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+
+  iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+  template <std::input_iterator It>
+  iterator insert(const_iterator pos, It first, It last) {
+    size_t index = pos - begin();
+    size_t old = this->m_size;
+    append(first, last);
+    std::rotate(begin() + index, begin() + old, end());
+    return begin() + index;
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<T> init) { return insert(pos, init.begin(), init.end()); }
+
+  template <std::input_iterator It>
+  void append(It first, It last) {
+    if constexpr (std::forward_iterator<It>) {
+      size_t count = static_cast<size_t>(std::distance(first, last));
+      if (this->m_size + count > this->m_capacity) this->reallocate(this->nextCapacity(this->m_size + count));
+      std::uninitialized_copy(first, last, end());
+      this->m_size += count;
+    } else {
+      for (; first != last; ++first) emplace_back(*first);
+    }
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    iterator dst = begin() + (first - begin());
+    if (first == last) return dst;
+    iterator src = dst + (last - first);
+    if constexpr (is_trivially_relocatable_v<T>) {
+      // 析构被删除的元素，再把尾部整段前移
+      std::destroy(dst, src);
+      play::uninitialized_relocate(src, end(), dst);
+      this->m_size -= static_cast<size_t>(src - dst);
+    } else {
+      iterator tail = std::move(src, end(), dst);
+      std::destroy(tail, end());
+      this->m_size = tail - begin();
+    }
+    return dst;
+  }
+
+  void resize(size_t count) { resizeWith(count); }
+
+  void resize(size_t count, const T& value) { resizeWith(count, value); }
+
+  void swap(SmallVector& rhs) noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>) {
+    if (this == &rhs) return;
+    if (!this->isInline() && !rhs.isInline()) {
+      std::swap(this->m_data, rhs.m_data);
+      std::swap(this->m_size, rhs.m_size);
+      std::swap(this->m_capacity, rhs.m_capacity);
+      return;
+    }
+    SmallVector tmp(std::move(rhs));
+    rhs = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+  friend void swap(SmallVector& lhs, SmallVector& rhs) noexcept(noexcept(lhs.swap(rhs))) { lhs.swap(rhs); }
+
+  friend bool operator==(const SmallVector& lhs, const SmallVector& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  friend auto operator<=>(const SmallVector& lhs, const SmallVector& rhs)
+    requires std::three_way_comparable<T>
+  {
+    return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+private:
+  // 先在新内存中构造新元素再迁移旧元素，args 引用自身元素（如 v.push_back(v[0])）时也是安全的
+  template <typename... Args>
+  T& growAndEmplaceBack(Args&&... args) {
+    size_t capacity = this->nextCapacity(this->m_size + 1);
+    T* data = std::allocator<T>().allocate(capacity);
+    T* p;
+    try {
+      p = play::construct_at(data + this->m_size, std::forward<Args>(args)...);
+    } catch (...) {
+      std::allocator<T>().deallocate(data, capacity);
+      throw;
+    }
+    try {
+      this->relocate(data);
+    } catch (...) {
+      std::destroy_at(p);
+      std::allocator<T>().deallocate(data, capacity);
+      throw;
+    }
+    this->m_data = data;
+    this->m_capacity = capacity;
+    ++this->m_size;
+    return *p;
+  }
+
+  template <typename... Args>
+  void resizeWith(size_t count, const Args&... value) {
+    if (count <= this->m_size) {
+      std::destroy(this->m_data + count, this->m_data + this->m_size);
+      this->m_size = count;
+      return;
+    }
+    reserve(count);
+    while (this->m_size < count) {
+      play::construct_at(this->m_data + this->m_size, value...);
+      ++this->m_size;
+    }
+  }
+};
+} // namespace play
@@ -2,27 +2,62 @@
 
 #include <cstddef>
 #include <type_traits>
+#include <utility>
 
 namespace play {
 template <typename T>
 using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
 
-template <size_t I, typename... Ts>
-struct nth_type {};
+#if defined(__has_builtin)
+#if __has_builtin(__type_pack_element)
+#define PLAY_HAS_TYPE_PACK_ELEMENT
+#endif
+#endif
 
-template <typename T, typename... Rest>
-struct nth_type<0, T, Rest...> {
+namespace _trait_detail {
+template <size_t I, typename T>
+struct indexed_type {
   using type = T;
 };
 
-template <size_t I, typename T, typename... Rest>
-struct nth_type<I, T, Rest...> {
-  using type = typename nth_type<I - 1, Rest...>::type;
+template <typename IdxSeq, typename... Ts>
+struct indexed_types;
+
+// 一次性继承所有 indexed_type<I, T>，取第 I 个类型只需一次重载决议，模板实例化深度与 Ts 的长度无关
+template <size_t... Is, typename... Ts>
+struct indexed_types<std::index_sequence<Is...>, Ts...> : indexed_type<Is, Ts>... {};
+
+template <size_t I, typename T>
+indexed_type<I, T> select(const indexed_type<I, T>&);
+} // namespace _trait_detail
+
+template <size_t I, typename... Ts>
+struct nth_type {
+  static_assert(I < sizeof...(Ts), "nth_type index out of range");
+#ifdef PLAY_HAS_TYPE_PACK_ELEMENT
+  using type = __type_pack_element<I, Ts...>;
+#else
+  using type = typename decltype(_trait_detail::select<I>(
+      std::declval<_trait_detail::indexed_types<std::index_sequence_for<Ts...>, Ts...>>()))::type;
+#endif
 };
 
 template <size_t I, typename... Ts>
 using nth_type_t = typename nth_type<I, Ts...>::type;
 
+// T 在 Ts 中出现的次数
+template <typename T, typename... Ts>
+inline constexpr size_t count_type_v = (size_t(std::is_same_v<T, Ts>) + ... + 0);
+
+// T 在 Ts 中首次出现的下标，不存在时为 sizeof...(Ts)
+template <typename T, typename... Ts>
+inline constexpr size_t index_of_v = []() constexpr {
+  constexpr bool matches[] = {std::is_same_v<T, Ts>..., false};
+  size_t i = 0;
+  while (i < sizeof...(Ts) && !matches[i]) ++i;
+  return i;
+}();
+
 template <typename T>
 struct in_place_type_t {
   explicit in_place_type_t() = default;
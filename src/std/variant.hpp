@@ -1,10 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <exception>
 #include <functional>
+#include <memory>
 #include <utility>
 
+#include "boxed.hpp"
 #include "enable_smfs.hpp"
 #include "memory.hpp"
+#include "relocate.hpp"
 #include "trait.hpp"
 
 namespace play {
@@ -13,6 +19,13 @@ class Variant;
 
 inline constexpr size_t variant_npos = -1;
 
+// Opt-in double buffering for Variant<Ts...>, specialize it as true to make a variant with throwing constructors
+// never valueless, at the cost of doubling the storage:
+//   template <>
+//   inline constexpr bool play::enable_double_buffered_variant<A, B> = true;
+template <typename... Ts>
+inline constexpr bool enable_double_buffered_variant = false;
+
 // TRICK
 // 提取基础类型（不含 cv/ref 限定）的小技巧：在目标类型之后设置一个默认值为 rm_cv_ref<T> 的辅助类型
 // 特化时专门用基础类型特化这个辅助类型，这样目标类型数就能自动匹配 cv/ref 之间的组合
@@ -28,10 +41,11 @@ inline constexpr size_t variant_size_v = variant_size<V>::value;
 template <size_t I, typename V>
 struct variant_alternative;
 
+// A Boxed<T> alternative is seen as T
 template <size_t I, typename... Ts>
 struct variant_alternative<I, Variant<Ts...>> {
   static_assert(I < sizeof...(Ts));
-  using type = nth_type_t<I, Ts...>;
+  using type = unbox_t<nth_type_t<I, Ts...>>;
 };
 
 template <size_t I, typename V>
@@ -61,7 +75,7 @@ struct deduce_visit_result {
 
 template <typename... Ts>
 struct traits {
-  static constexpr bool s_default_ctor = std::is_default_constructible_v<nth_type<0, Ts...>>;
+  static constexpr bool s_default_ctor = std::is_default_constructible_v<nth_type_t<0, Ts...>>;
   static constexpr bool s_copy_ctor = (std::is_copy_constructible_v<Ts> && ...);
   static constexpr bool s_move_ctor = (std::is_move_constructible_v<Ts> && ...);
   static constexpr bool s_copy_assign = s_copy_ctor && (std::is_copy_assignable_v<Ts> && ...);
@@ -84,9 +98,14 @@ struct traits {
 template <typename T>
 using never_valueless_alt = std::conjunction<std::bool_constant<sizeof(T) <= 256>, std::is_trivially_copyable<T>>;
 
-// True for Variant<Ts...> that never be valueless
+// True for Variant<Ts...> that never be valueless:
+// - all alternatives are nothrow move constructible, a throwing construction is done into a temporary first
+// - double buffering is enabled, a throwing construction is done into the spare buffer first
+// - all alternatives are suitably-small and trivially copyable, and Variant<Ts...> is move assignable
 template <typename... Ts>
-using never_valueless = std::conjunction<std::bool_constant<traits<Ts...>::s__move_assign>, never_valueless_alt<Ts>...>;
+using never_valueless = std::disjunction<
+    std::bool_constant<traits<Ts...>::s_nothrow_move_ctor>, std::bool_constant<enable_double_buffered_variant<Ts...>>,
+    std::conjunction<std::bool_constant<traits<Ts...>::s_move_assign>, never_valueless_alt<Ts>...>>;
 
 template <typename MaybeVariantCookie, typename V, typename = remove_cvref_t<V>>
 inline constexpr bool extra_visit_slot_needed = false;
@@ -98,9 +117,9 @@ template <typename V, typename... Ts>
 inline constexpr bool extra_visit_slot_needed<variant_idx_cookie, V, Variant<Ts...>> = !never_valueless<Ts...>::value;
 
 template <typename... Ts, typename T>
-decltype(auto) variant_cast(T&& rhs) {
+constexpr decltype(auto) variant_cast(T&& rhs) {
   if constexpr (std::is_lvalue_reference_v<T>) {
-    if constexpr (std::is_const_v<std::remove_reference<T>>) {
+    if constexpr (std::is_const_v<std::remove_reference_t<T>>) {
       return static_cast<const Variant<Ts...>&>(rhs);
     } else {
       return static_cast<Variant<Ts...>&>(rhs);
@@ -110,115 +129,189 @@ decltype(auto) variant_cast(T&& rhs) {
   }
 }
 
+template <typename T, bool = std::is_trivially_destructible_v<T>>
+struct Uninitialized;
+
+template <typename T>
+struct Uninitialized<T, true> {
+  template <size_t I, typename... Args>
+  constexpr Uninitialized(in_place_index_t<I>, Args&&... args) : m_storage(std::forward<Args>(args)...) {}
+
+  constexpr const T& get() const& noexcept { return m_storage; }
+  constexpr T& get() & noexcept { return m_storage; }
+  constexpr const T&& get() const&& noexcept { return std::move(m_storage); }
+  constexpr T&& get() && noexcept { return std::move(m_storage); }
+
+  T m_storage;
+};
+
+// Wrapping T in an anonymous union (instead of raw bytes + placement new) suppresses the automatic destruction of
+// m_storage while keeping it a real T object, so non-trivially destructible literal types work in constant evaluation.
+// The owner (VariantStorage) is responsible for destroying the alternative.
+template <typename T>
+struct Uninitialized<T, false> {
+  template <size_t I, typename... Args>
+  constexpr Uninitialized(in_place_index_t<I>, Args&&... args) : m_storage(std::forward<Args>(args)...) {}
+
+  constexpr ~Uninitialized() {}
+
+  constexpr const T& get() const& noexcept { return m_storage; }
+  constexpr T& get() & noexcept { return m_storage; }
+  constexpr const T&& get() const&& noexcept { return std::move(m_storage); }
+  constexpr T&& get() && noexcept { return std::move(m_storage); }
+
+  union {
+    T m_storage;
+  };
+};
+
+template <typename T>
+struct is_uninitialized : std::false_type {};
+
+template <typename T, bool trivially_dtor>
+struct is_uninitialized<Uninitialized<T, trivially_dtor>> : std::true_type {};
+
+// Placeholder member which is active while no alternative lives in a union node.
+struct UnionNone {};
+
+// Storage of Variant<Ts...> is a tree of wide unions rather than a linear First/Rest chain. Each node covers the
+// alternatives [B, E) of Ts with up to k_union_width members, member K holding the chunk of s_step alternatives
+// starting at B + K * s_step, and every node carries the whole pack so no node needs to slice it. Up to 16
+// alternatives are flat members of a single union and up to 256 take two levels, so locating alternative I takes
+// log16(sizeof...(Ts)) steps. Union members cannot be expanded from a pack, hence the members spelled out by macros.
+inline constexpr size_t k_union_width = 16;
+
+// Alternatives per member of a node covering n alternatives: the smallest power of k_union_width that fits them
+constexpr size_t unionStep(size_t n) {
+  size_t step = 1;
+  while (step * k_union_width < n) {
+    step *= k_union_width;
+  }
+  return step;
+}
+
+template <bool trivially_dtor, size_t B, size_t E, typename... Ts>
+union VariadicUnion;
+
+template <bool trivially_dtor, size_t B, size_t E, typename... Ts>
+using union_node_t =
+    std::conditional_t<E <= B, UnionNone,
+                       std::conditional_t<E - B == 1, Uninitialized<nth_type_t<(B < E ? B : 0), Ts...>>,
+                                          VariadicUnion<trivially_dtor, B, E, Ts...>>>;
+
+#define UNION_MEMBERS(F) F(0) F(1) F(2) F(3) F(4) F(5) F(6) F(7) F(8) F(9) F(10) F(11) F(12) F(13) F(14) F(15)
+#define UNION_MEMBER(K) Member<K> m_##K;
+#define UNION_MEMBER_CTOR(K)            \
+  template <size_t I, typename... Args> \
+    requires(s_member<I> == K)          \
+  constexpr VariadicUnion(in_place_index_t<I> i, Args&&... args) : m_##K(i, std::forward<Args>(args)...) {}
+#define UNION_GET_MEMBER(K)                \
+  if constexpr (K == k) {                  \
+    return (std::forward<Union>(u).m_##K); \
+  } else
+
+template <bool trivially_dtor, size_t B, size_t E, typename... Ts>
+union VariadicUnion {
+  static constexpr size_t s_step = unionStep(E - B);
+
+  // Index of the member containing alternative I
+  template <size_t I>
+  static constexpr size_t s_member = (I - B) / s_step;
+
+  template <size_t K>
+  using Member = union_node_t<trivially_dtor, std::min(B + K * s_step, E), std::min(B + (K + 1) * s_step, E), Ts...>;
+
+  constexpr VariadicUnion() : m_none() {}
+
+  UNION_MEMBERS(UNION_MEMBER_CTOR)
+
+  ~VariadicUnion() requires trivially_dtor = default;
+  constexpr ~VariadicUnion() requires(!trivially_dtor) {}
+
+  UnionNone m_none;
+  UNION_MEMBERS(UNION_MEMBER)
+};
+static_assert(k_union_width == 16, "UNION_MEMBERS spells out k_union_width members");
+
+// Member K of a union node, keeping the value category of u
+template <size_t k, typename Union>
+constexpr decltype(auto) unionMember(Union&& u) noexcept {
+  UNION_MEMBERS(UNION_GET_MEMBER) {
+    static_assert(k < k_union_width);
+  }
+}
+
+#undef UNION_GET_MEMBER
+#undef UNION_MEMBER_CTOR
+#undef UNION_MEMBER
+#undef UNION_MEMBERS
+
+template <typename... Ts>
+using RootUnion = VariadicUnion<traits<Ts...>::s_trivial_dtor, 0, sizeof...(Ts), Ts...>;
+
 template <size_t I, typename Union>
 constexpr decltype(auto) getN(Union&& u) noexcept {
-  if constexpr (I == 0) {
-    return std::forward<Union>(u).m_first.get();
-  } else if constexpr (I == 1) {
-    return std::forward<Union>(u).m_rest.m_first.get();
-  } else if constexpr (I == 2) {
-    return std::forward<Union>(u).m_rest.m_rest.m_first.get();
+  using U = remove_cvref_t<Union>;
+  if constexpr (is_uninitialized<U>::value) {
+    return std::forward<Union>(u).get();
   } else {
-    return getN<I - 3>(std::forward<Union>(u).m_rest.m_rest.m_rest);
+    return getN<I>(unionMember<U::template s_member<I>>(std::forward<Union>(u)));
   }
 }
 
 template <size_t I, typename V>
 constexpr decltype(auto) get(V&& var) noexcept {
-  return getN<I>(std::forward<V>(var).m_union);
+  if constexpr (std::is_lvalue_reference_v<V>) {
+    return getN<I>(var.activeUnion());
+  } else {
+    return getN<I>(std::move(var.activeUnion()));
+  }
 }
 
+// Activate every union node on the path to alternative I and return the address of its (unconstructed) leaf.
 template <size_t I, typename Union>
-constexpr decltype(auto) constructN(Union& u) noexcept {
-  if constexpr (I == 0) {
-    return &u.m_first;
-  } else if constexpr (I == 1) {
-    construct_at(&u.m_rest);
-    return &u.m_rest.m_first;
-  } else if constexpr (I == 2) {
-    construct_at(&u.m_rest);
-    construct_at(&u.m_rest.m_rest);
-    return &u.m_rest.m_rest.m_first;
+constexpr auto constructN(Union& u) noexcept {
+  auto* member = &unionMember<Union::template s_member<I>>(u);
+  if constexpr (is_uninitialized<remove_cvref_t<decltype(*member)>>::value) {
+    return member;
   } else {
-    construct_at(&u.m_rest);
-    construct_at(&u.m_rest.m_rest);
-    construct_at(&u.m_rest.m_rest.m_rest);
-    return constructN<I - 3>(u.m_rest.m_rest.m_rest);
+    play::construct_at(member);
+    return constructN<I>(*member);
   }
 }
 
-// @dimensions are the number of alternatives of each variant in sequence.
-template <typename Lambda, size_t... dimensions>
-struct MultiArray;
-
-// Base case.
-// With only one data member m_data store the address of a function.
 template <typename Lambda>
-struct MultiArray<Lambda> {
-  template <typename>
-  struct untag_result : std::false_type {
-    using type = Lambda;
-  };
-
-  template <typename... Args>
-  struct untag_result<const void (*)(Args...)> : std::false_type {
-    using type = void (*)(Args...);
-  };
-
-  template <typename... Args>
-  struct untag_result<variant_cookie (*)(Args...)> : std::false_type {
-    using type = void (*)(Args...);
-  };
-
-  template <typename... Args>
-  struct untag_result<variant_idx_cookie (*)(Args...)> : std::false_type {
-    using type = void (*)(Args...);
-  };
-
-  template <typename Ret, typename... Args>
-  struct untag_result<deduce_visit_result<Ret> (*)(Args...)> : std::true_type {
-    using type = Ret (*)(Args...);
-  };
-
-  using ElementType = typename untag_result<Lambda>::type;
-
-  using result_is_deduced = untag_result<Lambda>;
-
-  constexpr const ElementType& access() const { return m_data; }
-
-  ElementType m_data;
+struct untag_result : std::false_type {
+  using type = Lambda;
 };
 
-// Recursion case.
-template <typename Ret, typename Visitor, typename... Vs, size_t first, size_t... rest>
-struct MultiArray<Ret (*)(Visitor, Vs...), first, rest...> {
-  using V = nth_type_t<sizeof...(Vs) - sizeof...(rest) - 1, Vs...>;
-  using Lambda = Ret (*)(Visitor, Vs...);
-
-  static constexpr size_t do_cookie = extra_visit_slot_needed<Ret, V> ? 1 : 0;
+template <typename... Args>
+struct untag_result<variant_cookie (*)(Args...)> : std::false_type {
+  using type = void (*)(Args...);
+};
 
-  template <typename... Args>
-  constexpr decltype(auto) access(size_t first_index, Args... rest_indices) const {
-    return m_arr[first_index + do_cookie].access(rest_indices...);
-  }
+template <typename... Args>
+struct untag_result<variant_idx_cookie (*)(Args...)> : std::false_type {
+  using type = void (*)(Args...);
+};
 
-  MultiArray<Lambda, rest...> m_arr[first + do_cookie];
+template <typename Ret, typename... Args>
+struct untag_result<deduce_visit_result<Ret> (*)(Args...)> : std::true_type {
+  using type = Ret (*)(Args...);
 };
 
-template <typename ArrayType, typename IdxSeq>
-struct gen_vtable_impl;
+template <typename Lambda, typename IdxSeq>
+struct vtable_entry;
 
-// Base case.
-// It populates a MultiArray element with the address of a function
-// that invokes the visitor with the alternatives specified by indices.
+// A single entry of the visitation table: invokes the visitor with the alternatives specified by indices.
 template <typename Ret, typename Visitor, typename... Vs, size_t... indices>
-struct gen_vtable_impl<MultiArray<Ret (*)(Visitor, Vs...)>, std::index_sequence<indices...>> {
-  using ArrayType = MultiArray<Ret (*)(Visitor, Vs...)>;
+struct vtable_entry<Ret (*)(Visitor, Vs...), std::index_sequence<indices...>> {
+  using result_is_deduced = untag_result<Ret (*)(Visitor, Vs...)>;
 
   template <size_t index, typename V>
   static constexpr decltype(auto) s_elementByIndexOrCookie(V&& var) noexcept {
     if constexpr (index != variant_npos) {
-      return get<index>(std::forward<V>(var));
+      return _variant_detail::get<index>(std::forward<V>(var));
     } else {
       return variant_cookie{};
     }
@@ -232,77 +325,124 @@ struct gen_vtable_impl<MultiArray<Ret (*)(Visitor, Vs...)>, std::index_sequence<
     } else if constexpr (std::is_same_v<Ret, variant_cookie>) {
       // For raw visitation without indices, and discard the return value
       std::invoke(std::forward<Visitor>(visitor), s_elementByIndexOrCookie<indices>(std::forward<Vs>(vars))...);
-    } else if constexpr (ArrayType::result_is_deduced::value) {
-      // For usual case
-      return std::invoke(std::forward<Visitor>(visitor), s_elementByIndexOrCookie<indices>(std::forward<Vs>(vars))...);
+    } else if constexpr (result_is_deduced::value) {
+      // For usual case. Raw visitation above works on the stored Boxed<T>, user visitors get the T inside
+      return std::invoke(std::forward<Visitor>(visitor),
+                         play::unboxed(s_elementByIndexOrCookie<indices>(std::forward<Vs>(vars)))...);
+    } else if constexpr (std::is_void_v<Ret>) {
+      // For visit<void>
+      std::invoke(std::forward<Visitor>(visitor),
+                  play::unboxed(_variant_detail::get<indices>(std::forward<Vs>(vars)))...);
     } else {
       // For visit<R>
-      return std::invoke(std::forward<Visitor>(visitor), get<indices>(std::forward<Vs>(vars))...);
+      return static_cast<Ret>(std::invoke(std::forward<Visitor>(visitor),
+                                          play::unboxed(_variant_detail::get<indices>(std::forward<Vs>(vars)))...));
     }
   }
+};
 
-  static constexpr auto s_apply() {
-    if constexpr (ArrayType::result_is_deduced::value) {
-      constexpr bool visit_ret_type_mismatch =
-          !std::is_same_v<typename Ret::type, decltype(s_visitInvoke(std::declval<Visitor>(), std::declval<Vs>()...))>;
-      if constexpr (visit_ret_type_mismatch) {
-        struct cannot_match {};
-        return cannot_match{};
-      } else {
-        return ArrayType{&s_visitInvoke};
-      }
-    } else {
-      return ArrayType{&s_visitInvoke};
+// Visitation jump table.
+// Instead of a nested MultiArray populated by one gen_vtable_impl specialization per index prefix, the table is a
+// flat array whose N-dimensional index is linearized in row-major order. Every entry is produced by a single pack
+// expansion, so the instantiation depth stays constant no matter how many variants or alternatives are visited,
+// and the table itself is only instantiated by the visits which actually fall back to it.
+template <typename Ret, typename Visitor, typename... Vs>
+struct gen_vtable {
+  using Lambda = Ret (*)(Visitor, Vs...);
+  using ElementType = typename untag_result<Lambda>::type;
+
+  static constexpr size_t s_extents[] = {(variant_size_v<Vs> + (extra_visit_slot_needed<Ret, Vs> ? 1 : 0))...};
+  static constexpr size_t s_offsets[] = {(extra_visit_slot_needed<Ret, Vs> ? 1 : 0)...};
+  static constexpr size_t s_size = (size_t(1) * ... * (variant_size_v<Vs> + (extra_visit_slot_needed<Ret, Vs> ? 1 : 0)));
+
+  // The index of the K-th variant encoded in flat index
+  static constexpr size_t s_indexOf(size_t flat, size_t k) {
+    for (size_t i = sizeof...(Vs); i-- > k + 1;) {
+      flat /= s_extents[i];
     }
+    // Slot 0 is reserved for the valueless state when an extra slot is needed
+    return flat % s_extents[k] - s_offsets[k];
   }
-};
 
-// Recursion case.
-// It builds up the index sequences by recursively
-// calling s_apply() on the next specialization of gen_vtable_impl.
-// The base case of the recursion defines the actual function pointers.
-template <typename Ret, typename Visitor, typename... Vs, size_t... dimensions, size_t... indices>
-struct gen_vtable_impl<MultiArray<Ret (*)(Visitor, Vs...), dimensions...>, std::index_sequence<indices...>> {
-  using ArrayType = MultiArray<Ret (*)(Visitor, Vs...), dimensions...>;
-  using NextV = std::remove_reference<nth_type_t<sizeof...(indices), Vs...>>;
-
-  template <bool do_cookie, size_t index, typename T>
-  static constexpr void s_applySingleAlt(T& element, T* cookie_element = nullptr) {
-    if constexpr (do_cookie) {
-      element = gen_vtable_impl<T, std::index_sequence<indices..., index>>::s_apply();
-      *cookie_element = gen_vtable_impl<T, std::index_sequence<indices..., variant_npos>>::s_apply();
-    } else {
-      auto tmp_element = gen_vtable_impl<std::remove_reference_t<decltype(element)>,
-                                         std::index_sequence<indices..., index>>::s_apply();
-      static_assert(std::is_same_v<T, decltype(tmp_element)>,
+  template <size_t flat, size_t... ks>
+  static constexpr ElementType s_entry(std::index_sequence<ks...>) {
+    using Entry = vtable_entry<Lambda, std::index_sequence<s_indexOf(flat, ks)...>>;
+    if constexpr (Entry::result_is_deduced::value) {
+      static_assert(std::is_same_v<typename Ret::type, decltype(Entry::s_visitInvoke(std::declval<Visitor>(),
+                                                                                     std::declval<Vs>()...))>,
                     "play::visit requires the visitor to have the same "
                     "return type for all alternatives of a variant");
-      element = tmp_element;
     }
+    return &Entry::s_visitInvoke;
   }
 
-  template <size_t... v_indices>
-  static constexpr void s_applyAllAlts(ArrayType& vtable, std::index_sequence<v_indices...>) {
-    if constexpr (extra_visit_slot_needed<Ret, NextV>) {
-      (s_applySingleAlt<true, v_indices>(vtable.m_arr[v_indices + 1], &(vtable.m_arr[0])), ...);
-    } else {
-      (s_applySingleAlt<false, v_indices>(vtable.m_arr[v_indices]), ...);
-    }
+  template <size_t... flats>
+  static constexpr std::array<ElementType, s_size> s_apply(std::index_sequence<flats...>) {
+    return {{s_entry<flats>(std::index_sequence_for<Vs...>())...}};
   }
 
-  static constexpr ArrayType s_apply() {
-    ArrayType vtable{};
-    s_applyAllAlts(vtable, std::make_index_sequence<variant_size_v<NextV>>());
-    return vtable;
+  static constexpr std::array<ElementType, s_size> s_vtable = s_apply(std::make_index_sequence<s_size>());
+
+  template <typename... Indices>
+  static constexpr ElementType access(Indices... indices) {
+    size_t flat = 0, k = 0;
+    // variant_npos + 1 wraps to slot 0
+    ((flat = flat * s_extents[k] + (indices + s_offsets[k]), ++k), ...);
+    return s_vtable[flat];
   }
 };
 
-template <typename Ret, typename Visitor, typename... Vs>
-struct gen_vtable {
-  using ArrayType = MultiArray<Ret (*)(Visitor, Vs...), variant_size_v<Vs>...>;
+// Number of cases of a single switch in switchVisit, and the max number of alternatives for which doVisit prefers the
+// switch to the jump table
+inline constexpr size_t k_switch_cases = 11;
 
-  static constexpr ArrayType s_vtable = gen_vtable_impl<ArrayType, std::index_sequence<>>::s_apply();
-};
+// Visit a single variant with switch statements, which could be inlined by compilers (while the jump table could not).
+// Alternatives [offset, offset + k_switch_cases) are handled by one switch, the rest are chained to the next one.
+template <typename Ret, size_t offset, typename Visitor, typename V>
+constexpr decltype(auto) switchVisit(Visitor&& visitor, V&& var) {
+  using Lambda = Ret (*)(Visitor&&, V&&);
+  constexpr size_t var_size = variant_size_v<V>;
+
+#define VISIT_UNREACHABLE __builtin_unreachable
+#define VISIT_CASE(N)                                                                                             \
+  case N: {                                                                                                       \
+    if constexpr (offset + N < var_size) {                                                                        \
+      return vtable_entry<Lambda, std::index_sequence<offset + N>>::s_visitInvoke(std::forward<Visitor>(visitor), \
+                                                                                  std::forward<V>(var));          \
+    } else {                                                                                                      \
+      VISIT_UNREACHABLE();                                                                                        \
+    }                                                                                                             \
+  }
+
+  switch (var.index() - offset) {
+    VISIT_CASE(0)
+    VISIT_CASE(1)
+    VISIT_CASE(2)
+    VISIT_CASE(3)
+    VISIT_CASE(4)
+    VISIT_CASE(5)
+    VISIT_CASE(6)
+    VISIT_CASE(7)
+    VISIT_CASE(8)
+    VISIT_CASE(9)
+    VISIT_CASE(10)
+    case variant_npos:
+      if constexpr (offset == 0 && extra_visit_slot_needed<Ret, V>) {
+        return vtable_entry<Lambda, std::index_sequence<variant_npos>>::s_visitInvoke(std::forward<Visitor>(visitor),
+                                                                                      std::forward<V>(var));
+      } else {
+        VISIT_UNREACHABLE();
+      }
+    default:
+      if constexpr (offset + k_switch_cases < var_size) {
+        return switchVisit<Ret, offset + k_switch_cases>(std::forward<Visitor>(visitor), std::forward<V>(var));
+      } else {
+        VISIT_UNREACHABLE();
+      }
+  }
+#undef VISIT_CASE
+#undef VISIT_UNREACHABLE
+}
 
 template <typename Ret, typename Visitor, typename... Vs>
 constexpr decltype(auto) doVisit(Visitor&& visitor, Vs&&... vars) {
@@ -317,49 +457,11 @@ constexpr decltype(auto) doVisit(Visitor&& visitor, Vs&&... vars) {
     using V0 = nth_type_t<0, Vs...>;
     constexpr size_t v0_size = variant_size_v<V0>;
 
-    if constexpr (sizeof...(Vs) == 1 && v0_size <= 11) {
-      using ArrayType = MultiArray<Ret (*)(Visitor&&, V0&&)>;
-      V0& v0 = [](V0& v, ...) -> V0& { return v; }(vars...);
-
-#define VISIT_UNREACHABLE __builtin_unreachable
-#define VISIT_CASE(N)                                                                                          \
-  case N: {                                                                                                    \
-    if constexpr (N < v0_size) {                                                                               \
-      return gen_vtable_impl<ArrayType, std::index_sequence<N>>::s_visitInvoke(std::forward<Visitor>(visitor), \
-                                                                               std::forward<V0>(v0));          \
-    } else {                                                                                                   \
-      VISIT_UNREACHABLE();                                                                                     \
-    }                                                                                                          \
-  }
-
-      switch (v0.index()) {
-        VISIT_CASE(0)
-        VISIT_CASE(1)
-        VISIT_CASE(2)
-        VISIT_CASE(3)
-        VISIT_CASE(4)
-        VISIT_CASE(5)
-        VISIT_CASE(6)
-        VISIT_CASE(7)
-        VISIT_CASE(8)
-        VISIT_CASE(9)
-        VISIT_CASE(10)
-        case variant_npos:
-          if constexpr (std::is_same_v<Ret, variant_cookie> || std::is_same_v<Ret, variant_idx_cookie>) {
-            return gen_vtable_impl<ArrayType, std::index_sequence<variant_npos>>::s_visitInvoke(
-                std::forward<Visitor>(visitor), std::forward<V0>(v0));
-          } else {
-            VISIT_UNREACHABLE();
-          }
-        default:
-          VISIT_UNREACHABLE();
-      }
-#undef VISIT_CASE
-#undef VISIT_UNREACHABLE
+    if constexpr (sizeof...(Vs) == 1 && v0_size <= k_switch_cases) {
+      return switchVisit<Ret, 0>(std::forward<Visitor>(visitor), std::forward<Vs>(vars)...);
     } else {
       // too many variants or too many alternatives of the first variant, using a jump table to generate case
-      constexpr auto& vtable = gen_vtable<Ret, Visitor&&, Vs&&...>::s_vtable;
-      auto func_ptr = vtable.access(vars.index()...);
+      auto func_ptr = gen_vtable<Ret, Visitor&&, Vs&&...>::access(vars.index()...);
       return (*func_ptr)(std::forward<Visitor>(visitor), std::forward<Vs>(vars)...);
     }
   }
@@ -375,71 +477,14 @@ constexpr void rawIdxVisit(Visitor&& visitor, Vs&&... vars) {
   doVisit<variant_idx_cookie>(std::forward<Visitor>(visitor), std::forward<Vs>(vars)...);
 }
 
-template <typename T, bool = std::is_trivially_destructible_v<T>>
-struct Uninitialized;
-
-template <typename T>
-struct Uninitialized<T, true> {
-  template <typename... Args>
-  constexpr Uninitialized(in_place_index_t<0>, Args&&... args) : m_storage(std::forward<Args>(args)...) {}
-
-  constexpr const T& get() const& noexcept { return m_storage; }
-  constexpr T& get() & noexcept { return m_storage; }
-  constexpr const T&& get() const&& noexcept { return std::move(m_storage); }
-  constexpr T&& get() && noexcept { return std::move(m_storage); }
-
-  T m_storage;
-};
-
-template <typename T>
-struct Uninitialized<T, false> {
-  template <typename... Args>
-  constexpr Uninitialized(in_place_index_t<0>, Args&&... args) {
-    new ((void*)std::addressof(m_storage)) T(std::forward<Args>(args)...);
-  }
-
-  const T& get() const& noexcept { return *reinterpret_cast<const T*>(&m_storage); }
-  T& get() & noexcept { return *reinterpret_cast<T*>(&m_storage); }
-  const T&& get() const&& noexcept { return std::move(*reinterpret_cast<const T*>(&m_storage)); }
-  T&& get() && noexcept { return std::move(*reinterpret_cast<T*>(&m_storage)); }
-
-  alignas(alignof(T)) unsigned char m_storage[sizeof(T)];
-};
-
 // Inheritance chain:
-// VariantStorage(VariantUnion) -> CopyCtorBase -> MoveCtorBase -> CopyAssignBase -> MoveAssignBase -> Variant
+// VariantStorage(VariadicUnion) -> CopyCtorBase -> MoveCtorBase -> CopyAssignBase -> MoveAssignBase -> Variant
 template <bool trivially_dtor, typename... Ts>
-union VariadicUnion {
-  VariadicUnion() = default;
-
-  template <size_t I, typename... Args>
-  VariadicUnion(in_place_index_t<I>, Args&&...) = delete;
-};
-
-template <bool trivially_dtor, typename First, typename... Rest>
-union VariadicUnion<trivially_dtor, First, Rest...> {
-  constexpr VariadicUnion() : m_rest() {}
-
-  template <typename... Args>
-  constexpr VariadicUnion(in_place_index_t<0>, Args&&... args)
-      : m_first(in_place_index<0>, std::forward<Args>(args)...) {}
-
-  template <size_t I, typename... Args>
-  constexpr VariadicUnion(in_place_index_t<I>, Args&&... args)
-      : m_rest(in_place_index<I - 1>, std::forward<Args>(args)...) {}
-
-  Uninitialized<First> m_first;
-  VariadicUnion<trivially_dtor, Rest...> m_rest;
-};
-
-template <bool trivially_dtor, typename... Ts>
-struct VariantStorage {
-  // Tip: using a smaller unsigned integer type base on the number of alternatives could save more space
-  using IndexType = size_t;
-};
+struct VariantStorage;
 
 template <typename... Ts>
 struct VariantStorage<false, Ts...> {
+  // Tip: using a smaller unsigned integer type base on the number of alternatives could save more space
   using IndexType = size_t;
 
   constexpr VariantStorage() : m_index(static_cast<IndexType>(variant_npos)) {}
@@ -448,13 +493,14 @@ struct VariantStorage<false, Ts...> {
   constexpr VariantStorage(in_place_index_t<I>, Args&&... args)
       : m_union(in_place_index<I>, std::forward<Args>(args)...), m_index(I) {}
 
-  ~VariantStorage() { reset(); }
+  constexpr ~VariantStorage() { reset(); }
 
   constexpr void reset() {
     if (!valid()) [[__unlikely__]] {
       return;
     }
-    doVisit<void>([](auto&& self) mutable { std::destroy_at(std::addressof(self)); }, variant_cast<Ts...>(*this));
+    // Raw visitation destroys the stored object itself, i.e. the Boxed<T> rather than the T inside
+    rawVisit([](auto&& self) mutable { std::destroy_at(std::addressof(self)); }, variant_cast<Ts...>(*this));
     m_index = static_cast<IndexType>(variant_npos);
   }
 
@@ -466,7 +512,10 @@ struct VariantStorage<false, Ts...> {
     }
   }
 
-  VariadicUnion<false, Ts...> m_union;
+  constexpr RootUnion<Ts...>& activeUnion() noexcept { return m_union; }
+  constexpr const RootUnion<Ts...>& activeUnion() const noexcept { return m_union; }
+
+  RootUnion<Ts...> m_union;
   IndexType m_index;
 };
 
@@ -490,31 +539,86 @@ struct VariantStorage<true, Ts...> {
     }
   }
 
-  VariadicUnion<true, Ts...> m_union;
+  constexpr RootUnion<Ts...>& activeUnion() noexcept { return m_union; }
+  constexpr const RootUnion<Ts...>& activeUnion() const noexcept { return m_union; }
+
+  RootUnion<Ts...> m_union;
+  IndexType m_index;
+};
+
+// Storage selected by enable_double_buffered_variant. A construction which may throw goes into the spare buffer
+// while the current alternative stays untouched, only then the current one is destroyed and the buffers flip.
+template <bool trivially_dtor, typename... Ts>
+struct DoubleBufferedStorage {
+  using IndexType = size_t;
+
+  constexpr DoubleBufferedStorage() : m_buffers(), m_index(static_cast<IndexType>(variant_npos)), m_active(0) {}
+
+  template <size_t I, typename... Args>
+  constexpr DoubleBufferedStorage(in_place_index_t<I>, Args&&... args)
+      : m_buffers{RootUnion<Ts...>(in_place_index<I>, std::forward<Args>(args)...), RootUnion<Ts...>()}, m_index(I),
+        m_active(0) {}
+
+  ~DoubleBufferedStorage() requires trivially_dtor = default;
+  constexpr ~DoubleBufferedStorage() requires(!trivially_dtor) { reset(); }
+
+  constexpr void reset() {
+    if constexpr (!trivially_dtor) {
+      if (m_index == IndexType(variant_npos)) [[__unlikely__]] {
+        return;
+      }
+      rawVisit([](auto&& self) mutable { std::destroy_at(std::addressof(self)); }, variant_cast<Ts...>(*this));
+    }
+    m_index = static_cast<IndexType>(variant_npos);
+  }
+
+  constexpr bool valid() const noexcept { return true; }
+
+  constexpr RootUnion<Ts...>& activeUnion() noexcept { return m_buffers[m_active]; }
+  constexpr const RootUnion<Ts...>& activeUnion() const noexcept { return m_buffers[m_active]; }
+
+  RootUnion<Ts...> m_buffers[2];
   IndexType m_index;
+  unsigned char m_active;
 };
 
 template <size_t I, bool trivially_dtor, typename... Ts, typename... Args>
-inline void emplace(VariantStorage<trivially_dtor, Ts...>& storage, Args&&... args) {
+constexpr void emplace(VariantStorage<trivially_dtor, Ts...>& storage, Args&&... args) {
   storage.reset();
-  construct_at(constructN<I>(storage.m_union), in_place_index<0>, std::forward<Args>(args)...);
+  play::construct_at(constructN<I>(storage.m_union), in_place_index<I>, std::forward<Args>(args)...);
+  storage.m_index = I;
+}
+
+template <size_t I, bool trivially_dtor, typename... Ts, typename... Args>
+constexpr void emplace(DoubleBufferedStorage<trivially_dtor, Ts...>& storage, Args&&... args) {
+  if constexpr (std::is_nothrow_constructible_v<nth_type_t<I, Ts...>, Args...>) {
+    storage.reset();
+    play::construct_at(constructN<I>(storage.activeUnion()), in_place_index<I>, std::forward<Args>(args)...);
+  } else {
+    auto& spare = storage.m_buffers[storage.m_active ^ 1];
+    play::construct_at(constructN<I>(spare), in_place_index<I>, std::forward<Args>(args)...);
+    storage.reset();
+    storage.m_active ^= 1;
+  }
   storage.m_index = I;
 }
 
 template <typename... Ts>
-using VariantStorageAlias = VariantStorage<traits<Ts...>::s_trivial_dtor, Ts...>;
+using VariantStorageAlias = std::conditional_t<enable_double_buffered_variant<Ts...>,
+                                               DoubleBufferedStorage<traits<Ts...>::s_trivial_dtor, Ts...>,
+                                               VariantStorage<traits<Ts...>::s_trivial_dtor, Ts...>>;
 
 template <bool trivially_copy_ctor, typename... Ts>
 struct CopyCtorBase : VariantStorageAlias<Ts...> {
   using BaseT = VariantStorageAlias<Ts...>;
   using BaseT::BaseT;
 
-  CopyCtorBase(const CopyCtorBase& rhs) noexcept(traits<Ts...>::s_nothrow_copy_ctor) {
+  constexpr CopyCtorBase(const CopyCtorBase& rhs) noexcept(traits<Ts...>::s_nothrow_copy_ctor) : BaseT() {
     rawIdxVisit(
         [this](auto&& rhs_value, auto rhs_index) mutable {
           constexpr size_t I = rhs_index;
           if constexpr (I != variant_npos) {
-            construct_at(&this->m_union, in_place_index<I>, rhs_value);
+            play::construct_at(&this->activeUnion(), in_place_index<I>, rhs_value);
           }
         },
         variant_cast<Ts...>(rhs));
@@ -540,12 +644,12 @@ struct MoveCtorBase : CopyCtorBaseAlias<Ts...> {
   using BaseT = CopyCtorBaseAlias<Ts...>;
   using BaseT::BaseT;
 
-  MoveCtorBase(MoveCtorBase&& rhs) noexcept(traits<Ts...>::s_nothrow_move_ctor) {
+  constexpr MoveCtorBase(MoveCtorBase&& rhs) noexcept(traits<Ts...>::s_nothrow_move_ctor) {
     rawIdxVisit(
         [this](auto&& rhs_value, auto rhs_index) mutable {
           constexpr size_t I = rhs_index;
           if constexpr (I != variant_npos) {
-            construct_at(&this->m_union, in_place_index<I>, std::forward<decltype(rhs_value)>(rhs_value));
+            play::construct_at(&this->activeUnion(), in_place_index<I>, std::forward<decltype(rhs_value)>(rhs_value));
           }
         },
         variant_cast<Ts...>(std::move(rhs)));
@@ -571,18 +675,18 @@ struct CopyAssignBase : MoveCtorBaseAlias<Ts...> {
   using BaseT = MoveCtorBaseAlias<Ts...>;
   using BaseT::BaseT;
 
-  CopyAssignBase& operator=(const CopyAssignBase& rhs) noexcept(traits<Ts...>::s_nothrow_copy_assign) {
+  constexpr CopyAssignBase& operator=(const CopyAssignBase& rhs) noexcept(traits<Ts...>::s_nothrow_copy_assign) {
     rawIdxVisit(
         [this](auto&& rhs_value, auto rhs_index) mutable {
           constexpr size_t I = rhs_index;
           if constexpr (I == variant_npos) {
             this->reset();
           } else if (this->m_index == I) {
-            get<I>(*this) = rhs_value;
+            _variant_detail::get<I>(*this) = rhs_value;
           } else {
             using Ti = nth_type_t<I, Ts...>;
             if constexpr (std::is_nothrow_copy_constructible_v<Ti> || !std::is_nothrow_move_constructible_v<Ti>) {
-              emplace<I>(*this, rhs_value);
+              _variant_detail::emplace<I>(*this, rhs_value);
             } else {
               using V = Variant<Ts...>;
               V& self = variant_cast<Ts...>(*this);
@@ -615,18 +719,18 @@ struct MoveAssignBase : CopyAssignBaseAlias<Ts...> {
 
   // If not all alternatives are trivially copy assignable, need to manually invoke copy opeartion.
   // Other smfs need to be handled in similar way
-  MoveAssignBase& operator=(MoveAssignBase&& rhs) noexcept(traits<Ts...>::s_nothrow_move_assign) {
+  constexpr MoveAssignBase& operator=(MoveAssignBase&& rhs) noexcept(traits<Ts...>::s_nothrow_move_assign) {
     rawIdxVisit(
         [this](auto&& rhs_value, auto rhs_index) mutable {
           constexpr size_t I = rhs_index;
           if constexpr (I == variant_npos) {
             this->reset();
           } else if (this->m_index == I) {
-            get<I>(*this) = std::move(rhs_value);
+            _variant_detail::get<I>(*this) = std::move(rhs_value);
           } else {
             using Ti = nth_type_t<I, Ts...>;
             if constexpr (std::is_nothrow_move_constructible_v<Ti>) {
-              emplace<I>(*this, std::move(rhs_value));
+              _variant_detail::emplace<I>(*this, std::move(rhs_value));
             } else {
               using V = Variant<Ts...>;
               V& self = variant_cast<Ts...>(*this);
@@ -666,8 +770,58 @@ struct VariantBase : MoveAssignBaseAlias<Ts...> {
   VariantBase& operator=(const VariantBase&) = default;
   VariantBase& operator=(VariantBase&&) = default;
 };
+
+// Imaginary function FUN(Ti) for each alternative, which is used by the converting constructor and assignment
+// to pick the alternative. Ti x[] = {std::forward<T>(t)} rejects narrowing conversions.
+template <size_t I, typename Ti>
+struct ArrayOf {
+  Ti m_arr[1];
+};
+
+template <size_t I, typename T, typename Ti, typename = void>
+struct BuildFUN {
+  void s_fun();
+};
+
+template <size_t I, typename T, typename Ti>
+struct BuildFUN<I, T, Ti, std::void_t<decltype(ArrayOf<I, Ti>{{std::declval<T>()}})>> {
+  static std::integral_constant<size_t, I> s_fun(Ti);
+};
+
+template <typename T, typename IdxSeq, typename... Ts>
+struct BuildFUNs;
+
+// Inherit all FUN(Ti) at once, the overload set is built without recursing through Ts
+template <typename T, size_t... Is, typename... Ts>
+struct BuildFUNs<T, std::index_sequence<Is...>, Ts...> : BuildFUN<Is, T, Ts>... {
+  using BuildFUN<Is, T, Ts>::s_fun...;
+};
+
+template <typename T, typename... Ts>
+using FUN_t = decltype(BuildFUNs<T, std::index_sequence_for<Ts...>, Ts...>::s_fun(std::declval<T>()));
+
+template <typename T, typename V, typename = void>
+struct accepted_alt {};
+
+// Overload resolution is done on the unboxed types, a Boxed<T> alternative accepts what T accepts
+template <typename T, typename... Ts>
+struct accepted_alt<T, Variant<Ts...>, std::void_t<FUN_t<T, unbox_t<Ts>...>>> {
+  static constexpr size_t value = FUN_t<T, unbox_t<Ts>...>::value;
+  using type = unbox_t<nth_type_t<value, Ts...>>;
+};
+
+template <typename T>
+inline constexpr bool is_in_place_tag = false;
+
+template <typename T>
+inline constexpr bool is_in_place_tag<in_place_type_t<T>> = true;
+
+template <size_t I>
+inline constexpr bool is_in_place_tag<in_place_index_t<I>> = true;
 } // namespace _variant_detail
 
+[[noreturn]] inline void throwBadVariantAccess(const char* reason);
+
 class BadVariantAccess : public std::exception {
 public:
   BadVariantAccess() noexcept {}
@@ -677,16 +831,286 @@ public:
 private:
   BadVariantAccess(const char* reason) noexcept : m_reason(reason) {}
 
+  friend void throwBadVariantAccess(const char* reason);
+
   const char* m_reason = "bad variant access";
 };
 
+inline void throwBadVariantAccess(const char* reason) { throw BadVariantAccess(reason); }
+
+template <typename T, typename... Ts>
+constexpr bool holds_alternative(const Variant<Ts...>& v) noexcept {
+  static_assert(count_type_v<T, unbox_t<Ts>...> == 1, "T must occur exactly once in alternatives");
+  return v.index() == index_of_v<T, unbox_t<Ts>...>;
+}
+
+template <size_t I, typename... Ts>
+constexpr variant_alternative_t<I, Variant<Ts...>>& get(Variant<Ts...>& v) {
+  static_assert(I < sizeof...(Ts), "The index must be in [0, number of alternatives)");
+  if (v.index() != I) throwBadVariantAccess("play::get: wrong index for variant");
+  return play::unboxed(_variant_detail::get<I>(v));
+}
+
+template <size_t I, typename... Ts>
+constexpr variant_alternative_t<I, Variant<Ts...>>&& get(Variant<Ts...>&& v) {
+  static_assert(I < sizeof...(Ts), "The index must be in [0, number of alternatives)");
+  if (v.index() != I) throwBadVariantAccess("play::get: wrong index for variant");
+  return play::unboxed(_variant_detail::get<I>(std::move(v)));
+}
+
+template <size_t I, typename... Ts>
+constexpr const variant_alternative_t<I, Variant<Ts...>>& get(const Variant<Ts...>& v) {
+  static_assert(I < sizeof...(Ts), "The index must be in [0, number of alternatives)");
+  if (v.index() != I) throwBadVariantAccess("play::get: wrong index for variant");
+  return play::unboxed(_variant_detail::get<I>(v));
+}
+
+template <size_t I, typename... Ts>
+constexpr const variant_alternative_t<I, Variant<Ts...>>&& get(const Variant<Ts...>&& v) {
+  static_assert(I < sizeof...(Ts), "The index must be in [0, number of alternatives)");
+  if (v.index() != I) throwBadVariantAccess("play::get: wrong index for variant");
+  return play::unboxed(_variant_detail::get<I>(std::move(v)));
+}
+
+template <typename T, typename... Ts>
+constexpr T& get(Variant<Ts...>& v) {
+  static_assert(count_type_v<T, unbox_t<Ts>...> == 1, "T must occur exactly once in alternatives");
+  return play::get<index_of_v<T, unbox_t<Ts>...>>(v);
+}
+
+template <typename T, typename... Ts>
+constexpr T&& get(Variant<Ts...>&& v) {
+  static_assert(count_type_v<T, unbox_t<Ts>...> == 1, "T must occur exactly once in alternatives");
+  return play::get<index_of_v<T, unbox_t<Ts>...>>(std::move(v));
+}
+
+template <typename T, typename... Ts>
+constexpr const T& get(const Variant<Ts...>& v) {
+  static_assert(count_type_v<T, unbox_t<Ts>...> == 1, "T must occur exactly once in alternatives");
+  return play::get<index_of_v<T, unbox_t<Ts>...>>(v);
+}
+
+template <typename T, typename... Ts>
+constexpr const T&& get(const Variant<Ts...>&& v) {
+  static_assert(count_type_v<T, unbox_t<Ts>...> == 1, "T must occur exactly once in alternatives");
+  return play::get<index_of_v<T, unbox_t<Ts>...>>(std::move(v));
+}
+
+template <size_t I, typename... Ts>
+constexpr std::add_pointer_t<variant_alternative_t<I, Variant<Ts...>>> get_if(Variant<Ts...>* v) noexcept {
+  static_assert(I < sizeof...(Ts), "The index must be in [0, number of alternatives)");
+  if (v && v->index() == I) return std::addressof(play::unboxed(_variant_detail::get<I>(*v)));
+  return nullptr;
+}
+
+template <size_t I, typename... Ts>
+constexpr std::add_pointer_t<const variant_alternative_t<I, Variant<Ts...>>> get_if(const Variant<Ts...>* v) noexcept {
+  static_assert(I < sizeof...(Ts), "The index must be in [0, number of alternatives)");
+  if (v && v->index() == I) return std::addressof(play::unboxed(_variant_detail::get<I>(*v)));
+  return nullptr;
+}
+
+template <typename T, typename... Ts>
+constexpr std::add_pointer_t<T> get_if(Variant<Ts...>* v) noexcept {
+  static_assert(count_type_v<T, unbox_t<Ts>...> == 1, "T must occur exactly once in alternatives");
+  return play::get_if<index_of_v<T, unbox_t<Ts>...>>(v);
+}
+
+template <typename T, typename... Ts>
+constexpr std::add_pointer_t<const T> get_if(const Variant<Ts...>* v) noexcept {
+  static_assert(count_type_v<T, unbox_t<Ts>...> == 1, "T must occur exactly once in alternatives");
+  return play::get_if<index_of_v<T, unbox_t<Ts>...>>(v);
+}
+
+template <typename Visitor, typename... Vs>
+constexpr decltype(auto) visit(Visitor&& visitor, Vs&&... vars) {
+  if ((vars.valueless_by_exception() || ...)) throwBadVariantAccess("play::visit: variant is valueless");
+  using Ret = std::invoke_result_t<Visitor, decltype(play::unboxed(_variant_detail::get<0>(std::declval<Vs>())))...>;
+  return _variant_detail::doVisit<_variant_detail::deduce_visit_result<Ret>>(std::forward<Visitor>(visitor),
+                                                                             std::forward<Vs>(vars)...);
+}
+
+template <typename Ret, typename Visitor, typename... Vs>
+constexpr Ret visit(Visitor&& visitor, Vs&&... vars) {
+  if ((vars.valueless_by_exception() || ...)) throwBadVariantAccess("play::visit: variant is valueless");
+  return _variant_detail::doVisit<Ret>(std::forward<Visitor>(visitor), std::forward<Vs>(vars)...);
+}
+
+// A Boxed<T> alternative is seen as T, except after being moved from: moving the variant hands over the box pointer
+// (noexcept, no allocation, so containers of variants move rather than copy on growth), and the moved-from variant
+// keeps the boxed alternative's index with an empty box. Like a moved-from Boxed it may only be assigned to or
+// destroyed; reading it through get/get_if/visit/match/print is undefined and asserts in debug builds.
 template <typename... Ts>
 class Variant
-    : private EnableCopyMove<_variant_detail::traits<Ts...>::s_copy_ctor, _variant_detail::traits<Ts...>::s_copy_assign,
+    : private _variant_detail::VariantBase<Ts...>,
+      private EnableCopyMove<_variant_detail::traits<Ts...>::s_copy_ctor, _variant_detail::traits<Ts...>::s_copy_assign,
                              _variant_detail::traits<Ts...>::s_move_ctor, _variant_detail::traits<Ts...>::s_move_assign,
                              Variant<Ts...>> {
 private:
+  static_assert(sizeof...(Ts) > 0, "Variant must have at least one alternative");
+  static_assert(!(std::is_reference_v<Ts> || ...), "Variant must have no reference alternative");
+  static_assert(!(std::is_void_v<Ts> || ...), "Variant must have no void alternative");
+
+  using BaseT = _variant_detail::VariantBase<Ts...>;
+
+  template <typename T>
+  static constexpr bool s_not_self = !std::is_same_v<remove_cvref_t<T>, Variant>;
+
+  template <typename T>
+  static constexpr size_t s_accepted_index = _variant_detail::accepted_alt<T, Variant>::value;
+
+  template <typename T, typename = std::enable_if_t<s_not_self<T>>>
+  using accepted_type = typename _variant_detail::accepted_alt<T, Variant>::type;
+
+  // What is actually stored for the accepted alternative, differs from accepted_type only for Boxed<T>
+  template <typename T>
+  using accepted_storage = nth_type_t<s_accepted_index<T>, Ts...>;
+
+  template <typename T>
+  static constexpr bool s_exactly_once = count_type_v<T, unbox_t<Ts>...> == 1;
+
   template <size_t I, typename V>
   friend constexpr decltype(auto) _variant_detail::get(V&& var) noexcept;
+
+  template <typename... Us, typename T>
+  friend constexpr decltype(auto) _variant_detail::variant_cast(T&& rhs);
+
+public:
+  template <typename T0 = nth_type_t<0, Ts...>, typename = std::enable_if_t<std::is_default_constructible_v<T0>>>
+  constexpr Variant() noexcept(std::is_nothrow_default_constructible_v<T0>) {}
+
+  Variant(const Variant&) = default;
+  Variant(Variant&&) = default;
+  Variant& operator=(const Variant&) = default;
+  Variant& operator=(Variant&&) = default;
+  ~Variant() = default;
+
+  template <typename T, typename = std::enable_if_t<s_not_self<T> && !_variant_detail::is_in_place_tag<remove_cvref_t<T>>>,
+            typename Tj = accepted_type<T&&>,
+            typename = std::enable_if_t<s_exactly_once<Tj> && std::is_constructible_v<Tj, T>>>
+  constexpr Variant(T&& t) noexcept(std::is_nothrow_constructible_v<accepted_storage<T&&>, T>)
+      : BaseT(in_place_index<s_accepted_index<T>>, std::forward<T>(t)) {}
+
+  template <typename T, typename... Args,
+            typename = std::enable_if_t<s_exactly_once<T> && std::is_constructible_v<T, Args...>>>
+  constexpr explicit Variant(in_place_type_t<T>, Args&&... args)
+      : BaseT(in_place_index<index_of_v<T, unbox_t<Ts>...>>, std::forward<Args>(args)...) {}
+
+  template <size_t I, typename... Args, typename = std::enable_if_t<(I < sizeof...(Ts))>,
+            typename = std::enable_if_t<std::is_constructible_v<nth_type_t<I, Ts...>, Args...>>>
+  constexpr explicit Variant(in_place_index_t<I>, Args&&... args) : BaseT(in_place_index<I>, std::forward<Args>(args)...) {}
+
+  template <typename T>
+  constexpr std::enable_if_t<s_exactly_once<accepted_type<T&&>> && std::is_constructible_v<accepted_type<T&&>, T> &&
+                       std::is_assignable_v<accepted_type<T&&>&, T>,
+                   Variant&>
+  operator=(T&& rhs) noexcept(std::is_nothrow_assignable_v<accepted_type<T&&>&, T> &&
+                              std::is_nothrow_constructible_v<accepted_storage<T&&>, T>) {
+    constexpr size_t I = s_accepted_index<T>;
+    if (index() == I) {
+      _variant_detail::get<I>(*this) = std::forward<T>(rhs);
+    } else {
+      using Tj = accepted_storage<T&&>;
+      if constexpr (std::is_nothrow_constructible_v<Tj, T> || !std::is_nothrow_move_constructible_v<Tj>) {
+        this->template emplace<I>(std::forward<T>(rhs));
+      } else {
+        operator=(Variant(std::forward<T>(rhs)));
+      }
+    }
+    return *this;
+  }
+
+  template <typename T, typename... Args>
+  constexpr std::enable_if_t<std::is_constructible_v<T, Args...> && s_exactly_once<T>, T&> emplace(Args&&... args) {
+    constexpr size_t I = index_of_v<T, unbox_t<Ts>...>;
+    return this->template emplace<I>(std::forward<Args>(args)...);
+  }
+
+  template <size_t I, typename... Args>
+  constexpr std::enable_if_t<std::is_constructible_v<nth_type_t<I, Ts...>, Args...>, variant_alternative_t<I, Variant>&>
+  emplace(Args&&... args) {
+    // The stored type decides the exception safety strategy: constructing a Boxed<T> may throw, moving it never does
+    using Ti = nth_type_t<I, Ts...>;
+    if constexpr (std::is_nothrow_constructible_v<Ti, Args...>) {
+      _variant_detail::emplace<I>(*this, std::forward<Args>(args)...);
+    } else if constexpr (std::is_scalar_v<Ti>) {
+      // Constructing the scalar first keeps the current value if it throws
+      const Ti tmp(std::forward<Args>(args)...);
+      _variant_detail::emplace<I>(*this, tmp);
+    } else if constexpr (is_boxed_v<Ti>) {
+      // Boxing into a temporary first keeps the current value if it throws, handing over the box never throws
+      Ti tmp(std::forward<Args>(args)...);
+      _variant_detail::emplace<I>(*this, std::move(tmp));
+    } else if constexpr (_variant_detail::never_valueless_alt<Ti>::value &&
+                         _variant_detail::never_valueless<Ts...>::value) {
+      // valid() is assumed to be always true, so the variant must not become valueless on exception
+      Variant tmp(in_place_index<I>, std::forward<Args>(args)...);
+      *this = std::move(tmp);
+    } else if constexpr (enable_double_buffered_variant<Ts...>) {
+      // Constructed into the spare buffer, the current value is kept if it throws
+      _variant_detail::emplace<I>(*this, std::forward<Args>(args)...);
+    } else if constexpr (_variant_detail::traits<Ts...>::s_nothrow_move_ctor) {
+      // Constructing a temporary first keeps the current value if it throws, moving it in never throws
+      Ti tmp(std::forward<Args>(args)...);
+      _variant_detail::emplace<I>(*this, std::move(tmp));
+    } else {
+      // May become valueless if the constructor throws
+      _variant_detail::emplace<I>(*this, std::forward<Args>(args)...);
+    }
+    return play::unboxed(_variant_detail::get<I>(*this));
+  }
+
+  constexpr bool valueless_by_exception() const noexcept { return !this->valid(); }
+
+  constexpr size_t index() const noexcept { return this->valid() ? size_t(this->m_index) : variant_npos; }
+
+  constexpr void swap(Variant& rhs) noexcept((std::is_nothrow_move_constructible_v<Ts> && ...) &&
+                                   (std::is_nothrow_swappable_v<Ts> && ...)) {
+    if (index() == rhs.index()) {
+      _variant_detail::rawIdxVisit(
+          [&rhs](auto&& lhs_value, auto lhs_index) mutable {
+            constexpr size_t I = lhs_index;
+            if constexpr (I != variant_npos) {
+              using std::swap;
+              swap(lhs_value, _variant_detail::get<I>(rhs));
+            }
+          },
+          *this);
+    } else {
+      Variant tmp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(tmp);
+    }
+  }
 };
+
+template <typename... Ts>
+constexpr void swap(Variant<Ts...>& lhs, Variant<Ts...>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+  lhs.swap(rhs);
+}
+
+// Both storages keep the active alternative by index rather than by address, so a Variant can be moved bytewise
+// whenever every alternative can.
+template <typename... Ts>
+struct is_trivially_relocatable<Variant<Ts...>> : std::conjunction<is_trivially_relocatable<Ts>...> {};
+
+template <typename... Ts>
+constexpr bool operator==(const Variant<Ts...>& lhs, const Variant<Ts...>& rhs) {
+  if (lhs.index() != rhs.index()) return false;
+  bool res = true;
+  _variant_detail::rawIdxVisit(
+      [&res, &rhs](auto&& lhs_value, auto lhs_index) {
+        constexpr size_t I = lhs_index;
+        if constexpr (I != variant_npos) {
+          res = lhs_value == _variant_detail::get<I>(rhs);
+        }
+      },
+      lhs);
+  return res;
+}
+
+template <typename... Ts>
+constexpr bool operator!=(const Variant<Ts...>& lhs, const Variant<Ts...>& rhs) {
+  return !(lhs == rhs);
+}
 } // namespace play
@@ -1,11 +1,99 @@
+#include "match.hpp"
 #include "variant.hpp"
 
+#include <array>
 #include <iostream>
-#include <variant>
+#include <string>
 
-int main(int argc, char const* argv[]) {
-  std::variant<int> t = 1;
-  /* code */
-  std::cout << "variant_demo";
+namespace {
+// 非平凡析构的字面类型
+struct Counter {
+  constexpr Counter(int v) : value(v) {}
+  constexpr Counter(const Counter& rhs) : value(rhs.value + 1) {}
+  constexpr Counter& operator=(const Counter& rhs) {
+    value = rhs.value + 10;
+    return *this;
+  }
+  constexpr ~Counter() {}
+
+  int value;
+};
+
+using ConstVar = play::Variant<int, Counter, double>;
+
+constexpr int valueOf(const ConstVar& v) {
+  return play::visit(
+      [](const auto& x) -> int {
+        if constexpr (std::is_same_v<play::remove_cvref_t<decltype(x)>, Counter>) {
+          return x.value;
+        } else {
+          return static_cast<int>(x);
+        }
+      },
+      v);
+}
+
+// 构造、拷贝构造、拷贝赋值（同类型/跨类型）
+static_assert(valueOf(ConstVar(3)) == 3);
+static_assert(valueOf(ConstVar(play::in_place_type<Counter>, 4)) == 4);
+static_assert([] {
+  ConstVar a(play::in_place_index<1>, 1);
+  ConstVar b = a;
+  ConstVar c = 2.5;
+  c = b;
+  return valueOf(b) * 100 + valueOf(c);
+}() == 203);
+
+// emplace 与跨类型转换赋值
+static_assert([] {
+  ConstVar v = 1;
+  v.emplace<Counter>(5);
+  int first = valueOf(v);
+  v = 7;
+  v.emplace<2>(1.5);
+  return first * 100 + static_cast<int>(v.index());
+}() == 502);
+
+// 超过 switch 上限（11）的单变体访问以及双变体访问都走跳转表；41 个备选类型的存储有两层联合体
+template <size_t I>
+struct Tag {
+  static constexpr size_t value = I;
+};
+
+template <size_t... Is>
+constexpr auto makeTags(std::index_sequence<Is...>) -> play::Variant<Tag<Is>..., Counter>;
+
+using BigVar = decltype(makeTags(std::make_index_sequence<40>()));
+
+static_assert([] {
+  BigVar a(play::in_place_index<37>);
+  BigVar b(play::in_place_type<Counter>, 42);
+  size_t res = play::visit([](const auto& x, const auto& y) -> size_t {
+    if constexpr (std::is_same_v<play::remove_cvref_t<decltype(y)>, Counter>) {
+      return x.value * 1000 + y.value;
+    } else {
+      return 0;
+    }
+  }, a, b);
+  a = b;
+  return res + a.index();
+}() == 37042 + 40);
+} // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char const* argv[]) {
+  play::Variant<int, double, std::string> var = 114;
+  play::visit([](auto const& v) { std::cout << v << "\n"; }, var);
+  var = std::string("114514");
+  play::visit([](auto const& v) { std::cout << v << "\n"; }, var);
+  var.emplace<double>(114.514);
+  std::cout << var.index() << " " << play::get<double>(var) << "\n";
+  // 各分支返回 int/double，结果为公共类型 double
+  auto res = play::match(
+      var, [](int i) { return i; }, [](double d) { return d * 2; },
+      [](std::string const& s) { return static_cast<int>(s.size()); });
+  std::cout << res << "\n";
+  // 罕见的大备选类型装箱后只占一个指针，get/visit 得到的仍是数组本身
+  play::Variant<int, play::Boxed<std::array<char, 512>>> boxed(play::in_place_type<std::array<char, 512>>);
+  std::cout << sizeof(boxed) << " " << play::get<1>(boxed).size() << "\n";
   return 0;
 }
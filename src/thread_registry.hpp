@@ -0,0 +1,86 @@
+#pragma once
+
+// 每线程数据的登记表：线程首次使用时独占一个 T，退出后归还并由之后的新线程复用（T 中已有的数据保留）；
+// 登记表只增不删，任何线程（包括信号处理中）都可以无锁遍历全部 T
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace play {
+/// @brief 每线程数据的登记表，供 FlightRecorder、Timers、Tracer 等保存各线程的缓冲区
+/// T 能以 T(uint32_t id) 构造时传入登记序号（从 0 起，复用时不变），否则默认构造
+/// 线程退出时仍会访问登记表，节点也从不释放，因此所有者须是不析构的单例（new 出后不 delete），
+/// 这样其它静态对象析构时也能继续使用；线程句柄按 T 区分，每个 T 只能有一个登记表
+template <class T>
+class ThreadRegistry {
+public:
+  ThreadRegistry() = default;
+  ThreadRegistry(const ThreadRegistry&) = delete;
+  ThreadRegistry& operator=(const ThreadRegistry&) = delete;
+
+  /// @brief 本线程的 T，首次调用时复用一个已归还的 T 或新建一个
+  T& local() { return local([](T&) {}); }
+
+  /// @brief 同上，复用已归还的 T 时先对其调用 onReuse(T&)
+  template <class F>
+  T& local(F&& onReuse) {
+    Handle& handle = threadHandle();
+    if (!handle.node) handle.node = acquire(onReuse);
+    return handle.node->value;
+  }
+
+  /// @brief 按登记的逆序对每个 T（包括已归还的）调用 f(T&)，可与 local 并发
+  template <class F>
+  void forEach(F&& f) {
+    for (Node* node = m_head.load(std::memory_order_acquire); node; node = node->next) f(node->value);
+  }
+
+private:
+  struct Node {
+    explicit Node(uint32_t id)
+      requires std::is_constructible_v<T, uint32_t>
+        : value(id) {}
+
+    explicit Node(uint32_t)
+      requires(!std::is_constructible_v<T, uint32_t>)
+    {}
+
+    T value;
+    std::atomic<bool> owned{true};
+    Node* next = nullptr;
+  };
+
+  // 线程退出时归还
+  struct Handle {
+    Node* node = nullptr;
+
+    ~Handle() {
+      if (node) node->owned.store(false, std::memory_order_release);
+    }
+  };
+
+  static Handle& threadHandle() {
+    thread_local Handle t_handle;
+    return t_handle;
+  }
+
+  template <class F>
+  Node* acquire(F& onReuse) {
+    for (Node* node = m_head.load(std::memory_order_acquire); node; node = node->next) {
+      bool owned = false;
+      if (node->owned.compare_exchange_strong(owned, true, std::memory_order_acquire)) {
+        onReuse(node->value);
+        return node;
+      }
+    }
+    auto* node = new Node(m_count.fetch_add(1, std::memory_order_relaxed));
+    node->next = m_head.load(std::memory_order_relaxed);
+    while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release)) {
+    }
+    return node;
+  }
+
+  std::atomic<Node*> m_head{nullptr};
+  std::atomic<uint32_t> m_count{0};
+};
+} // namespace play
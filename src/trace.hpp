@@ -0,0 +1,242 @@
+#pragma once
+
+// 时间线追踪：记录区间（begin/end 与完整区间）的名字、位置与 steady_clock 时间戳，写出为 Chrome 的 traceEvents JSON，
+// 可直接用 Perfetto（ui.perfetto.dev）或 chrome://tracing 打开。关闭时每处只有一次 relaxed 原子读取；
+// 开启后事件写入每线程预先分配的单生产者环形缓冲区（线程首次记录时分配），缓冲区满时丢弃新事件并计数，不再分配
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <source_location>
+#include <string>
+#include <string_view>
+
+#include <unistd.h>
+
+#include "preprocessor.hpp"
+#include "thread_registry.hpp"
+
+namespace play {
+namespace _trace_detail {
+inline std::atomic<bool> g_enabled{false};
+
+inline constexpr size_t k_events = size_t(1) << 15;
+
+inline int64_t now() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// name 与 file 均指向静态存储；phase 为 Chrome 的事件类型：B/E 开始与结束，X 完整区间，i 瞬时事件
+struct Event {
+  const char* name;
+  const char* file;
+  int64_t ts;
+  int64_t dur;
+  uint32_t line;
+  char phase;
+};
+
+// 所属线程写入、写出时由 Tracer 读取的单生产者单消费者环形队列，由 ThreadRegistry 分给各线程
+struct Buffer {
+  explicit Buffer(uint32_t tid) : tid(tid), events(new Event[k_events]) {}
+
+  bool push(const Event& e) noexcept {
+    uint64_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == k_events) {
+      dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    events[h % k_events] = e;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  std::atomic<uint64_t> head{0};
+  std::atomic<uint64_t> tail{0};
+  std::atomic<uint64_t> dropped{0};
+  uint32_t tid;
+  std::string threadName; // 由 Tracer 的锁保护
+  std::unique_ptr<Event[]> events;
+};
+
+inline void appendEscaped(std::string& out, std::string_view s) {
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      out.append(buf);
+    } else {
+      out.push_back(c);
+    }
+  }
+}
+} // namespace _trace_detail
+
+class Tracer {
+public:
+  static Tracer& instance() {
+    static Tracer* const s_tracer = new Tracer;
+    return *s_tracer;
+  }
+
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+  static bool enabled() noexcept { return _trace_detail::g_enabled.load(std::memory_order_relaxed); }
+
+  static void enable(bool on = true) noexcept { _trace_detail::g_enabled.store(on, std::memory_order_relaxed); }
+
+  void begin(const char* name, const std::source_location& loc) { push(name, loc, _trace_detail::now(), 0, 'B'); }
+
+  void end(const char* name, const std::source_location& loc) { push(name, loc, _trace_detail::now(), 0, 'E'); }
+
+  void instant(const char* name, const std::source_location& loc) { push(name, loc, _trace_detail::now(), 0, 'i'); }
+
+  void complete(const char* name, const std::source_location& loc, int64_t start, int64_t end) {
+    push(name, loc, start, end - start, 'X');
+  }
+
+  /// @brief 为当前线程命名，写出时作为 thread_name 元数据
+  void setThreadName(std::string_view name) {
+    auto& buffer = local();
+    std::lock_guard lock(m_mutex);
+    buffer.threadName = name;
+  }
+
+  /// @brief 取出所有线程中尚未写出的事件，以完整的 traceEvents JSON 文档写入 os
+  void write(std::ostream& os) {
+    std::lock_guard lock(m_mutex);
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&] {
+      if (!first) out.append(",\n");
+      first = false;
+    };
+    char buf[96];
+    int pid = static_cast<int>(getpid());
+    m_buffers.forEach([&](_trace_detail::Buffer& b) {
+      if (!b.threadName.empty()) {
+        separator();
+        snprintf(buf, sizeof(buf), "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"",
+                 pid, b.tid);
+        out.append(buf);
+        _trace_detail::appendEscaped(out, b.threadName);
+        out.append("\"}}");
+      }
+      if (auto dropped = b.dropped.exchange(0, std::memory_order_relaxed)) {
+        separator();
+        snprintf(buf, sizeof(buf), "{\"ph\":\"C\",\"name\":\"dropped\",\"pid\":%d,\"tid\":%u,\"ts\":0,", pid, b.tid);
+        out.append(buf).append("\"args\":{\"events\":").append(std::to_string(dropped)).append("}}");
+      }
+      uint64_t h = b.head.load(std::memory_order_acquire);
+      for (uint64_t i = b.tail.load(std::memory_order_relaxed); i < h; ++i) {
+        auto const& e = b.events[i % _trace_detail::k_events];
+        separator();
+        out.append("{\"name\":\"");
+        _trace_detail::appendEscaped(out, e.name);
+        // 时间以微秒为单位，保留到纳秒
+        snprintf(buf, sizeof(buf), "\",\"cat\":\"play\",\"ph\":\"%c\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f", e.phase, pid,
+                 b.tid, static_cast<double>(e.ts) / 1e3);
+        out.append(buf);
+        if (e.phase == 'X') {
+          snprintf(buf, sizeof(buf), ",\"dur\":%.3f", static_cast<double>(e.dur) / 1e3);
+          out.append(buf);
+        }
+        if (e.phase == 'i') out.append(",\"s\":\"t\"");
+        out.append(",\"args\":{\"file\":\"");
+        _trace_detail::appendEscaped(out, e.file);
+        out.append("\",\"line\":").append(std::to_string(e.line)).append("}}");
+        if (out.size() >= s_flush_size) {
+          os << out;
+          out.clear();
+        }
+      }
+      b.tail.store(h, std::memory_order_release);
+    });
+    out.append("\n]}\n");
+    os << out;
+  }
+
+  /// @brief 写入 path（覆盖），失败时返回 false
+  bool write(const std::string& path) {
+    std::ofstream ofs(path, std::ios::trunc);
+    write(ofs);
+    return static_cast<bool>(ofs);
+  }
+
+  /// @brief 丢弃所有尚未写出的事件
+  void clear() {
+    std::lock_guard lock(m_mutex);
+    m_buffers.forEach([](_trace_detail::Buffer& b) {
+      b.tail.store(b.head.load(std::memory_order_acquire), std::memory_order_release);
+      b.dropped.store(0, std::memory_order_relaxed);
+    });
+  }
+
+private:
+  Tracer() = default;
+
+  void push(const char* name, const std::source_location& loc, int64_t ts, int64_t dur, char phase) {
+    local().push({name, loc.file_name(), ts, dur, loc.line(), phase});
+  }
+
+  // 复用已退出线程的缓冲区时清除其线程名
+  _trace_detail::Buffer& local() {
+    return m_buffers.local([this](_trace_detail::Buffer& b) {
+      std::lock_guard lock(m_mutex);
+      b.threadName.clear();
+    });
+  }
+
+  static constexpr size_t s_flush_size = 1 << 16;
+
+  std::mutex m_mutex;
+  ThreadRegistry<_trace_detail::Buffer> m_buffers;
+};
+
+/// @brief 作用域对应一个完整区间（X 事件）；构造时未开启追踪则整个作用域都不记录
+class TraceScope {
+public:
+  TraceScope(const char* name, const std::source_location& loc) noexcept
+      : m_name(name), m_loc(loc), m_start(Tracer::enabled() ? _trace_detail::now() : -1) {}
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+  ~TraceScope() {
+    if (m_start >= 0) Tracer::instance().complete(m_name, m_loc, m_start, _trace_detail::now());
+  }
+
+private:
+  const char* m_name;
+  std::source_location m_loc;
+  int64_t m_start;
+};
+
+// 以下宏的 name 须为静态存储的字符串（如字面量），位置取自宏展开处
+// 当前作用域记为一个完整区间
+#define PLAY_TRACE_SCOPE(name) \
+  const ::play::TraceScope PLAY_CONCAT(_play_trace_scope_, __COUNTER__)(name, std::source_location::current())
+// 成对使用的开始与结束，可跨越作用域（须在同一线程）
+#define PLAY_TRACE_BEGIN(name)                                                                              \
+  do {                                                                                                      \
+    if (::play::Tracer::enabled()) ::play::Tracer::instance().begin(name, std::source_location::current()); \
+  } while (0)
+#define PLAY_TRACE_END(name)                                                                              \
+  do {                                                                                                    \
+    if (::play::Tracer::enabled()) ::play::Tracer::instance().end(name, std::source_location::current()); \
+  } while (0)
+// 瞬时事件
+#define PLAY_TRACE_INSTANT(name)                                                                              \
+  do {                                                                                                        \
+    if (::play::Tracer::enabled()) ::play::Tracer::instance().instant(name, std::source_location::current()); \
+  } while (0)
+} // namespace play
@@ -0,0 +1,137 @@
+#pragma once
+
+// 为每个类型分配稠密、稳定的 uint32_t 编号，按类型分派时以数组下标代替字符串或 type_info 的比较
+// 编号在首次调用 typeId<T>() 时分配（PLAY_REGISTER_TYPE 可提前到静态初始化阶段），从 0 开始连续递增；
+// 同一程序中按编号取名字、大小与对齐都是数组访问，名字到编号的散列表供反序列化使用
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+
+#include "demangle.hpp"
+#include "preprocessor.hpp"
+
+namespace play {
+/// @brief 注册表中一个类型的描述
+struct TypeInfo {
+  uint32_t id;
+  std::string_view name;
+  size_t size;
+  size_t alignment;
+  const std::type_info* info;
+};
+
+/// @brief 进程内唯一的类型注册表：注册时加锁，按编号查询不加锁且描述的地址不会改变
+class TypeRegistry {
+public:
+  static TypeRegistry& instance() {
+    // 不析构，其它静态对象析构时仍可查询
+    static TypeRegistry* const s_registry = new TypeRegistry;
+    return *s_registry;
+  }
+
+  TypeRegistry(const TypeRegistry&) = delete;
+  TypeRegistry& operator=(const TypeRegistry&) = delete;
+
+  /// @brief 登记 T（已登记时返回原编号），一般通过 typeId<T>() 间接调用
+  template <class T>
+  uint32_t add() {
+    static_assert(std::is_object_v<T> && !std::is_const_v<T> && !std::is_volatile_v<T>,
+                  "only cv-unqualified object types can be registered");
+    return add(typeName<T>(), sizeof(T), alignof(T), typeid(T));
+  }
+
+  uint32_t add(std::string_view name, size_t size, size_t alignment, const std::type_info& info) {
+    std::unique_lock lock(m_mutex);
+    if (auto it = m_byInfo.find(info); it != m_byInfo.end()) return it->second;
+    uint32_t id = m_count.load(std::memory_order_relaxed);
+    auto [chunk, offset] = locate(id);
+    if (!m_chunks[chunk]) m_chunks[chunk] = std::make_unique<TypeInfo[]>(chunkSize(chunk));
+    m_chunks[chunk][offset] = {id, name, size, alignment, &info};
+    m_byName.emplace(name, id);
+    m_byInfo.emplace(info, id);
+    m_count.store(id + 1, std::memory_order_release);
+    return id;
+  }
+
+  /// @brief 编号对应的描述，id 必须来自本注册表
+  const TypeInfo& info(uint32_t id) const noexcept {
+    auto [chunk, offset] = locate(id);
+    return m_chunks[chunk][offset];
+  }
+
+  std::string_view name(uint32_t id) const noexcept { return info(id).name; }
+
+  size_t size(uint32_t id) const noexcept { return info(id).size; }
+
+  size_t alignment(uint32_t id) const noexcept { return info(id).alignment; }
+
+  /// @brief 按 typeName 给出的名字查找编号，用于反序列化
+  std::optional<uint32_t> find(std::string_view name) const {
+    std::shared_lock lock(m_mutex);
+    if (auto it = m_byName.find(name); it != m_byName.end()) return it->second;
+    return std::nullopt;
+  }
+
+  /// @brief 按运行时类型查找编号，用于 typeid 得到的动态类型
+  std::optional<uint32_t> find(const std::type_info& info) const {
+    std::shared_lock lock(m_mutex);
+    if (auto it = m_byInfo.find(info); it != m_byInfo.end()) return it->second;
+    return std::nullopt;
+  }
+
+  /// @brief 已登记的类型数，编号为 [0, count())
+  uint32_t count() const noexcept { return m_count.load(std::memory_order_acquire); }
+
+private:
+  // 描述按块存放，第 k 块容纳 2^(k + 6) 项，扩容时已有的描述不移动，读者无需加锁
+  static constexpr size_t s_first_chunk_bits = 6;
+  static constexpr size_t s_chunks = 32 - s_first_chunk_bits;
+
+  TypeRegistry() = default;
+
+  static constexpr size_t chunkSize(size_t chunk) { return size_t(1) << (chunk + s_first_chunk_bits); }
+
+  static std::pair<size_t, size_t> locate(uint32_t id) noexcept {
+    uint64_t i = uint64_t(id) + chunkSize(0);
+    size_t chunk = std::bit_width(i) - 1 - s_first_chunk_bits;
+    return {chunk, i - chunkSize(chunk)};
+  }
+
+  mutable std::shared_mutex m_mutex;
+  std::atomic<uint32_t> m_count{0};
+  std::array<std::unique_ptr<TypeInfo[]>, s_chunks> m_chunks;
+  std::unordered_map<std::string_view, uint32_t> m_byName;
+  std::unordered_map<std::type_index, uint32_t> m_byInfo;
+};
+
+/// @brief T 的稠密编号（忽略 cv 与引用修饰），首次调用时登记
+template <class T>
+uint32_t typeId() {
+  using U = std::remove_cvref_t<T>;
+  if constexpr (!std::is_same_v<U, T>) {
+    return typeId<U>();
+  } else {
+    static const uint32_t s_id = TypeRegistry::instance().add<T>();
+    return s_id;
+  }
+}
+
+/// @brief 编号对应的类型描述
+inline const TypeInfo& typeInfo(uint32_t id) noexcept { return TypeRegistry::instance().info(id); }
+
+// 在静态初始化阶段登记类型，使按名字查找（反序列化）在首次使用该类型之前也能成功
+#define PLAY_REGISTER_TYPE(...)                                                      \
+  [[maybe_unused]] static const uint32_t PLAY_CONCAT(_play_type_id_, __COUNTER__) = \
+      ::play::typeId<__VA_ARGS__>()
+} // namespace play
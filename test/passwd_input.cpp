@@ -0,0 +1,88 @@
+// UnixPasswdInput::requestSecret 在一行的中途超时后的行为：后半行不能被当作完整的一行返回
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+#include "passwd_input.hpp"
+
+namespace {
+using Status = play::UnixPasswdInput::Status;
+using namespace std::chrono_literals;
+
+int s_failures = 0;
+
+void check(bool ok, const char* what) {
+  if (!ok) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    ++s_failures;
+  }
+}
+
+class Pipe {
+public:
+  Pipe() {
+    int fds[2];
+    if (pipe(fds) == 0) {
+      m_read = fds[0];
+      m_write = fds[1];
+    }
+  }
+
+  ~Pipe() {
+    close(m_read);
+    close(m_write);
+  }
+
+  void send(std::string_view data) const {
+    check(write(m_write, data.data(), data.size()) == static_cast<ssize_t>(data.size()), "write");
+  }
+
+  int fd() const { return m_read; }
+
+private:
+  int m_read = -1;
+  int m_write = -1;
+};
+
+void midLineTimeout() {
+  Pipe pipe;
+  play::UnixPasswdInput input(play::UnixPasswdInput::ReadMode::Batched, pipe.fd(), -1);
+  play::SecretString out(64);
+  pipe.send("hunter");
+  check(input.requestSecret("", 20ms, out) == Status::Timeout && out.size() == 0, "timeout mid-line");
+  pipe.send("2\nnext\n");
+  check(input.requestSecret("", 20ms, out) == Status::Error && out.size() == 0, "rest of the line is rejected");
+  check(input.requestSecret("", 20ms, out) == Status::Line && out.view() == "next", "following line is intact");
+}
+
+void timeoutWhileSkipping() {
+  Pipe pipe;
+  play::UnixPasswdInput input(play::UnixPasswdInput::ReadMode::Batched, pipe.fd(), -1);
+  play::SecretString out(64);
+  pipe.send("hun");
+  check(input.requestSecret("", 20ms, out) == Status::Timeout, "timeout mid-line");
+  pipe.send("ter");
+  check(input.requestSecret("", 20ms, out) == Status::Timeout && out.size() == 0, "timeout while skipping");
+  pipe.send("2\nok\n");
+  check(input.requestSecret("", 20ms, out) == Status::Error && out.size() == 0, "rest of the line is rejected");
+  check(input.requestSecret("", 20ms, out) == Status::Line && out.view() == "ok", "following line is intact");
+}
+
+void timeoutBetweenLines() {
+  Pipe pipe;
+  play::UnixPasswdInput input(play::UnixPasswdInput::ReadMode::Batched, pipe.fd(), -1);
+  play::SecretString out(64);
+  check(input.requestSecret("", 20ms, out) == Status::Timeout, "timeout before any input");
+  pipe.send("hunter2\n");
+  check(input.requestSecret("", 20ms, out) == Status::Line && out.view() == "hunter2", "line after an idle timeout");
+}
+} // namespace
+
+int main() {
+  midLineTimeout();
+  timeoutWhileSkipping();
+  timeoutBetweenLines();
+  return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+// play::formatTo 的输出须与 play::toString 逐字相同；std::formatter 只是把 formatTo 接到格式化上下文的迭代器上
+// 没有 <format> 的标准库（如 GCC 12）上 print_format.hpp 的 std::formatter 部分不会编译，相应的检查也随之跳过
+#include <cstdio>
+#include <iterator>
+#include <list>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "print_format.hpp"
+
+namespace {
+int s_failures = 0;
+
+void check(bool ok, const char* what) {
+  if (!ok) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    ++s_failures;
+  }
+}
+
+struct Point {
+  int x;
+  int y;
+
+  std::string toString() const {
+    std::string res = "(";
+    res.append(std::to_string(x)).append(", ").append(std::to_string(y)).push_back(')');
+    return res;
+  }
+};
+
+template <class T>
+void checkSame(T const& value, const char* what) {
+  std::string out;
+  play::formatTo(std::back_inserter(out), value);
+  if (out != play::toString(value)) {
+    std::fprintf(stderr, "  formatTo: %s\n  toString: %s\n", out.c_str(), play::toString(value).c_str());
+  }
+  check(out == play::toString(value), what);
+}
+
+void formatToMatchesToString() {
+  checkSame(42, "int");
+  checkSame(-7LL, "long long");
+  checkSame(3.14159265, "double");
+  checkSame(1e-7, "small double");
+  checkSame(1.5e20f, "large float");
+  checkSame(true, "bool");
+  checkSame('c', "char");
+  checkSame(std::string("a\"b"), "string with a quote");
+  checkSame(std::string_view("view"), "string_view");
+  checkSame(std::vector<int>{1, 2, 3}, "vector");
+  checkSame(std::vector<int>{}, "empty vector");
+  checkSame(std::list<std::string>{"x", "y"}, "list of strings");
+  checkSame(std::map<std::string, std::vector<double>>{{"a", {0.5, 1.25}}, {"b", {}}}, "map of vectors");
+  checkSame(std::tuple<int, std::string, char>{1, "two", '3'}, "tuple");
+  checkSame(std::pair<int, double>{1, 2.5}, "pair");
+  checkSame(std::optional<int>{5}, "engaged optional");
+  checkSame(std::optional<int>{}, "empty optional");
+  checkSame(std::variant<int, std::string>{"s"}, "variant");
+  checkSame(Point{1, 2}, "type with toString");
+  checkSame(std::vector<Point>{{1, 2}, {3, 4}}, "vector of types with toString");
+}
+
+#if defined(__cpp_lib_format)
+void stdFormat() {
+  std::vector<int> vec{1, 2, 3};
+  check(std::format("{}", play::printable(vec)) == play::toString(vec), "std::format of printable");
+  char buffer[4];
+  auto res = std::format_to_n(buffer, sizeof(buffer), "{}", play::printable(vec));
+  check(res.size == static_cast<std::ptrdiff_t>(play::toString(vec).size()), "format_to_n reports the full size");
+  check(std::string_view(buffer, sizeof(buffer)) == "[1, ", "format_to_n truncates");
+  check(std::format("{:>8}", Point{1, 2}) == "  (1, 2)", "width spec on a type with toString");
+}
+#endif
+} // namespace
+
+int main() {
+  formatToMatchesToString();
+#if defined(__cpp_lib_format)
+  stdFormat();
+#else
+  std::fprintf(stderr, "note: no <format> in this standard library, std::formatter checks not compiled\n");
+#endif
+  return s_failures == 0 ? 0 : 1;
+}